@@ -0,0 +1,145 @@
+#include "bench_harness.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+// ---------------------------------------------------------------------------
+// 分配计数：替换全局 operator new，统计基准循环内的堆分配次数
+// ---------------------------------------------------------------------------
+
+static std::atomic<uint64_t> g_allocCount{0};
+
+void *operator new(size_t size) {
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    void *p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+    std::free(p);
+}
+
+uint64_t AllocationCount() {
+    return g_allocCount.load(std::memory_order_relaxed);
+}
+
+static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// ---------------------------------------------------------------------------
+// BenchState
+// ---------------------------------------------------------------------------
+
+bool BenchState::KeepRunning() {
+    if (!started_) {
+        started_ = true;
+        Start();
+    }
+    if (remaining_-- > 0) return true;
+    Stop();
+    return false;
+}
+
+void BenchState::Start() {
+    running_ = true;
+    startAllocs_ = AllocationCount();
+    startNs_ = NowNs();
+}
+
+void BenchState::Stop() {
+    if (!running_) return;
+    elapsedNs += NowNs() - startNs_;
+    allocations += AllocationCount() - startAllocs_;
+    running_ = false;
+}
+
+void BenchState::PauseTiming() {
+    Stop();
+}
+
+void BenchState::ResumeTiming() {
+    Start();
+}
+
+// ---------------------------------------------------------------------------
+// 注册与运行
+// ---------------------------------------------------------------------------
+
+static std::vector<Benchmark *> &Registry() {
+    static std::vector<Benchmark *> benchmarks;
+    return benchmarks;
+}
+
+Benchmark *RegisterBenchmark(const char *name, BenchFunction fn) {
+    Registry().push_back(new Benchmark(name, std::move(fn)));
+    return Registry().back();
+}
+
+static const int64_t MIN_TIME_NS = 200 * 1000 * 1000; // 每个用例至少运行 200ms
+static const int64_t MAX_ITERATIONS = 1000000000;
+
+static void RunOne(const Benchmark &bench, int64_t arg, bool hasArg) {
+    std::string name = bench.Name();
+    if (hasArg) name += "/" + std::to_string(arg);
+
+    // 逐步放大迭代次数，直到单次运行超过最短时间
+    int64_t iterations = 1;
+    while (true) {
+        BenchState state(arg, iterations);
+        bench.Function()(state);
+        if (state.elapsedNs >= MIN_TIME_NS || iterations >= MAX_ITERATIONS) {
+            double nsPerOp = static_cast<double>(state.elapsedNs) / iterations;
+            double allocsPerOp = static_cast<double>(state.allocations) / iterations;
+            std::printf("%-44s %12lld %12.1f ns/op %10.3f allocs/op", name.c_str(),
+                        static_cast<long long>(iterations), nsPerOp, allocsPerOp);
+            for (const auto &counter : state.counters) {
+                std::printf("  %s=%.4g", counter.first.c_str(), counter.second / iterations);
+            }
+            std::printf("\n");
+            return;
+        }
+        // 按上一轮耗时估算所需迭代次数，留 40% 余量
+        double scale = state.elapsedNs > 0 ? 1.4 * MIN_TIME_NS / state.elapsedNs : 10.0;
+        int64_t next = static_cast<int64_t>(iterations * std::min(std::max(scale, 2.0), 100.0));
+        iterations = std::min(next, MAX_ITERATIONS);
+    }
+}
+
+// 用法：net_guardian_bench [名称过滤子串]
+int main(int argc, char **argv) {
+    const char *filter = argc > 1 ? argv[1] : nullptr;
+    std::printf("%-44s %12s %15s %20s\n", "Benchmark", "Iterations", "Time", "Allocs");
+    for (const Benchmark *bench : Registry()) {
+        if (filter != nullptr && bench->Name().find(filter) == std::string::npos) continue;
+        if (bench->Args().empty()) {
+            RunOne(*bench, 0, false);
+        } else {
+            for (int64_t arg : bench->Args()) RunOne(*bench, arg, true);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,94 @@
+#ifndef NET_GUARDIAN_BENCH_HARNESS_H
+#define NET_GUARDIAN_BENCH_HARNESS_H
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * 极简的 Google-Benchmark 风格基准框架 (不引入第三方依赖)
+ * 用法：
+ *   static void BM_Foo(BenchState &state) {
+ *       while (state.KeepRunning()) { ... }
+ *   }
+ *   BENCHMARK(BM_Foo)->Arg(16)->Arg(4096);
+ * 运行器自动放大迭代次数直到耗时超过最短时间，输出 ns/op 与 allocs/op (全局 operator new 计数)
+ */
+class BenchState {
+public:
+    BenchState(int64_t arg, int64_t iterations) : arg_(arg), remaining_(iterations), iterations_(iterations) {}
+
+    // 第一次调用时开始计时，迭代用完时停止计时
+    bool KeepRunning();
+
+    int64_t Arg() const { return arg_; }
+    int64_t Iterations() const { return iterations_; }
+
+    // 暂停 / 恢复计时 (用于排除准备数据的开销，会同时暂停分配计数)
+    void PauseTiming();
+    void ResumeTiming();
+
+    // 自定义计数器，按 "总量 / 迭代次数" 输出
+    std::map<std::string, double> counters;
+
+    // 以下由运行器读取
+    int64_t elapsedNs = 0;
+    uint64_t allocations = 0;
+
+private:
+    void Start();
+    void Stop();
+
+    int64_t arg_;
+    int64_t remaining_;
+    int64_t iterations_;
+    bool started_ = false;
+    bool running_ = false;
+    int64_t startNs_ = 0;
+    uint64_t startAllocs_ = 0;
+};
+
+using BenchFunction = std::function<void(BenchState &)>;
+
+class Benchmark {
+public:
+    Benchmark(std::string name, BenchFunction fn) : name_(std::move(name)), fn_(std::move(fn)) {}
+
+    Benchmark *Arg(int64_t arg) {
+        args_.push_back(arg);
+        return this;
+    }
+
+    // 以 multiplier 为倍数生成 [lo, hi] 区间的参数
+    Benchmark *Range(int64_t lo, int64_t hi, int64_t multiplier = 2) {
+        for (int64_t v = lo; v <= hi; v *= multiplier) args_.push_back(v);
+        return this;
+    }
+
+    const std::string &Name() const { return name_; }
+    const std::vector<int64_t> &Args() const { return args_; }
+    const BenchFunction &Function() const { return fn_; }
+
+private:
+    std::string name_;
+    BenchFunction fn_;
+    std::vector<int64_t> args_;
+};
+
+Benchmark *RegisterBenchmark(const char *name, BenchFunction fn);
+
+// 进程启动以来全局 operator new 的调用次数
+uint64_t AllocationCount();
+
+// 防止编译器把基准中的计算优化掉
+template <typename T> inline void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+#define BENCH_CONCAT_INNER(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_INNER(a, b)
+#define BENCHMARK(fn) static Benchmark *BENCH_CONCAT(g_bench_, __LINE__) = RegisterBenchmark(#fn, fn)
+
+#endif
@@ -0,0 +1,58 @@
+// 波形整帧绘制基准：WaveformRenderer + HeadlessSurface + native_drawing 软件替身 (宿主机)
+// 绝对耗时取决于软件光栅化，不代表设备上的数值；用于比较增量滚动与整帧重画、以及不同历史深度的相对开销
+#include "bench_harness.h"
+#include "headless_surface.h"
+#include "sample_history.h"
+#include "waveform_renderer.h"
+
+static const uint64_t FRAME_WIDTH = 1080;
+static const uint64_t FRAME_HEIGHT = 360;
+static const int64_t SAMPLE_US = 100000;
+
+// 刻度保持稳定的伪随机样本 (3000 ~ 7000 kbps)
+static double NextSample(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return 3000.0 + static_cast<double>((*state >> 33) % 4000);
+}
+
+// 每次迭代时间前进一个样本间隔、推送一个样本并出一帧，fullRedraw 为 true 时每帧都使已画内容失效
+// 窗口与 RenderManager 相同 ((depth - 1) 个样本间隔)
+static void RunRenderFrames(BenchState &state, bool fullRedraw) {
+    size_t depth = static_cast<size_t>(state.Arg());
+    int64_t windowUs = static_cast<int64_t>(depth - 1) * SAMPLE_US;
+    SampleHistory history(depth);
+    HeadlessSurface surface(FRAME_WIDTH, FRAME_HEIGHT);
+    WaveformRenderer renderer;
+    uint64_t rng = 1;
+    int64_t nowUs = 0;
+    for (size_t i = 0; i < depth; i++) history.Push(nowUs += SAMPLE_US, NextSample(&rng));
+    // 先把每块缓冲区都画过一次，排除首帧创建资源的开销
+    for (int i = 0; i < 4; i++) {
+        history.Push(nowUs += SAMPLE_US, NextSample(&rng));
+        renderer.RenderFrame(&surface, history, windowUs, nowUs);
+    }
+    renderer.ResetMetrics();
+
+    double partialFrames = 0;
+    while (state.KeepRunning()) {
+        history.Push(nowUs += SAMPLE_US, NextSample(&rng));
+        if (fullRedraw) renderer.InvalidateContent();
+        renderer.RenderFrame(&surface, history, windowUs, nowUs);
+        partialFrames += surface.LastDamagePartial() ? 1 : 0;
+    }
+    state.counters["partial"] = partialFrames;
+    // 各阶段每帧的平均耗时 (计数器按迭代数平均，因此记入总耗时)，看瓶颈在绘制还是像素搬移
+    const RenderMetrics &metrics = renderer.Metrics();
+    state.counters["draw_us"] = static_cast<double>(metrics.stages[RENDER_STAGE_DRAW].totalUs);
+    state.counters["copy_us"] = static_cast<double>(metrics.stages[RENDER_STAGE_COPY].totalUs);
+}
+
+static void BM_RenderFrameScroll(BenchState &state) {
+    RunRenderFrames(state, false);
+}
+BENCHMARK(BM_RenderFrameScroll)->Arg(15)->Arg(1080)->Arg(16384);
+
+static void BM_RenderFrameFull(BenchState &state) {
+    RunRenderFrames(state, true);
+}
+BENCHMARK(BM_RenderFrameFull)->Arg(15)->Arg(1080)->Arg(16384);
@@ -0,0 +1,216 @@
+// 流量分析热路径基准：ProcessAt 快/慢路径、窗口大小、波形历史快照
+#include "bench_harness.h"
+#include "clock_source.h"
+#include "sample_history.h"
+#include "sliding_window.h"
+#include "traffic_analyzer.h"
+#include "waveform_kernels.h"
+#include "waveform_layout.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+static const size_t PACKET_BYTES = 1460; // 典型 TCP MSS
+
+// 稳态逐包分析：参数为包速率 (packets/s)，每次迭代处理一个包
+// slow_frac 为产生新样本 (走慢路径) 的调用占比
+static void BM_ProcessSteadyState(BenchState &state) {
+    TrafficAnalyzer analyzer;
+    uint64_t samples = 0;
+    analyzer.SetSampleListener([&samples](double, int64_t) { samples++; });
+
+    const double intervalUs = 1000000.0 / static_cast<double>(state.Arg());
+    double timestampUs = 0;
+    while (state.KeepRunning()) {
+        TrafficStats stats = analyzer.ProcessAt(PACKET_BYTES, static_cast<int64_t>(timestampUs));
+        DoNotOptimize(stats);
+        timestampUs += intervalUs;
+    }
+    state.counters["slow_frac"] = static_cast<double>(samples);
+}
+BENCHMARK(BM_ProcessSteadyState)->Arg(1000)->Arg(10000)->Arg(100000);
+
+// 快速路径：所有包在同一时刻到达，永远不足 100ms
+static void BM_ProcessFastPath(BenchState &state) {
+    TrafficAnalyzer analyzer;
+    analyzer.ProcessAt(PACKET_BYTES, 0);
+    while (state.KeepRunning()) {
+        TrafficStats stats = analyzer.ProcessAt(PACKET_BYTES, 1);
+        DoNotOptimize(stats);
+    }
+}
+BENCHMARK(BM_ProcessFastPath);
+
+// 慢速路径：每个包都间隔 100ms，每次都产生新样本
+static void BM_ProcessSlowPath(BenchState &state) {
+    TrafficAnalyzer analyzer;
+    int64_t timestampUs = 0;
+    while (state.KeepRunning()) {
+        TrafficStats stats = analyzer.ProcessAt(PACKET_BYTES, timestampUs);
+        DoNotOptimize(stats);
+        timestampUs += 100000;
+    }
+}
+BENCHMARK(BM_ProcessSlowPath);
+
+// 逐包路径的读时钟开销：精确时钟 vs 粗粒度时钟
+static void BM_ClockSteady(BenchState &state) {
+    ClockSource *clock = ClockSource::Steady();
+    while (state.KeepRunning()) {
+        int64_t now = clock->NowUs();
+        DoNotOptimize(now);
+    }
+}
+BENCHMARK(BM_ClockSteady);
+
+static void BM_ClockCoarse(BenchState &state) {
+    ClockSource *clock = ClockSource::CoarseMonotonic();
+    while (state.KeepRunning()) {
+        int64_t now = clock->NowUs();
+        DoNotOptimize(now);
+    }
+}
+BENCHMARK(BM_ClockCoarse);
+
+// 不同抖动窗口大小下的慢速路径开销 (应与窗口大小无关)
+static void BM_ProcessWindowSize(BenchState &state) {
+    TrafficAnalyzer analyzer(static_cast<size_t>(state.Arg()));
+    int64_t timestampUs = 0;
+    size_t bytes = PACKET_BYTES;
+    while (state.KeepRunning()) {
+        TrafficStats stats = analyzer.ProcessAt(bytes, timestampUs);
+        DoNotOptimize(stats);
+        timestampUs += 100000;
+        bytes = (bytes * 7 + 13) % 65536; // 让瞬时速度有波动
+    }
+}
+BENCHMARK(BM_ProcessWindowSize)->Range(16, 4096, 4);
+
+// 窗口统计本身：Push + StdDev
+static void BM_SlidingWindowPush(BenchState &state) {
+    SlidingWindowStats window(static_cast<size_t>(state.Arg()));
+    double value = 1000.0;
+    while (state.KeepRunning()) {
+        window.Push(value);
+        double jitter = window.StdDev();
+        DoNotOptimize(jitter);
+        value = value * 1.0001 + 1.0;
+    }
+}
+BENCHMARK(BM_SlidingWindowPush)->Range(16, 4096, 4);
+
+// RenderManager::PushData 的数据侧开销 (写入采样历史，不含绘制)
+static void BM_HistoryPush(BenchState &state) {
+    SampleHistory history(static_cast<size_t>(state.Arg()));
+    double value = 0;
+    int64_t timeUs = 0;
+    while (state.KeepRunning()) {
+        history.Push(timeUs += 100000, value);
+        value += 1.0;
+    }
+}
+BENCHMARK(BM_HistoryPush)->Arg(15)->Arg(256)->Arg(4096);
+
+// 每帧绘制前对采样历史取快照的开销
+static void BM_HistorySnapshot(BenchState &state) {
+    SampleHistory history(static_cast<size_t>(state.Arg()));
+    for (int64_t i = 0; i < state.Arg(); i++) history.Push(i * 100000, static_cast<double>(i));
+    std::vector<WaveformSample> snapshot(history.Capacity());
+    while (state.KeepRunning()) {
+        size_t count = history.Snapshot(snapshot.data());
+        DoNotOptimize(count);
+    }
+}
+BENCHMARK(BM_HistorySnapshot)->Arg(15)->Arg(256)->Arg(4096);
+
+// 生产者持续写入时，消费者取快照的开销 (验证生产者不会拖慢消费者，反之亦然)
+static void BM_HistorySnapshotContended(BenchState &state) {
+    SampleHistory history(static_cast<size_t>(state.Arg()));
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        double value = 0;
+        int64_t timeUs = 0;
+        while (!stop.load(std::memory_order_relaxed)) history.Push(timeUs += 100000, value += 1.0);
+    });
+    std::vector<WaveformSample> snapshot(history.Capacity());
+    while (state.KeepRunning()) {
+        size_t count = history.Snapshot(snapshot.data());
+        DoNotOptimize(count);
+    }
+    state.PauseTiming();
+    stop = true;
+    producer.join();
+}
+BENCHMARK(BM_HistorySnapshotContended)->Arg(15)->Arg(256);
+
+// 长历史每帧的按列聚合：depth 个样本 (间隔 100 毫秒) 聚合到 1080 列，窗口覆盖整个历史
+static void BM_AggregateColumns(BenchState &state) {
+    const int32_t columns = 1080;
+    size_t depth = static_cast<size_t>(state.Arg());
+    int64_t windowUs = static_cast<int64_t>(depth - 1) * 100000;
+    std::vector<int64_t> times(depth);
+    std::vector<double> data(depth);
+    for (size_t i = 0; i < depth; i++) {
+        times[i] = static_cast<int64_t>(i) * 100000;
+        data[i] = static_cast<double>((i * 7919) % 10000);
+    }
+    int64_t originColumn = WaveformColumn(times[depth - 1], columns, windowUs) - (columns - 1);
+    std::vector<int64_t> outColumns(depth);
+    std::vector<double> lows(depth);
+    std::vector<double> highs(depth);
+    while (state.KeepRunning()) {
+        size_t points = AggregateColumns(times.data(), data.data(), depth, columns, windowUs, originColumn,
+                                         outColumns.data(), lows.data(), highs.data());
+        DoNotOptimize(points);
+    }
+}
+BENCHMARK(BM_AggregateColumns)->Range(1024, 65536, 8);
+
+// 每帧的极值扫描与像素坐标变换：向量化实现 vs 标量实现
+static std::vector<double> KernelSamples(size_t count) {
+    std::vector<double> data(count);
+    for (size_t i = 0; i < count; i++) data[i] = static_cast<double>((i * 7919) % 10000);
+    return data;
+}
+
+static void BM_ScanMinMax(BenchState &state) {
+    std::vector<double> data = KernelSamples(static_cast<size_t>(state.Arg()));
+    while (state.KeepRunning()) {
+        double low = 0;
+        double high = 0;
+        ScanMinMax(data.data(), data.size(), &low, &high);
+        DoNotOptimize(high);
+    }
+}
+BENCHMARK(BM_ScanMinMax)->Range(16, 65536, 16);
+
+static void BM_ScanMinMaxScalar(BenchState &state) {
+    std::vector<double> data = KernelSamples(static_cast<size_t>(state.Arg()));
+    while (state.KeepRunning()) {
+        double low = 0;
+        double high = 0;
+        ScanMinMaxScalar(data.data(), data.size(), &low, &high);
+        DoNotOptimize(high);
+    }
+}
+BENCHMARK(BM_ScanMinMaxScalar)->Range(16, 65536, 16);
+
+static void BM_ValuesToPixelY(BenchState &state) {
+    std::vector<double> data = KernelSamples(static_cast<size_t>(state.Arg()));
+    std::vector<float> ys(data.size());
+    while (state.KeepRunning()) {
+        ValuesToPixelY(data.data(), data.size(), 20000.0, 720, ys.data());
+        DoNotOptimize(ys.data());
+    }
+}
+BENCHMARK(BM_ValuesToPixelY)->Range(16, 65536, 16);
+
+static void BM_ValuesToPixelYScalar(BenchState &state) {
+    std::vector<double> data = KernelSamples(static_cast<size_t>(state.Arg()));
+    std::vector<float> ys(data.size());
+    while (state.KeepRunning()) {
+        ValuesToPixelYScalar(data.data(), data.size(), 20000.0, 720, ys.data());
+        DoNotOptimize(ys.data());
+    }
+}
+BENCHMARK(BM_ValuesToPixelYScalar)->Range(16, 65536, 16);
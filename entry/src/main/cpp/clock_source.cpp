@@ -0,0 +1,35 @@
+#include "clock_source.h"
+#include <chrono>
+#include <time.h>
+
+// 以下实现只在本文件内使用，通过 ClockSource 的静态工厂获取
+class SteadyClockSource : public ClockSource {
+public:
+    int64_t NowUs() override {
+        auto now = std::chrono::steady_clock::now().time_since_epoch();
+        return std::chrono::duration_cast<std::chrono::microseconds>(now).count();
+    }
+};
+
+class CoarseMonotonicClockSource : public ClockSource {
+public:
+    int64_t NowUs() override {
+#ifdef CLOCK_MONOTONIC_COARSE
+        struct timespec ts;
+        if (clock_gettime(CLOCK_MONOTONIC_COARSE, &ts) == 0) {
+            return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+        }
+#endif
+        return ClockSource::Steady()->NowUs();
+    }
+};
+
+ClockSource *ClockSource::Steady() {
+    static SteadyClockSource clock;
+    return &clock;
+}
+
+ClockSource *ClockSource::CoarseMonotonic() {
+    static CoarseMonotonicClockSource clock;
+    return &clock;
+}
@@ -0,0 +1,53 @@
+// 速度收敛检测：滑动窗口均值 / 抖动 / 置信区间 + 均值漂移
+#include "convergence_detector.h"
+#include <algorithm>
+#include <cmath>
+
+ConvergenceDetector::ConvergenceDetector(const ConvergenceConfig &config)
+    : window_(std::max<size_t>(config.windowSamples, 2)) {
+    Configure(config);
+}
+
+void ConvergenceDetector::Configure(const ConvergenceConfig &config) {
+    config_ = config;
+    config_.windowSamples = std::max<size_t>(config.windowSamples, 2);
+    config_.driftSamples = std::max<size_t>(config.driftSamples, 1);
+    if (window_.Capacity() != config_.windowSamples) {
+        window_ = SlidingWindowStats(config_.windowSamples);
+    }
+    recentMeans_.assign(config_.driftSamples, 0.0);
+    Reset();
+}
+
+void ConvergenceDetector::Reset() {
+    window_.Clear();
+    meanHead_ = 0;
+    meanCount_ = 0;
+    stable_ = false;
+}
+
+double ConvergenceDetector::ConfidenceKbps() const {
+    if (window_.Size() < 2) {
+        return 0.0;
+    }
+    return config_.confidenceZ * window_.StdDev() / std::sqrt(static_cast<double>(window_.Size()));
+}
+
+bool ConvergenceDetector::Update(double instantKbps, int64_t elapsedUs) {
+    window_.Push(instantKbps);
+    double mean = window_.Mean();
+    recentMeans_[meanHead_] = mean;
+    meanHead_ = (meanHead_ + 1) % recentMeans_.size();
+    meanCount_ = std::min(meanCount_ + 1, recentMeans_.size());
+
+    stable_ = false;
+    if (elapsedUs < config_.minDurationUs || window_.Size() < window_.Capacity() ||
+        meanCount_ < recentMeans_.size() || mean <= 0) {
+        return false;
+    }
+    auto range = std::minmax_element(recentMeans_.begin(), recentMeans_.end());
+    double drift = (*range.second - *range.first) / mean;
+    stable_ = window_.StdDev() / mean <= config_.maxJitterRatio &&
+              ConfidenceKbps() / mean <= config_.maxConfidenceRatio && drift <= config_.maxDriftRatio;
+    return stable_;
+}
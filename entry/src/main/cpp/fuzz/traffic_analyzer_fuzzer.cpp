@@ -0,0 +1,31 @@
+// libFuzzer 入口：把任意字节流解释为 (时间增量, 包长) 序列送入分析器，检查统计量不出现 NaN / 负值
+#include "traffic_analyzer.h"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+    TrafficAnalyzer analyzer;
+    int64_t timestampUs = 0;
+
+    // 每条记录 6 字节：2 字节时间增量 (x100us) + 4 字节包长
+    while (size >= 6) {
+        uint16_t deltaTicks = 0;
+        uint32_t byteLength = 0;
+        memcpy(&deltaTicks, data, sizeof(deltaTicks));
+        memcpy(&byteLength, data + 2, sizeof(byteLength));
+        data += 6;
+        size -= 6;
+
+        timestampUs += static_cast<int64_t>(deltaTicks) * 100;
+        TrafficStats stats = analyzer.ProcessAt(byteLength, timestampUs);
+        if (!stats.valid) continue;
+
+        if (std::isnan(stats.instantKbps) || std::isnan(stats.jitter) || std::isnan(stats.avgKbps) ||
+            stats.jitter < 0 || stats.minKbps > stats.maxKbps) {
+            abort();
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,93 @@
+// 无窗口渲染目标：内存中的 RGBA 缓冲队列，供宿主机基准与像素测试使用
+#include "headless_surface.h"
+#include <cstdio>
+
+HeadlessSurface::HeadlessSurface(uint64_t width, uint64_t height, size_t bufferCount, int32_t stride)
+    : buffers_(bufferCount > 0 ? bufferCount : 1) {
+    Resize(width, height, stride);
+}
+
+void HeadlessSurface::Resize(uint64_t width, uint64_t height, int32_t stride) {
+    width_ = width;
+    height_ = height;
+    int32_t minStride = static_cast<int32_t>(width * 4);
+    stride_ = stride > minStride ? stride : minStride;
+    for (auto &buffer : buffers_) {
+        buffer.assign(static_cast<size_t>(stride_) * height, 0);
+    }
+    nextBuffer_ = 0;
+    presentedBuffer_ = -1;
+    epoch_++;
+}
+
+RenderSurface::AcquireResult HeadlessSurface::AcquireFrame(SurfaceFrame *frame) {
+    if (width_ == 0 || height_ == 0) {
+        return ACQUIRE_FAILED;
+    }
+    if (stalledAcquires_ > 0) {
+        stalledAcquires_--;
+        notReadyCount_++;
+        return ACQUIRE_NOT_READY;
+    }
+    size_t index = nextBuffer_;
+    nextBuffer_ = (nextBuffer_ + 1) % buffers_.size();
+    frame->pixels = buffers_[index].data();
+    frame->stride = stride_;
+    frame->width = width_;
+    frame->height = height_;
+    frame->bufferId = static_cast<int64_t>(index);
+    frame->epoch = epoch_;
+    frame->native = nullptr;
+    return ACQUIRE_OK;
+}
+
+void HeadlessSurface::PresentFrame(const SurfaceFrame &frame, const SurfaceDamage *damage) {
+    presentedBuffer_ = frame.bufferId;
+    lastDamagePartial_ = damage != nullptr;
+    lastDamage_ = damage != nullptr ? *damage : SurfaceDamage();
+    presentedCount_++;
+}
+
+void HeadlessSurface::DiscardFrame(const SurfaceFrame &frame) {
+    // 放弃的缓冲区下一次最先被重新出队 (与窗口的 AbortBuffer 一致)
+    nextBuffer_ = static_cast<size_t>(frame.bufferId);
+    discardedCount_++;
+}
+
+const uint8_t *HeadlessSurface::PresentedPixels() const {
+    return presentedBuffer_ >= 0 ? buffers_[static_cast<size_t>(presentedBuffer_)].data() : nullptr;
+}
+
+uint32_t HeadlessSurface::PresentedPixel(uint64_t x, uint64_t y) const {
+    const uint8_t *pixels = PresentedPixels();
+    if (pixels == nullptr || x >= width_ || y >= height_) {
+        return 0;
+    }
+    const uint8_t *p = pixels + y * static_cast<uint64_t>(stride_) + x * 4;
+    return (static_cast<uint32_t>(p[3]) << 24) | (static_cast<uint32_t>(p[0]) << 16) |
+        (static_cast<uint32_t>(p[1]) << 8) | p[2];
+}
+
+bool HeadlessSurface::WritePpm(const std::string &path) const {
+    const uint8_t *pixels = PresentedPixels();
+    if (pixels == nullptr) {
+        return false;
+    }
+    FILE *file = std::fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fprintf(file, "P6\n%llu %llu\n255\n", static_cast<unsigned long long>(width_),
+                 static_cast<unsigned long long>(height_));
+    std::vector<uint8_t> row(static_cast<size_t>(width_) * 3);
+    for (uint64_t y = 0; y < height_; y++) {
+        const uint8_t *src = pixels + y * static_cast<uint64_t>(stride_);
+        for (uint64_t x = 0; x < width_; x++) {
+            row[x * 3] = src[x * 4];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 2];
+        }
+        std::fwrite(row.data(), 1, row.size(), file);
+    }
+    return std::fclose(file) == 0;
+}
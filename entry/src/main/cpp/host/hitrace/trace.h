@@ -0,0 +1,16 @@
+#ifndef NET_GUARDIAN_HOST_HITRACE_TRACE_H
+#define NET_GUARDIAN_HOST_HITRACE_TRACE_H
+
+/**
+ * 宿主机构建用的 hitrace 替身 (签名与 OpenHarmony NDK 一致)，宿主机上没有 trace 通道，全部为空操作
+ */
+#include <cstdint>
+
+inline void OH_HiTrace_StartTrace(const char *name) { (void)name; }
+inline void OH_HiTrace_FinishTrace(void) {}
+inline void OH_HiTrace_CountTrace(const char *name, int64_t count) {
+    (void)name;
+    (void)count;
+}
+
+#endif
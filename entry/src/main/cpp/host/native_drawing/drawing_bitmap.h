@@ -0,0 +1,29 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_BITMAP_H
+#define NET_GUARDIAN_HOST_DRAWING_BITMAP_H
+
+#include "drawing_types.h"
+
+typedef struct {
+    OH_Drawing_ColorFormat colorFormat;
+    OH_Drawing_AlphaFormat alphaFormat;
+} OH_Drawing_BitmapFormat;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Bitmap* OH_Drawing_BitmapCreate(void);
+void OH_Drawing_BitmapDestroy(OH_Drawing_Bitmap* bitmap);
+// 只支持 COLOR_FORMAT_RGBA_8888，其他格式返回 nullptr
+OH_Drawing_Bitmap* OH_Drawing_BitmapCreateFromPixels(OH_Drawing_Image_Info* info, void* pixels, uint32_t rowBytes);
+void OH_Drawing_BitmapBuild(OH_Drawing_Bitmap* bitmap, const uint32_t width, const uint32_t height,
+                            const OH_Drawing_BitmapFormat* format);
+uint32_t OH_Drawing_BitmapGetWidth(OH_Drawing_Bitmap* bitmap);
+uint32_t OH_Drawing_BitmapGetHeight(OH_Drawing_Bitmap* bitmap);
+void* OH_Drawing_BitmapGetPixels(OH_Drawing_Bitmap* bitmap);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
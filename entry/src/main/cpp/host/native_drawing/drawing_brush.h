@@ -0,0 +1,20 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_BRUSH_H
+#define NET_GUARDIAN_HOST_DRAWING_BRUSH_H
+
+#include "drawing_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Brush* OH_Drawing_BrushCreate(void);
+void OH_Drawing_BrushDestroy(OH_Drawing_Brush* brush);
+void OH_Drawing_BrushSetAntiAlias(OH_Drawing_Brush* brush, bool antiAlias);
+void OH_Drawing_BrushSetColor(OH_Drawing_Brush* brush, uint32_t color);
+void OH_Drawing_BrushSetShaderEffect(OH_Drawing_Brush* brush, OH_Drawing_ShaderEffect* shaderEffect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
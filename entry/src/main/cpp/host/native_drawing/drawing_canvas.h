@@ -0,0 +1,32 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_CANVAS_H
+#define NET_GUARDIAN_HOST_DRAWING_CANVAS_H
+
+#include "drawing_types.h"
+
+typedef enum { DIFFERENCE, INTERSECT } OH_Drawing_CanvasClipOp;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Canvas* OH_Drawing_CanvasCreate(void);
+void OH_Drawing_CanvasDestroy(OH_Drawing_Canvas* canvas);
+void OH_Drawing_CanvasBind(OH_Drawing_Canvas* canvas, OH_Drawing_Bitmap* bitmap);
+void OH_Drawing_CanvasAttachPen(OH_Drawing_Canvas* canvas, const OH_Drawing_Pen* pen);
+void OH_Drawing_CanvasDetachPen(OH_Drawing_Canvas* canvas);
+void OH_Drawing_CanvasAttachBrush(OH_Drawing_Canvas* canvas, const OH_Drawing_Brush* brush);
+void OH_Drawing_CanvasDetachBrush(OH_Drawing_Canvas* canvas);
+void OH_Drawing_CanvasSave(OH_Drawing_Canvas* canvas);
+void OH_Drawing_CanvasRestore(OH_Drawing_Canvas* canvas);
+void OH_Drawing_CanvasDrawPath(OH_Drawing_Canvas* canvas, const OH_Drawing_Path* path);
+void OH_Drawing_CanvasDrawRect(OH_Drawing_Canvas* canvas, const OH_Drawing_Rect* rect);
+// 替身只支持 INTERSECT (矩形裁剪)，DIFFERENCE 被忽略
+void OH_Drawing_CanvasClipRect(OH_Drawing_Canvas* canvas, const OH_Drawing_Rect* rect, OH_Drawing_CanvasClipOp clipOp,
+                               bool doAntiAlias);
+void OH_Drawing_CanvasClear(OH_Drawing_Canvas* canvas, uint32_t color);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,21 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_PATH_H
+#define NET_GUARDIAN_HOST_DRAWING_PATH_H
+
+#include "drawing_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Path* OH_Drawing_PathCreate(void);
+void OH_Drawing_PathDestroy(OH_Drawing_Path* path);
+void OH_Drawing_PathMoveTo(OH_Drawing_Path* path, float x, float y);
+void OH_Drawing_PathLineTo(OH_Drawing_Path* path, float x, float y);
+void OH_Drawing_PathClose(OH_Drawing_Path* path);
+void OH_Drawing_PathReset(OH_Drawing_Path* path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_PEN_H
+#define NET_GUARDIAN_HOST_DRAWING_PEN_H
+
+#include "drawing_types.h"
+
+typedef enum { LINE_FLAT_CAP, LINE_SQUARE_CAP, LINE_ROUND_CAP } OH_Drawing_PenLineCapStyle;
+typedef enum { LINE_MITER_JOIN, LINE_ROUND_JOIN, LINE_BEVEL_JOIN } OH_Drawing_PenLineJoinStyle;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Pen* OH_Drawing_PenCreate(void);
+void OH_Drawing_PenDestroy(OH_Drawing_Pen* pen);
+void OH_Drawing_PenSetAntiAlias(OH_Drawing_Pen* pen, bool antiAlias);
+void OH_Drawing_PenSetColor(OH_Drawing_Pen* pen, uint32_t color);
+void OH_Drawing_PenSetWidth(OH_Drawing_Pen* pen, float width);
+// 替身按圆头 / 圆角描边处理 (波形只使用这一种)，端点与拐角样式仅被记录
+void OH_Drawing_PenSetCap(OH_Drawing_Pen* pen, OH_Drawing_PenLineCapStyle capStyle);
+void OH_Drawing_PenSetJoin(OH_Drawing_Pen* pen, OH_Drawing_PenLineJoinStyle joinStyle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_POINT_H
+#define NET_GUARDIAN_HOST_DRAWING_POINT_H
+
+#include "drawing_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Point* OH_Drawing_PointCreate(float x, float y);
+void OH_Drawing_PointDestroy(OH_Drawing_Point* point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
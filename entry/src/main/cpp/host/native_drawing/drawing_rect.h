@@ -0,0 +1,17 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_RECT_H
+#define NET_GUARDIAN_HOST_DRAWING_RECT_H
+
+#include "drawing_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OH_Drawing_Rect* OH_Drawing_RectCreate(float left, float top, float right, float bottom);
+void OH_Drawing_RectDestroy(OH_Drawing_Rect* rect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_SHADER_EFFECT_H
+#define NET_GUARDIAN_HOST_DRAWING_SHADER_EFFECT_H
+
+#include "drawing_types.h"
+
+typedef enum { CLAMP, REPEAT, MIRROR, DECAL } OH_Drawing_TileMode;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// 替身只实现 CLAMP 平铺 (其他模式按 CLAMP 处理)；pos 非空时须在 [0, 1] 内单调不减，否则返回 nullptr
+OH_Drawing_ShaderEffect* OH_Drawing_ShaderEffectCreateLinearGradient(const OH_Drawing_Point* startPt,
+    const OH_Drawing_Point* endPt, const uint32_t* colors, const float* pos, uint32_t size,
+    OH_Drawing_TileMode tileMode);
+void OH_Drawing_ShaderEffectDestroy(OH_Drawing_ShaderEffect* shaderEffect);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef NET_GUARDIAN_HOST_DRAWING_TYPES_H
+#define NET_GUARDIAN_HOST_DRAWING_TYPES_H
+
+/**
+ * 宿主机构建用的 native_drawing 替身 (只声明波形绘制用到的子集，签名与 OpenHarmony NDK 一致)
+ * 实现见 host/soft_drawing.cpp：纯软件光栅化到 RGBA_8888 内存，用于帧耗时基准与像素级测试
+ */
+#include <cstddef>
+#include <cstdint>
+
+typedef struct OH_Drawing_Canvas OH_Drawing_Canvas;
+typedef struct OH_Drawing_Pen OH_Drawing_Pen;
+typedef struct OH_Drawing_Brush OH_Drawing_Brush;
+typedef struct OH_Drawing_Path OH_Drawing_Path;
+typedef struct OH_Drawing_Bitmap OH_Drawing_Bitmap;
+typedef struct OH_Drawing_Point OH_Drawing_Point;
+typedef struct OH_Drawing_Rect OH_Drawing_Rect;
+typedef struct OH_Drawing_ShaderEffect OH_Drawing_ShaderEffect;
+
+typedef enum {
+    COLOR_FORMAT_UNKNOWN,
+    COLOR_FORMAT_ALPHA_8,
+    COLOR_FORMAT_RGB_565,
+    COLOR_FORMAT_ARGB_4444,
+    COLOR_FORMAT_RGBA_8888,
+    COLOR_FORMAT_BGRA_8888
+} OH_Drawing_ColorFormat;
+
+typedef enum {
+    ALPHA_FORMAT_UNKNOWN,
+    ALPHA_FORMAT_OPAQUE,
+    ALPHA_FORMAT_PREMUL,
+    ALPHA_FORMAT_UNPREMUL
+} OH_Drawing_AlphaFormat;
+
+typedef struct {
+    int32_t width;
+    int32_t height;
+    OH_Drawing_ColorFormat colorType;
+    OH_Drawing_AlphaFormat alphaType;
+} OH_Drawing_Image_Info;
+
+#endif
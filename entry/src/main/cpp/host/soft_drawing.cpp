@@ -0,0 +1,595 @@
+// native_drawing 的宿主机软件替身：把波形绘制用到的子集光栅化到 RGBA_8888 (premultiplied) 内存
+// 填充按非零环绕规则、以像素中心采样 (无抗锯齿)；描边按圆头 / 圆角处理，开启抗锯齿时按到线段的距离计算覆盖率
+// 只追求确定性与足够接近设备效果，用于帧耗时基准和增量绘制的像素级对比，不追求与 Skia 逐像素一致
+#include <native_drawing/drawing_bitmap.h>
+#include <native_drawing/drawing_brush.h>
+#include <native_drawing/drawing_canvas.h>
+#include <native_drawing/drawing_path.h>
+#include <native_drawing/drawing_pen.h>
+#include <native_drawing/drawing_point.h>
+#include <native_drawing/drawing_rect.h>
+#include <native_drawing/drawing_shader_effect.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct OH_Drawing_Point {
+    float x = 0;
+    float y = 0;
+};
+
+struct OH_Drawing_Rect {
+    float left = 0;
+    float top = 0;
+    float right = 0;
+    float bottom = 0;
+};
+
+struct OH_Drawing_Bitmap {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t rowBytes = 0;
+    uint8_t *pixels = nullptr;    // 指向 storage 或外部像素
+    std::vector<uint8_t> storage; // BitmapBuild 分配的像素
+};
+
+struct OH_Drawing_ShaderEffect {
+    OH_Drawing_Point start;
+    OH_Drawing_Point end;
+    std::vector<uint32_t> colors;
+    std::vector<float> pos;
+};
+
+struct OH_Drawing_Brush {
+    uint32_t color = 0xFF000000;
+    bool antiAlias = false;
+    const OH_Drawing_ShaderEffect *shader = nullptr;
+};
+
+struct OH_Drawing_Pen {
+    uint32_t color = 0xFF000000;
+    float width = 0;
+    bool antiAlias = false;
+    OH_Drawing_PenLineCapStyle cap = LINE_FLAT_CAP;
+    OH_Drawing_PenLineJoinStyle join = LINE_MITER_JOIN;
+};
+
+struct PathContour {
+    size_t begin = 0; // points 中的下标范围 [begin, end)
+    size_t end = 0;
+    bool closed = false;
+};
+
+struct OH_Drawing_Path {
+    std::vector<OH_Drawing_Point> points;
+    std::vector<PathContour> contours;
+};
+
+struct ClipBounds {
+    int32_t left = 0;
+    int32_t top = 0;
+    int32_t right = 0;
+    int32_t bottom = 0;
+
+    bool Empty() const { return left >= right || top >= bottom; }
+};
+
+struct PathEdge {
+    float x0, y0, x1, y1;
+};
+
+struct SpanCrossing {
+    int32_t x; // 交点右侧第一个像素
+    int winding;
+};
+
+struct OH_Drawing_Canvas {
+    OH_Drawing_Bitmap *bitmap = nullptr;
+    ClipBounds clip;
+    std::vector<ClipBounds> saved;
+    const OH_Drawing_Pen *pen = nullptr;
+    const OH_Drawing_Brush *brush = nullptr;
+    // 每次绘制复用的临时缓冲
+    std::vector<PathEdge> edges;
+    std::vector<SpanCrossing> crossings;
+    std::vector<float> coverage;
+};
+
+// 0xAARRGGBB -> premultiplied RGBA (0 ~ 1)
+struct PremulColor {
+    float r, g, b, a;
+};
+
+static PremulColor ToPremul(uint32_t argb) {
+    float a = static_cast<float>((argb >> 24) & 0xFF) / 255.0f;
+    float r = static_cast<float>((argb >> 16) & 0xFF) / 255.0f;
+    float g = static_cast<float>((argb >> 8) & 0xFF) / 255.0f;
+    float b = static_cast<float>(argb & 0xFF) / 255.0f;
+    return { r * a, g * a, b * a, a };
+}
+
+static uint8_t ToByte(float v) {
+    return static_cast<uint8_t>(std::min(std::max(v, 0.0f), 1.0f) * 255.0f + 0.5f);
+}
+
+// src-over 混合一个像素，coverage 为 0 ~ 1
+static void BlendPixel(uint8_t *dst, const PremulColor &src, float coverage) {
+    float sa = src.a * coverage;
+    float inv = 1.0f - sa;
+    dst[0] = ToByte(src.r * coverage + dst[0] / 255.0f * inv);
+    dst[1] = ToByte(src.g * coverage + dst[1] / 255.0f * inv);
+    dst[2] = ToByte(src.b * coverage + dst[2] / 255.0f * inv);
+    dst[3] = ToByte(sa + dst[3] / 255.0f * inv);
+}
+
+// 线性渐变在 (x, y) 处的颜色 (CLAMP，未预乘插值后再预乘)
+static PremulColor ShadeLinear(const OH_Drawing_ShaderEffect *shader, float x, float y) {
+    float dx = shader->end.x - shader->start.x;
+    float dy = shader->end.y - shader->start.y;
+    float lengthSq = dx * dx + dy * dy;
+    float t = lengthSq > 0 ? ((x - shader->start.x) * dx + (y - shader->start.y) * dy) / lengthSq : 0.0f;
+    t = std::min(std::max(t, 0.0f), 1.0f);
+
+    const std::vector<uint32_t> &colors = shader->colors;
+    const std::vector<float> &pos = shader->pos;
+    if (t <= pos.front()) return ToPremul(colors.front());
+    if (t >= pos.back()) return ToPremul(colors.back());
+    size_t i = 1;
+    while (i + 1 < pos.size() && t > pos[i]) i++;
+    float span = pos[i] - pos[i - 1];
+    float f = span > 0 ? (t - pos[i - 1]) / span : 0.0f;
+    float channels[4];
+    for (int c = 0; c < 4; c++) {
+        int shift = 24 - c * 8;
+        float a = static_cast<float>((colors[i - 1] >> shift) & 0xFF);
+        float b = static_cast<float>((colors[i] >> shift) & 0xFF);
+        channels[c] = (a + (b - a) * f) / 255.0f;
+    }
+    return { channels[1] * channels[0], channels[2] * channels[0], channels[3] * channels[0], channels[0] };
+}
+
+// 像素中心落在 [edge, ...) 内的第一个像素
+static int32_t PixelEdge(float v) {
+    return static_cast<int32_t>(std::ceil(v - 0.5f));
+}
+
+static uint8_t *PixelAt(OH_Drawing_Bitmap *bitmap, int32_t x, int32_t y) {
+    return bitmap->pixels + static_cast<size_t>(y) * bitmap->rowBytes + static_cast<size_t>(x) * 4;
+}
+
+// 用画刷颜色 (或渐变) 填充一行中的 [x0, x1)
+static void FillSpan(OH_Drawing_Canvas *canvas, const OH_Drawing_Brush *brush, int32_t y, int32_t x0, int32_t x1) {
+    x0 = std::max(x0, canvas->clip.left);
+    x1 = std::min(x1, canvas->clip.right);
+    if (x0 >= x1) return;
+    uint8_t *dst = PixelAt(canvas->bitmap, x0, y);
+    if (brush->shader == nullptr) {
+        PremulColor color = ToPremul(brush->color);
+        for (int32_t x = x0; x < x1; x++, dst += 4) BlendPixel(dst, color, 1.0f);
+        return;
+    }
+    for (int32_t x = x0; x < x1; x++, dst += 4) {
+        BlendPixel(dst, ShadeLinear(brush->shader, x + 0.5f, y + 0.5f), 1.0f);
+    }
+}
+
+// 收集路径的全部边 (填充时每个轮廓隐式闭合)
+static void CollectEdges(const OH_Drawing_Path *path, bool closeAll, std::vector<PathEdge> *edges) {
+    edges->clear();
+    for (const PathContour &contour : path->contours) {
+        for (size_t i = contour.begin + 1; i < contour.end; i++) {
+            const OH_Drawing_Point &a = path->points[i - 1];
+            const OH_Drawing_Point &b = path->points[i];
+            edges->push_back({ a.x, a.y, b.x, b.y });
+        }
+        if ((closeAll || contour.closed) && contour.end - contour.begin > 1) {
+            const OH_Drawing_Point &a = path->points[contour.end - 1];
+            const OH_Drawing_Point &b = path->points[contour.begin];
+            edges->push_back({ a.x, a.y, b.x, b.y });
+        }
+    }
+}
+
+static void FillEdges(OH_Drawing_Canvas *canvas, const OH_Drawing_Brush *brush) {
+    const std::vector<PathEdge> &edges = canvas->edges;
+    if (edges.empty()) return;
+    float minY = edges[0].y0;
+    float maxY = edges[0].y0;
+    for (const PathEdge &e : edges) {
+        minY = std::min(minY, std::min(e.y0, e.y1));
+        maxY = std::max(maxY, std::max(e.y0, e.y1));
+    }
+    int32_t top = std::max(PixelEdge(minY), canvas->clip.top);
+    int32_t bottom = std::min(PixelEdge(maxY), canvas->clip.bottom);
+
+    std::vector<SpanCrossing> &crossings = canvas->crossings;
+    for (int32_t y = top; y < bottom; y++) {
+        float sy = y + 0.5f;
+        crossings.clear();
+        for (const PathEdge &e : edges) {
+            if (e.y0 == e.y1) continue;
+            bool down = e.y1 > e.y0;
+            float ya = down ? e.y0 : e.y1;
+            float yb = down ? e.y1 : e.y0;
+            if (sy < ya || sy >= yb) continue;
+            // 整数部分单独处理：整体平移整数像素后交点也严格平移 (增量滚动与整帧重画逐像素一致)
+            float base = std::floor(e.x0);
+            float offset = (e.x0 - base) + (sy - e.y0) * (e.x1 - e.x0) / (e.y1 - e.y0);
+            crossings.push_back({ static_cast<int32_t>(base) + PixelEdge(offset), down ? 1 : -1 });
+        }
+        std::sort(crossings.begin(), crossings.end(),
+                  [](const SpanCrossing &a, const SpanCrossing &b) { return a.x < b.x; });
+        int winding = 0;
+        for (size_t i = 0; i + 1 < crossings.size(); i++) {
+            winding += crossings[i].winding;
+            if (winding != 0) {
+                FillSpan(canvas, brush, y, crossings[i].x, crossings[i + 1].x);
+            }
+        }
+    }
+}
+
+// 点到线段的距离 (全部以相对 (px, py) 的坐标计算，整体平移整数像素时结果严格不变)
+static float SegmentDistance(float px, float py, const PathEdge &e) {
+    float ax = e.x0 - px;
+    float ay = e.y0 - py;
+    float dx = e.x1 - e.x0;
+    float dy = e.y1 - e.y0;
+    float lengthSq = dx * dx + dy * dy;
+    float t = lengthSq > 0 ? -(ax * dx + ay * dy) / lengthSq : 0.0f;
+    t = std::min(std::max(t, 0.0f), 1.0f);
+    float cx = ax + t * dx;
+    float cy = ay + t * dy;
+    return std::sqrt(cx * cx + cy * cy);
+}
+
+// 圆头圆角描边：覆盖率取各线段胶囊体的并集 (最大值)，整条路径只混合一次，重叠处不会加深
+static void StrokeEdges(OH_Drawing_Canvas *canvas, const OH_Drawing_Pen *pen) {
+    const std::vector<PathEdge> &edges = canvas->edges;
+    if (edges.empty()) return;
+    float radius = std::max(pen->width, 1.0f) / 2;
+    float reach = radius + 1.0f;
+    float minX = edges[0].x0, maxX = edges[0].x0, minY = edges[0].y0, maxY = edges[0].y0;
+    for (const PathEdge &e : edges) {
+        minX = std::min(minX, std::min(e.x0, e.x1));
+        maxX = std::max(maxX, std::max(e.x0, e.x1));
+        minY = std::min(minY, std::min(e.y0, e.y1));
+        maxY = std::max(maxY, std::max(e.y0, e.y1));
+    }
+    const ClipBounds &clip = canvas->clip;
+    int32_t left = std::max(static_cast<int32_t>(std::floor(minX - reach)), clip.left);
+    int32_t right = std::min(static_cast<int32_t>(std::ceil(maxX + reach)), clip.right);
+    int32_t top = std::max(static_cast<int32_t>(std::floor(minY - reach)), clip.top);
+    int32_t bottom = std::min(static_cast<int32_t>(std::ceil(maxY + reach)), clip.bottom);
+    if (left >= right || top >= bottom) return;
+
+    int32_t maskWidth = right - left;
+    std::vector<float> &coverage = canvas->coverage;
+    coverage.assign(static_cast<size_t>(maskWidth) * (bottom - top), 0.0f);
+    for (const PathEdge &e : edges) {
+        int32_t x0 = std::max(static_cast<int32_t>(std::floor(std::min(e.x0, e.x1) - reach)), left);
+        int32_t x1 = std::min(static_cast<int32_t>(std::ceil(std::max(e.x0, e.x1) + reach)), right);
+        int32_t y0 = std::max(static_cast<int32_t>(std::floor(std::min(e.y0, e.y1) - reach)), top);
+        int32_t y1 = std::min(static_cast<int32_t>(std::ceil(std::max(e.y0, e.y1) + reach)), bottom);
+        for (int32_t y = y0; y < y1; y++) {
+            float *row = coverage.data() + static_cast<size_t>(y - top) * maskWidth;
+            for (int32_t x = x0; x < x1; x++) {
+                float d = SegmentDistance(x + 0.5f, y + 0.5f, e);
+                float c = pen->antiAlias ? std::min(std::max(radius + 0.5f - d, 0.0f), 1.0f) : (d <= radius ? 1.0f : 0.0f);
+                row[x - left] = std::max(row[x - left], c);
+            }
+        }
+    }
+
+    PremulColor color = ToPremul(pen->color);
+    for (int32_t y = top; y < bottom; y++) {
+        const float *row = coverage.data() + static_cast<size_t>(y - top) * maskWidth;
+        uint8_t *dst = PixelAt(canvas->bitmap, left, y);
+        for (int32_t x = 0; x < maskWidth; x++, dst += 4) {
+            if (row[x] > 0) BlendPixel(dst, color, row[x]);
+        }
+    }
+}
+
+static bool CanDraw(const OH_Drawing_Canvas *canvas) {
+    return canvas != nullptr && canvas->bitmap != nullptr && canvas->bitmap->pixels != nullptr &&
+        !canvas->clip.Empty();
+}
+
+// ---------- Bitmap ----------
+
+OH_Drawing_Bitmap *OH_Drawing_BitmapCreate(void) {
+    return new OH_Drawing_Bitmap();
+}
+
+void OH_Drawing_BitmapDestroy(OH_Drawing_Bitmap *bitmap) {
+    delete bitmap;
+}
+
+OH_Drawing_Bitmap *OH_Drawing_BitmapCreateFromPixels(OH_Drawing_Image_Info *info, void *pixels, uint32_t rowBytes) {
+    if (info == nullptr || pixels == nullptr || info->colorType != COLOR_FORMAT_RGBA_8888 || info->width <= 0 ||
+        info->height <= 0 || rowBytes < static_cast<uint32_t>(info->width) * 4) {
+        return nullptr;
+    }
+    auto *bitmap = new OH_Drawing_Bitmap();
+    bitmap->width = static_cast<uint32_t>(info->width);
+    bitmap->height = static_cast<uint32_t>(info->height);
+    bitmap->rowBytes = rowBytes;
+    bitmap->pixels = static_cast<uint8_t *>(pixels);
+    return bitmap;
+}
+
+// 替身的像素格式固定为预乘 RGBA_8888 (渲染器只用这一种)，format 不参与
+void OH_Drawing_BitmapBuild(OH_Drawing_Bitmap *bitmap, const uint32_t width, const uint32_t height,
+                            [[maybe_unused]] const OH_Drawing_BitmapFormat *format) {
+    if (bitmap == nullptr) return;
+    bitmap->width = width;
+    bitmap->height = height;
+    bitmap->rowBytes = width * 4;
+    bitmap->storage.assign(static_cast<size_t>(bitmap->rowBytes) * height, 0);
+    bitmap->pixels = bitmap->storage.empty() ? nullptr : bitmap->storage.data();
+}
+
+uint32_t OH_Drawing_BitmapGetWidth(OH_Drawing_Bitmap *bitmap) {
+    return bitmap != nullptr ? bitmap->width : 0;
+}
+
+uint32_t OH_Drawing_BitmapGetHeight(OH_Drawing_Bitmap *bitmap) {
+    return bitmap != nullptr ? bitmap->height : 0;
+}
+
+void *OH_Drawing_BitmapGetPixels(OH_Drawing_Bitmap *bitmap) {
+    return bitmap != nullptr ? bitmap->pixels : nullptr;
+}
+
+// ---------- Point / Rect ----------
+
+OH_Drawing_Point *OH_Drawing_PointCreate(float x, float y) {
+    auto *point = new OH_Drawing_Point();
+    point->x = x;
+    point->y = y;
+    return point;
+}
+
+void OH_Drawing_PointDestroy(OH_Drawing_Point *point) {
+    delete point;
+}
+
+OH_Drawing_Rect *OH_Drawing_RectCreate(float left, float top, float right, float bottom) {
+    auto *rect = new OH_Drawing_Rect();
+    rect->left = left;
+    rect->top = top;
+    rect->right = right;
+    rect->bottom = bottom;
+    return rect;
+}
+
+void OH_Drawing_RectDestroy(OH_Drawing_Rect *rect) {
+    delete rect;
+}
+
+// ---------- Shader / Brush / Pen ----------
+
+// pos 为空时颜色均匀分布；非空时须在 [0, 1] 内单调不减，否则与参数缺失一样返回 nullptr
+// 平铺方式只实现 CLAMP (见头文件)，tileMode 不参与
+OH_Drawing_ShaderEffect *OH_Drawing_ShaderEffectCreateLinearGradient(const OH_Drawing_Point *startPt,
+    const OH_Drawing_Point *endPt, const uint32_t *colors, const float *pos, uint32_t size,
+    [[maybe_unused]] OH_Drawing_TileMode tileMode) {
+    if (startPt == nullptr || endPt == nullptr || colors == nullptr || size < 2) {
+        return nullptr;
+    }
+    for (uint32_t i = 0; pos != nullptr && i < size; i++) {
+        if (!(pos[i] >= 0.0f && pos[i] <= 1.0f) || (i > 0 && pos[i] < pos[i - 1])) {
+            return nullptr;
+        }
+    }
+    auto *shader = new OH_Drawing_ShaderEffect();
+    shader->start = *startPt;
+    shader->end = *endPt;
+    shader->colors.assign(colors, colors + size);
+    for (uint32_t i = 0; i < size; i++) {
+        shader->pos.push_back(pos != nullptr ? pos[i] : static_cast<float>(i) / (size - 1));
+    }
+    return shader;
+}
+
+void OH_Drawing_ShaderEffectDestroy(OH_Drawing_ShaderEffect *shaderEffect) {
+    delete shaderEffect;
+}
+
+OH_Drawing_Brush *OH_Drawing_BrushCreate(void) {
+    return new OH_Drawing_Brush();
+}
+
+void OH_Drawing_BrushDestroy(OH_Drawing_Brush *brush) {
+    delete brush;
+}
+
+void OH_Drawing_BrushSetAntiAlias(OH_Drawing_Brush *brush, bool antiAlias) {
+    if (brush != nullptr) brush->antiAlias = antiAlias;
+}
+
+void OH_Drawing_BrushSetColor(OH_Drawing_Brush *brush, uint32_t color) {
+    if (brush != nullptr) brush->color = color;
+}
+
+void OH_Drawing_BrushSetShaderEffect(OH_Drawing_Brush *brush, OH_Drawing_ShaderEffect *shaderEffect) {
+    if (brush != nullptr) brush->shader = shaderEffect;
+}
+
+OH_Drawing_Pen *OH_Drawing_PenCreate(void) {
+    return new OH_Drawing_Pen();
+}
+
+void OH_Drawing_PenDestroy(OH_Drawing_Pen *pen) {
+    delete pen;
+}
+
+void OH_Drawing_PenSetAntiAlias(OH_Drawing_Pen *pen, bool antiAlias) {
+    if (pen != nullptr) pen->antiAlias = antiAlias;
+}
+
+void OH_Drawing_PenSetColor(OH_Drawing_Pen *pen, uint32_t color) {
+    if (pen != nullptr) pen->color = color;
+}
+
+void OH_Drawing_PenSetWidth(OH_Drawing_Pen *pen, float width) {
+    if (pen != nullptr) pen->width = width;
+}
+
+void OH_Drawing_PenSetCap(OH_Drawing_Pen *pen, OH_Drawing_PenLineCapStyle capStyle) {
+    if (pen != nullptr) pen->cap = capStyle;
+}
+
+void OH_Drawing_PenSetJoin(OH_Drawing_Pen *pen, OH_Drawing_PenLineJoinStyle joinStyle) {
+    if (pen != nullptr) pen->join = joinStyle;
+}
+
+// ---------- Path ----------
+
+OH_Drawing_Path *OH_Drawing_PathCreate(void) {
+    return new OH_Drawing_Path();
+}
+
+void OH_Drawing_PathDestroy(OH_Drawing_Path *path) {
+    delete path;
+}
+
+void OH_Drawing_PathMoveTo(OH_Drawing_Path *path, float x, float y) {
+    if (path == nullptr) return;
+    // 连续的 MoveTo 只保留最后一个
+    if (!path->contours.empty() && path->contours.back().end - path->contours.back().begin == 1) {
+        path->points.back() = { x, y };
+        return;
+    }
+    path->points.push_back({ x, y });
+    path->contours.push_back({ path->points.size() - 1, path->points.size(), false });
+}
+
+void OH_Drawing_PathLineTo(OH_Drawing_Path *path, float x, float y) {
+    if (path == nullptr) return;
+    if (path->contours.empty() || path->contours.back().closed) {
+        // 没有起点时从 (0, 0) 开始；闭合后从上一个轮廓的起点继续
+        OH_Drawing_Point start = path->contours.empty() ? OH_Drawing_Point() :
+            path->points[path->contours.back().begin];
+        path->points.push_back(start);
+        path->contours.push_back({ path->points.size() - 1, path->points.size(), false });
+    }
+    path->points.push_back({ x, y });
+    path->contours.back().end = path->points.size();
+}
+
+void OH_Drawing_PathClose(OH_Drawing_Path *path) {
+    if (path != nullptr && !path->contours.empty()) {
+        path->contours.back().closed = true;
+    }
+}
+
+void OH_Drawing_PathReset(OH_Drawing_Path *path) {
+    if (path == nullptr) return;
+    path->points.clear();
+    path->contours.clear();
+}
+
+// ---------- Canvas ----------
+
+OH_Drawing_Canvas *OH_Drawing_CanvasCreate(void) {
+    return new OH_Drawing_Canvas();
+}
+
+void OH_Drawing_CanvasDestroy(OH_Drawing_Canvas *canvas) {
+    delete canvas;
+}
+
+void OH_Drawing_CanvasBind(OH_Drawing_Canvas *canvas, OH_Drawing_Bitmap *bitmap) {
+    if (canvas == nullptr) return;
+    canvas->bitmap = bitmap;
+    canvas->saved.clear();
+    canvas->clip = ClipBounds();
+    if (bitmap != nullptr) {
+        canvas->clip.right = static_cast<int32_t>(bitmap->width);
+        canvas->clip.bottom = static_cast<int32_t>(bitmap->height);
+    }
+}
+
+void OH_Drawing_CanvasAttachPen(OH_Drawing_Canvas *canvas, const OH_Drawing_Pen *pen) {
+    if (canvas != nullptr) canvas->pen = pen;
+}
+
+void OH_Drawing_CanvasDetachPen(OH_Drawing_Canvas *canvas) {
+    if (canvas != nullptr) canvas->pen = nullptr;
+}
+
+void OH_Drawing_CanvasAttachBrush(OH_Drawing_Canvas *canvas, const OH_Drawing_Brush *brush) {
+    if (canvas != nullptr) canvas->brush = brush;
+}
+
+void OH_Drawing_CanvasDetachBrush(OH_Drawing_Canvas *canvas) {
+    if (canvas != nullptr) canvas->brush = nullptr;
+}
+
+void OH_Drawing_CanvasSave(OH_Drawing_Canvas *canvas) {
+    if (canvas != nullptr) canvas->saved.push_back(canvas->clip);
+}
+
+void OH_Drawing_CanvasRestore(OH_Drawing_Canvas *canvas) {
+    if (canvas == nullptr || canvas->saved.empty()) return;
+    canvas->clip = canvas->saved.back();
+    canvas->saved.pop_back();
+}
+
+// 裁剪边界取整到像素边缘，doAntiAlias 不参与
+void OH_Drawing_CanvasClipRect(OH_Drawing_Canvas *canvas, const OH_Drawing_Rect *rect, OH_Drawing_CanvasClipOp clipOp,
+                               [[maybe_unused]] bool doAntiAlias) {
+    if (canvas == nullptr || rect == nullptr || clipOp != INTERSECT) return;
+    ClipBounds &clip = canvas->clip;
+    clip.left = std::max(clip.left, PixelEdge(rect->left));
+    clip.top = std::max(clip.top, PixelEdge(rect->top));
+    clip.right = std::min(clip.right, PixelEdge(rect->right));
+    clip.bottom = std::min(clip.bottom, PixelEdge(rect->bottom));
+}
+
+void OH_Drawing_CanvasDrawPath(OH_Drawing_Canvas *canvas, const OH_Drawing_Path *path) {
+    if (!CanDraw(canvas) || path == nullptr) return;
+    if (canvas->brush != nullptr) {
+        CollectEdges(path, true, &canvas->edges);
+        FillEdges(canvas, canvas->brush);
+    }
+    if (canvas->pen != nullptr) {
+        CollectEdges(path, false, &canvas->edges);
+        StrokeEdges(canvas, canvas->pen);
+    }
+}
+
+void OH_Drawing_CanvasDrawRect(OH_Drawing_Canvas *canvas, const OH_Drawing_Rect *rect) {
+    if (!CanDraw(canvas) || rect == nullptr) return;
+    if (canvas->brush != nullptr) {
+        int32_t top = std::max(PixelEdge(rect->top), canvas->clip.top);
+        int32_t bottom = std::min(PixelEdge(rect->bottom), canvas->clip.bottom);
+        for (int32_t y = top; y < bottom; y++) {
+            FillSpan(canvas, canvas->brush, y, PixelEdge(rect->left), PixelEdge(rect->right));
+        }
+    }
+    if (canvas->pen != nullptr) {
+        canvas->edges.assign({ { rect->left, rect->top, rect->right, rect->top },
+                               { rect->right, rect->top, rect->right, rect->bottom },
+                               { rect->right, rect->bottom, rect->left, rect->bottom },
+                               { rect->left, rect->bottom, rect->left, rect->top } });
+        StrokeEdges(canvas, canvas->pen);
+    }
+}
+
+void OH_Drawing_CanvasClear(OH_Drawing_Canvas *canvas, uint32_t color) {
+    if (!CanDraw(canvas)) return;
+    PremulColor premul = ToPremul(color);
+    uint8_t bytes[4] = { ToByte(premul.r), ToByte(premul.g), ToByte(premul.b), ToByte(premul.a) };
+    for (int32_t y = canvas->clip.top; y < canvas->clip.bottom; y++) {
+        uint8_t *dst = PixelAt(canvas->bitmap, canvas->clip.left, y);
+        for (int32_t x = canvas->clip.left; x < canvas->clip.right; x++, dst += 4) {
+            dst[0] = bytes[0];
+            dst[1] = bytes[1];
+            dst[2] = bytes[2];
+            dst[3] = bytes[3];
+        }
+    }
+}
@@ -0,0 +1,483 @@
+// 原生 HTTP 下载测速：非阻塞连接 + epoll 接收，正文原地丢弃，只把字节数送入分析器
+#include "http_download.h"
+#include "clock_source.h"
+#include "traffic_trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static constexpr int MAX_READS_PER_WAKE = 16;         // 每次唤醒最多读几次，保证上报与停止检查及时
+static constexpr uint32_t WAKE_EVENT = UINT32_MAX;     // epoll 事件里 eventfd 的标记 (其余为流下标)
+
+static std::string BuildRequest(const HttpUrl &url) {
+    // 不接受压缩编码，保证计入的是真实传输的正文；Connection: close 让服务端发完即断开
+    return "GET " + url.path + " HTTP/1.1\r\n"
+           "Host: " + HostHeader(url) + "\r\n"
+           "User-Agent: NetGuardian\r\n"
+           "Accept: */*\r\n"
+           "Accept-Encoding: identity\r\n"
+           "Cache-Control: no-cache, no-store, must-revalidate\r\n"
+           "Connection: close\r\n\r\n";
+}
+
+// 一条 HTTP 连接的接收状态
+struct HttpConnection {
+    enum State { CONNECTING, SENDING, HEADERS, BODY };
+    int fd = -1;
+    uint32_t index = 0; // 在本次测量中的流下标 (epoll 事件数据)
+    State state = CONNECTING;
+    std::string request;
+    size_t requestSent = 0;
+    std::string header;   // 响应头 (到空行为止)
+    int httpStatus = 0;
+    int64_t contentLength = -1;
+    uint64_t bodyBytes = 0;
+    int recvFlags = MSG_TRUNC; // 正文由内核直接丢弃；不支持时退回普通 recv
+};
+
+// 连接事件的处理结果
+enum ConnectionEvent {
+    CONNECTION_PENDING = 0, // 继续等待
+    CONNECTION_COMPLETE,    // 正文接收完毕 (或服务端在长度未知时断开)
+    CONNECTION_FAILED,
+};
+
+// 连接建立后发送请求；发完之后改为等待可读
+static ConnectionEvent SendRequest(HttpConnection *conn, int epollFd, std::string *error) {
+    while (conn->requestSent < conn->request.size()) {
+        ssize_t n = send(conn->fd, conn->request.data() + conn->requestSent, conn->request.size() - conn->requestSent,
+                         MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return CONNECTION_PENDING;
+            *error = std::string("send: ") + std::strerror(errno);
+            return CONNECTION_FAILED;
+        }
+        conn->requestSent += static_cast<size_t>(n);
+    }
+    epoll_event event = {};
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.u32 = conn->index;
+    epoll_ctl(epollFd, EPOLL_CTL_MOD, conn->fd, &event);
+    conn->state = HttpConnection::HEADERS;
+    return CONNECTION_PENDING;
+}
+
+// 收到的响应头数据：找到空行后解析，空行之后的部分计为正文 (通过 *bodyBytes 返回)
+static ConnectionEvent ConsumeHeader(HttpConnection *conn, const char *data, size_t length, size_t *bodyBytes,
+                                     std::string *error) {
+    size_t searchFrom = conn->header.size() >= 3 ? conn->header.size() - 3 : 0;
+    conn->header.append(data, length);
+    size_t end = conn->header.find("\r\n\r\n", searchFrom);
+    if (end == std::string::npos) {
+        if (conn->header.size() > MAX_HEADER_BYTES) {
+            *error = "Response header too large";
+            return CONNECTION_FAILED;
+        }
+        return CONNECTION_PENDING;
+    }
+    *bodyBytes = conn->header.size() - (end + 4);
+    conn->header.resize(end + 2);
+    if (!ParseResponseHeader(conn->header, &conn->httpStatus, &conn->contentLength)) {
+        *error = "Malformed HTTP response";
+        return CONNECTION_FAILED;
+    }
+    if (conn->httpStatus < 200 || conn->httpStatus >= 300) {
+        *error = "HTTP status " + std::to_string(conn->httpStatus);
+        return CONNECTION_FAILED;
+    }
+    conn->state = HttpConnection::BODY;
+    return CONNECTION_PENDING;
+}
+
+// 读出当前可读的全部数据 (最多 MAX_READS_PER_WAKE 次)，正文字节数累加到 *received
+static ConnectionEvent ReadAvailable(HttpConnection *conn, std::vector<char> *buffer, uint64_t *received,
+                                     std::string *error) {
+    for (int reads = 0; reads < MAX_READS_PER_WAKE; reads++) {
+        size_t want = buffer->size();
+        bool inBody = conn->state == HttpConnection::BODY;
+        if (inBody && conn->contentLength >= 0) {
+            uint64_t remaining = static_cast<uint64_t>(conn->contentLength) - conn->bodyBytes;
+            want = static_cast<size_t>(std::min<uint64_t>(want, remaining));
+            if (want == 0) return CONNECTION_COMPLETE;
+        }
+        ssize_t n = recv(conn->fd, buffer->data(), want, inBody ? conn->recvFlags : 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return CONNECTION_PENDING;
+            if (inBody && conn->recvFlags != 0 && (errno == EINVAL || errno == EOPNOTSUPP)) {
+                conn->recvFlags = 0;
+                continue;
+            }
+            *error = std::string("recv: ") + std::strerror(errno);
+            return CONNECTION_FAILED;
+        }
+        if (n == 0) {
+            if (!inBody) {
+                *error = "Connection closed before the response header";
+                return CONNECTION_FAILED;
+            }
+            if (conn->contentLength >= 0 && conn->bodyBytes < static_cast<uint64_t>(conn->contentLength)) {
+                *error = "Connection closed before the end of the body";
+                return CONNECTION_FAILED;
+            }
+            return CONNECTION_COMPLETE;
+        }
+
+        size_t bodyBytes = static_cast<size_t>(n);
+        if (!inBody) {
+            bodyBytes = 0;
+            ConnectionEvent event = ConsumeHeader(conn, buffer->data(), static_cast<size_t>(n), &bodyBytes, error);
+            if (event != CONNECTION_PENDING) return event;
+        }
+        conn->bodyBytes += bodyBytes;
+        *received += bodyBytes;
+        if (conn->state == HttpConnection::BODY && conn->contentLength >= 0 &&
+            conn->bodyBytes >= static_cast<uint64_t>(conn->contentLength)) {
+            return CONNECTION_COMPLETE;
+        }
+    }
+    return CONNECTION_PENDING;
+}
+
+// 处理连接上的一个 epoll 事件
+static ConnectionEvent HandleConnectionEvent(HttpConnection *conn, uint32_t events, int epollFd,
+                                             std::vector<char> *buffer, uint64_t *received, std::string *error) {
+    if (conn->state == HttpConnection::CONNECTING) {
+        if (!CheckConnected(conn->fd, error)) {
+            return CONNECTION_FAILED;
+        }
+        if ((events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) == 0) {
+            return CONNECTION_PENDING;
+        }
+        conn->state = HttpConnection::SENDING;
+    }
+    if (conn->state == HttpConnection::SENDING) {
+        return SendRequest(conn, epollFd, error);
+    }
+    return ReadAvailable(conn, buffer, received, error);
+}
+
+HttpDownloadEngine::HttpDownloadEngine() {
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+HttpDownloadEngine::~HttpDownloadEngine() {
+    Stop();
+    Join();
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+    }
+}
+
+bool HttpDownloadEngine::Start(const DownloadOptions &options, ReportCallback onReport, FinishCallback onFinish) {
+    if (Running()) {
+        return false;
+    }
+    Join(); // 回收上一次测量已经结束的线程
+    stopRequested_.store(false, std::memory_order_release);
+    uint64_t pending = 0;
+    if (wakeFd_ >= 0 && read(wakeFd_, &pending, sizeof(pending)) < 0) {
+        pending = 0; // 没有遗留的唤醒
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&HttpDownloadEngine::ThreadMain, this, options, std::move(onReport), std::move(onFinish));
+    return true;
+}
+
+void HttpDownloadEngine::Stop() {
+    stopRequested_.store(true, std::memory_order_release);
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        if (write(wakeFd_, &one, sizeof(one)) < 0) {
+            one = 0; // 计数器已满也会被唤醒
+        }
+    }
+}
+
+void HttpDownloadEngine::Join() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void HttpDownloadEngine::ThreadMain(DownloadOptions options, ReportCallback onReport, FinishCallback onFinish) {
+    result_ = Run(options, onReport);
+    DownloadResult result = result_;
+    running_.store(false, std::memory_order_release);
+    if (onFinish) {
+        onFinish(result);
+    }
+}
+
+void AssessStreams(DownloadReport *report) {
+    report->fairness = 1.0;
+    report->stragglers = 0;
+    double rates[MAX_DOWNLOAD_STREAMS];
+    size_t rated = 0;
+    double sum = 0;
+    double sumSq = 0;
+    for (StreamReport &stream : report->streams) {
+        stream.straggler = false;
+        if (!stream.stats.valid || rated == MAX_DOWNLOAD_STREAMS) continue;
+        double rate = stream.stats.avgKbps;
+        rates[rated++] = rate;
+        sum += rate;
+        sumSq += rate * rate;
+    }
+    if (rated < 2 || sumSq <= 0) {
+        return;
+    }
+    // Jain 公平性指数：(Σx)² / (n·Σx²)
+    report->fairness = sum * sum / (static_cast<double>(rated) * sumSq);
+
+    std::sort(rates, rates + rated);
+    double median = rated % 2 == 1 ? rates[rated / 2] : (rates[rated / 2 - 1] + rates[rated / 2]) / 2;
+    for (StreamReport &stream : report->streams) {
+        if (stream.stats.valid && stream.stats.avgKbps < median * STRAGGLER_RATIO) {
+            stream.straggler = true;
+            report->stragglers++;
+        }
+    }
+}
+
+// 并行测量中的一路连接：连接状态 + 该流独立的分析器
+struct DownloadStream {
+    HttpConnection conn;
+    TrafficAnalyzer analyzer;
+    StreamState state = STREAM_CONNECTING;
+    uint64_t pending = 0; // 本次唤醒读到、尚未送入分析器的正文字节
+    TcpMetrics tcp;       // 最近一次采样的 TCP 指标，连接关闭后保留最后的值
+};
+
+// 采样各条已连接流的 TCP_INFO，送入各流的分析器，合并后送入聚合分析器
+static void SampleStreams(std::vector<DownloadStream> *streams, TrafficAnalyzer *aggregate) {
+    TcpMetrics total;
+    for (DownloadStream &stream : *streams) {
+        if (stream.conn.fd >= 0 && stream.state != STREAM_CONNECTING && SampleTcpMetrics(stream.conn.fd, &stream.tcp)) {
+            stream.analyzer.SetTcpMetrics(stream.tcp);
+        }
+        MergeTcpMetrics(&total, stream.tcp);
+    }
+    aggregate->SetTcpMetrics(total);
+}
+
+// 结束一路连接 (完成或出错)，出错时只保留第一条流的错误说明
+static void EndStream(DownloadStream *stream, StreamState state, int epollFd, std::string *firstError,
+                      const std::string &error) {
+    if (stream->conn.fd >= 0) {
+        if (stream->state != STREAM_CONNECTING && SampleTcpMetrics(stream->conn.fd, &stream->tcp)) {
+            stream->analyzer.SetTcpMetrics(stream->tcp); // 关闭前留下这条连接最后的指标
+        }
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, stream->conn.fd, nullptr);
+        close(stream->conn.fd);
+        stream->conn.fd = -1;
+    }
+    stream->state = state;
+    if (state == STREAM_FAILED && firstError->empty()) {
+        *firstError = error;
+    }
+}
+
+static DownloadReport BuildReport(const TrafficAnalyzer &aggregate, const std::vector<DownloadStream> &streams,
+                                  int64_t elapsedUs) {
+    DownloadReport report;
+    report.stats = aggregate.Current();
+    report.elapsedUs = elapsedUs;
+    report.contentLength = streams.empty() ? -1 : 0;
+    report.streams.resize(streams.size());
+    for (size_t i = 0; i < streams.size(); i++) {
+        const DownloadStream &stream = streams[i];
+        StreamReport &out = report.streams[i];
+        out.state = stream.state;
+        out.httpStatus = stream.conn.httpStatus;
+        out.bytes = stream.conn.bodyBytes;
+        out.stats = stream.analyzer.Current();
+        report.bytes += stream.conn.bodyBytes;
+        if (stream.conn.contentLength < 0 || report.contentLength < 0) {
+            report.contentLength = -1;
+        } else {
+            report.contentLength += stream.conn.contentLength;
+        }
+    }
+    AssessStreams(&report);
+    return report;
+}
+
+DownloadResult HttpDownloadEngine::Run(const DownloadOptions &options, const ReportCallback &onReport) {
+    DownloadResult result;
+    ClockSource *clock = ClockSource::Steady();
+    int64_t startUs = clock->NowUs();
+    analyzer_.SetConvergenceConfig(options.convergence);
+    analyzer_.Reset();
+    buffer_.resize(std::max<size_t>(options.bufferSize, 4096));
+
+    TraceWriter traceWriter;
+    if (!options.tracePath.empty() && traceWriter.Open(options.tracePath)) {
+        analyzer_.SetTraceWriter(&traceWriter);
+    }
+
+    // 所有流对同一地址发起连接，地址只解析一次
+    std::vector<DownloadStream> streams(static_cast<size_t>(std::min(std::max(options.streams, 1),
+                                                                     MAX_DOWNLOAD_STREAMS)));
+    size_t active = 0; // 尚未结束的流
+    HttpUrl url;
+    addrinfo *addresses = nullptr;
+    int epollFd = -1;
+    if (!ParseHttpUrl(options.url, &url)) {
+        result.error = "Invalid http:// URL";
+    } else if ((epollFd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        result.error = std::string("epoll_create1: ") + std::strerror(errno);
+    } else {
+        addresses = ResolveHost(url, &result.error);
+    }
+    if (addresses != nullptr) {
+        std::string request = BuildRequest(url);
+        epoll_event event = {};
+        for (size_t i = 0; i < streams.size(); i++) {
+            HttpConnection &conn = streams[i].conn;
+            std::string error;
+            conn.index = static_cast<uint32_t>(i);
+            conn.request = request;
+            conn.fd = ConnectNonBlocking(addresses, &error);
+            if (conn.fd < 0) {
+                EndStream(&streams[i], STREAM_FAILED, epollFd, &result.error, error);
+                continue;
+            }
+            event.events = EPOLLOUT;
+            event.data.u32 = conn.index;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, conn.fd, &event);
+            active++;
+        }
+        if (wakeFd_ >= 0) {
+            event.events = EPOLLIN;
+            event.data.u32 = WAKE_EVENT;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd_, &event);
+        }
+        freeaddrinfo(addresses);
+    }
+
+    const int64_t reportIntervalUs = std::max<int64_t>(options.reportIntervalUs, 1000);
+    const int64_t connectDeadlineUs = startUs + static_cast<int64_t>(std::max(options.connectTimeoutMs, 1)) * 1000;
+    const int64_t endUs = options.durationUs > 0 ? startUs + options.durationUs : INT64_MAX;
+    int64_t nextReportUs = startUs + reportIntervalUs;
+    int64_t nowUs = startUs;
+    bool interrupted = false; // 因停止 / 时长 / 字节数 / 收敛而提前结束
+    epoll_event events[MAX_DOWNLOAD_STREAMS + 1];
+    while (active > 0) {
+        nowUs = clock->NowUs();
+        if (stopRequested_.load(std::memory_order_acquire)) {
+            result.reason = DOWNLOAD_STOPPED;
+            interrupted = true;
+            break;
+        }
+        if (nowUs >= endUs) {
+            result.reason = DOWNLOAD_DURATION;
+            interrupted = true;
+            break;
+        }
+        bool connecting = false;
+        for (DownloadStream &stream : streams) {
+            if (stream.state != STREAM_CONNECTING || stream.conn.fd < 0) continue;
+            if (nowUs >= connectDeadlineUs) {
+                EndStream(&stream, STREAM_FAILED, epollFd, &result.error, "Timed out waiting for the response");
+                active--;
+            } else {
+                connecting = true;
+            }
+        }
+        if (active == 0) {
+            break;
+        }
+        if (nowUs >= nextReportUs) {
+            SampleStreams(&streams, &analyzer_);
+            DownloadReport report = BuildReport(analyzer_, streams, nowUs - startUs);
+            if (onReport) onReport(report);
+            // 回调太慢时不补发积压的上报
+            nextReportUs = std::max(nextReportUs + reportIntervalUs, nowUs + reportIntervalUs / 2);
+        }
+
+        int64_t wakeUs = std::min(nextReportUs, endUs);
+        if (connecting) wakeUs = std::min(wakeUs, connectDeadlineUs);
+        // 上报间隔与超时由调用方决定，等待时长须限制在 epoll_wait 的 int 范围内
+        int64_t waitMs = std::min<int64_t>((wakeUs - nowUs + 999) / 1000, INT_MAX);
+        int timeoutMs = static_cast<int>(std::max<int64_t>(waitMs, 0));
+        int ready = epoll_wait(epollFd, events, MAX_DOWNLOAD_STREAMS + 1, timeoutMs);
+        if (ready < 0 && errno != EINTR) {
+            result.reason = DOWNLOAD_FAILED;
+            result.error = std::string("epoll_wait: ") + std::strerror(errno);
+            interrupted = true;
+            break;
+        }
+
+        uint64_t received = 0;
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.u32 == WAKE_EVENT) {
+                uint64_t value = 0;
+                if (read(wakeFd_, &value, sizeof(value)) < 0) value = 0;
+                continue;
+            }
+            DownloadStream &stream = streams[events[i].data.u32];
+            if (stream.conn.fd < 0) continue; // 同一批事件里已经结束
+            std::string error;
+            ConnectionEvent outcome =
+                HandleConnectionEvent(&stream.conn, events[i].events, epollFd, &buffer_, &stream.pending, &error);
+            if (stream.state == STREAM_CONNECTING && stream.conn.state == HttpConnection::BODY) {
+                stream.state = STREAM_RECEIVING;
+            }
+            if (stream.conn.httpStatus != 0 && result.httpStatus == 0) {
+                result.httpStatus = stream.conn.httpStatus;
+            }
+            if (outcome != CONNECTION_PENDING) {
+                EndStream(&stream, outcome == CONNECTION_COMPLETE ? STREAM_COMPLETED : STREAM_FAILED, epollFd,
+                          &result.error, error);
+                active--;
+            }
+            received += stream.pending;
+        }
+        if (received > 0) {
+            // 同一次唤醒读到的数据视为同时到达，各流与聚合分析器都合并成一次分析
+            nowUs = clock->NowUs();
+            for (DownloadStream &stream : streams) {
+                if (stream.pending == 0) continue;
+                stream.analyzer.ProcessAt(static_cast<size_t>(stream.pending), nowUs);
+                stream.pending = 0;
+            }
+            analyzer_.ProcessAt(static_cast<size_t>(received), nowUs);
+        }
+        if (options.stopWhenStable && analyzer_.Stable()) {
+            result.reason = DOWNLOAD_CONVERGED;
+            interrupted = true;
+            break;
+        }
+        if (options.maxBytes > 0 && analyzer_.Current().totalBytes >= static_cast<double>(options.maxBytes)) {
+            result.reason = DOWNLOAD_BYTES;
+            interrupted = true;
+            break;
+        }
+    }
+
+    if (!interrupted) {
+        // 所有流都已结束：只要有一条流完整收完正文就算完成，否则为失败
+        result.reason = DOWNLOAD_FAILED;
+        for (const DownloadStream &stream : streams) {
+            if (stream.state == STREAM_COMPLETED) result.reason = DOWNLOAD_COMPLETED;
+        }
+    }
+    SampleStreams(&streams, &analyzer_);
+    result.last = BuildReport(analyzer_, streams, clock->NowUs() - startUs);
+    if (result.reason != DOWNLOAD_FAILED) {
+        result.error.clear();
+    }
+    for (DownloadStream &stream : streams) {
+        if (stream.conn.fd >= 0) close(stream.conn.fd);
+    }
+    if (epollFd >= 0) close(epollFd);
+    analyzer_.SetTraceWriter(nullptr);
+    return result;
+}
@@ -0,0 +1,186 @@
+// 测速引擎共用的 HTTP/1.1 与非阻塞 socket 工具
+#include "http_socket.h"
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <linux/tcp.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+bool ParseHttpUrl(const std::string &url, HttpUrl *out) {
+    static const char SCHEME[] = "http://";
+    const size_t schemeLength = sizeof(SCHEME) - 1;
+    if (url.size() <= schemeLength || strncasecmp(url.c_str(), SCHEME, schemeLength) != 0) {
+        return false;
+    }
+    size_t pathStart = url.find_first_of("/?#", schemeLength);
+    std::string authority = url.substr(schemeLength, pathStart == std::string::npos ? std::string::npos
+                                                                                     : pathStart - schemeLength);
+    if (authority.empty() || authority.find('@') != std::string::npos) {
+        return false; // 不支持 user:password@
+    }
+
+    HttpUrl result;
+    size_t portStart = std::string::npos;
+    if (authority[0] == '[') {
+        // IPv6 字面量：[::1]:8080
+        size_t close = authority.find(']');
+        if (close == std::string::npos) return false;
+        result.host = authority.substr(1, close - 1);
+        if (close + 1 < authority.size()) {
+            if (authority[close + 1] != ':') return false;
+            portStart = close + 2;
+        }
+    } else {
+        size_t colon = authority.find(':');
+        result.host = authority.substr(0, colon);
+        if (colon != std::string::npos) portStart = colon + 1;
+    }
+    if (result.host.empty()) {
+        return false;
+    }
+    if (portStart != std::string::npos) {
+        size_t digits = authority.size() - portStart;
+        if (digits == 0 || digits > 5) return false;
+        uint32_t port = 0;
+        for (size_t i = portStart; i < authority.size(); i++) {
+            if (authority[i] < '0' || authority[i] > '9') return false;
+            port = port * 10 + static_cast<uint32_t>(authority[i] - '0');
+        }
+        if (port == 0 || port > 65535) return false;
+        result.port = static_cast<uint16_t>(port);
+    }
+    if (pathStart != std::string::npos) {
+        result.path = url.substr(pathStart, url.find('#', pathStart) - pathStart);
+        if (result.path.empty() || result.path[0] != '/') result.path.insert(0, "/");
+    }
+    *out = result;
+    return true;
+}
+
+std::string HostHeader(const HttpUrl &url) {
+    std::string host = url.host.find(':') != std::string::npos ? "[" + url.host + "]" : url.host;
+    return url.port == 80 ? host : host + ":" + std::to_string(url.port);
+}
+
+bool ParseResponseHeader(const std::string &header, int *status, int64_t *contentLength) {
+    if (header.compare(0, 5, "HTTP/") != 0) {
+        return false;
+    }
+    size_t space = header.find(' ');
+    if (space == std::string::npos || space + 4 > header.size()) {
+        return false;
+    }
+    int code = 0;
+    for (size_t i = space + 1; i < space + 4; i++) {
+        if (header[i] < '0' || header[i] > '9') return false;
+        code = code * 10 + (header[i] - '0');
+    }
+    *status = code;
+    *contentLength = -1;
+
+    bool chunked = false;
+    size_t lineStart = header.find("\r\n");
+    while (lineStart != std::string::npos && lineStart + 2 < header.size()) {
+        lineStart += 2;
+        size_t lineEnd = header.find("\r\n", lineStart);
+        std::string line = header.substr(lineStart, lineEnd - lineStart);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string name = line.substr(0, colon);
+            size_t valueStart = line.find_first_not_of(" \t", colon + 1);
+            std::string value = valueStart == std::string::npos ? "" : line.substr(valueStart);
+            if (strcasecmp(name.c_str(), "Content-Length") == 0) {
+                int64_t length = 0;
+                size_t i = 0;
+                for (; i < value.size() && value[i] >= '0' && value[i] <= '9'; i++) {
+                    length = length * 10 + (value[i] - '0');
+                }
+                if (i > 0) *contentLength = length;
+            } else if (strcasecmp(name.c_str(), "Transfer-Encoding") == 0 &&
+                       strcasestr(value.c_str(), "chunked") != nullptr) {
+                chunked = true;
+            }
+        }
+        lineStart = lineEnd;
+    }
+    if (chunked) {
+        *contentLength = -1;
+    }
+    return true;
+}
+
+addrinfo *ResolveHost(const HttpUrl &url, std::string *error) {
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo *addresses = nullptr;
+    std::string port = std::to_string(url.port);
+    int rc = getaddrinfo(url.host.c_str(), port.c_str(), &hints, &addresses);
+    if (rc != 0) {
+        *error = std::string("Failed to resolve host: ") + gai_strerror(rc);
+        return nullptr;
+    }
+    return addresses;
+}
+
+int ConnectNonBlocking(const addrinfo *addresses, std::string *error) {
+    int fd = -1;
+    for (const addrinfo *ai = addresses; ai != nullptr && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) {
+            *error = std::string("socket: ") + std::strerror(errno);
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) != 0 && errno != EINPROGRESS) {
+            *error = std::string("connect: ") + std::strerror(errno);
+            close(fd);
+            fd = -1;
+        }
+    }
+    return fd;
+}
+
+bool CheckConnected(int fd, std::string *error) {
+    int socketError = 0;
+    socklen_t length = sizeof(socketError);
+    getsockopt(fd, SOL_SOCKET, SO_ERROR, &socketError, &length);
+    if (socketError != 0) {
+        *error = std::string("connect: ") + std::strerror(socketError);
+        return false;
+    }
+    return true;
+}
+
+// 较新的字段是否在内核返回的长度之内 (tcp_info 只在末尾追加字段)
+#define TCP_INFO_HAS(length, field) \
+    ((length) >= offsetof(tcp_info, field) + sizeof(static_cast<tcp_info *>(nullptr)->field))
+
+bool SampleTcpMetrics(int fd, TcpMetrics *out) {
+    tcp_info info = {};
+    socklen_t length = sizeof(info);
+    if (getsockopt(fd, IPPROTO_TCP, TCP_INFO, &info, &length) != 0 || !TCP_INFO_HAS(length, tcpi_total_retrans)) {
+        return false;
+    }
+    TcpMetrics metrics;
+    metrics.valid = true;
+    metrics.connections = 1;
+    metrics.rttUs = info.tcpi_rtt;
+    metrics.rttVarUs = info.tcpi_rttvar;
+    metrics.rcvRttUs = info.tcpi_rcv_rtt;
+    metrics.retransmits = info.tcpi_total_retrans;
+    metrics.cwnd = info.tcpi_snd_cwnd;
+    metrics.mss = info.tcpi_snd_mss;
+    if (TCP_INFO_HAS(length, tcpi_pacing_rate) && info.tcpi_pacing_rate != UINT64_MAX) {
+        metrics.pacingKbps = static_cast<double>(info.tcpi_pacing_rate) * 8.0 / 1024.0; // 字节/秒
+    }
+    if (TCP_INFO_HAS(length, tcpi_segs_out)) {
+        metrics.segmentsOut = info.tcpi_segs_out;
+    }
+    if (TCP_INFO_HAS(length, tcpi_min_rtt) && info.tcpi_min_rtt != UINT32_MAX) {
+        metrics.minRttUs = info.tcpi_min_rtt;
+    }
+    *out = metrics;
+    return true;
+}
@@ -0,0 +1,423 @@
+// 原生 HTTP 上传测速：固定模板反复发送，按对端已确认的字节送入分析器
+#include "http_upload.h"
+#include "clock_source.h"
+#include "traffic_trace.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <linux/sockios.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static constexpr int MAX_WRITES_PER_WAKE = 16;    // 每次唤醒最多写几次，保证上报与停止检查及时
+static constexpr int64_t ACK_POLL_US = 10000;    // 有未确认数据时查询发送队列的间隔
+static constexpr size_t MIN_PATTERN_SIZE = 4096;
+static constexpr int MAX_IOV_COUNT = 64;
+static constexpr uint32_t WAKE_EVENT = UINT32_MAX; // epoll 事件里 eventfd 的标记
+
+static std::string BuildRequest(const HttpUrl &url, uint64_t contentLength) {
+    return "POST " + url.path + " HTTP/1.1\r\n"
+           "Host: " + HostHeader(url) + "\r\n"
+           "User-Agent: NetGuardian\r\n"
+           "Accept: */*\r\n"
+           "Content-Type: application/octet-stream\r\n"
+           "Content-Length: " + std::to_string(contentLength) + "\r\n"
+           "Cache-Control: no-cache\r\n"
+           "Connection: close\r\n\r\n";
+}
+
+// 模板填充伪随机字节，避免链路上的压缩让测到的速度虚高
+static void FillPattern(std::vector<char> *pattern, size_t size) {
+    pattern->resize(size);
+    uint32_t state = 0x9E3779B9u;
+    for (char &byte : *pattern) {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        byte = static_cast<char>(state & 0xFF);
+    }
+}
+
+// 把模板写入 memfd，供 sendfile 从页缓存发送；不支持 memfd 时返回 -1
+static int CreatePatternFile(const std::vector<char> &pattern) {
+    int fd = memfd_create("net_guardian_upload", MFD_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    size_t written = 0;
+    while (written < pattern.size()) {
+        ssize_t n = write(fd, pattern.data() + written, pattern.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            close(fd);
+            return -1;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return fd;
+}
+
+// 一次上传连接的发送状态
+struct UploadConnection {
+    enum State { CONNECTING, SENDING, WAITING };
+    int fd = -1;
+    State state = CONNECTING;
+    std::string request;      // 请求头
+    size_t requestSent = 0;
+    uint64_t totalBytes = 0;  // 正文总长度
+    uint64_t bodySent = 0;    // 已写入 socket 的正文字节
+    uint64_t bodyAcked = 0;   // 已被确认的正文字节
+    std::string header;       // 响应头 (到空行为止)
+    int httpStatus = 0;
+    bool responded = false;   // 已收到完整响应头
+    bool peerClosed = false;  // 读到对端的 EOF (只在收到响应头之后出现，之前视为错误)
+};
+
+// 发送器：writev 或 sendfile，两者都从同一块模板的 (已发送量 % 模板大小) 处续写
+struct PatternSender {
+    const std::vector<char> *pattern = nullptr;
+    int patternFd = -1; // >= 0 时用 sendfile
+    std::vector<iovec> iov;
+
+    ssize_t Send(int fd, uint64_t sent, uint64_t remaining) {
+        size_t size = pattern->size();
+        size_t offset = static_cast<size_t>(sent % size);
+        if (patternFd >= 0) {
+            off_t fileOffset = static_cast<off_t>(offset);
+            return sendfile(fd, patternFd, &fileOffset, static_cast<size_t>(std::min<uint64_t>(size - offset,
+                                                                                               remaining)));
+        }
+        size_t count = 0;
+        while (count < iov.size() && remaining > 0) {
+            size_t length = static_cast<size_t>(std::min<uint64_t>(size - offset, remaining));
+            iov[count].iov_base = const_cast<char *>(pattern->data()) + offset;
+            iov[count].iov_len = length;
+            remaining -= length;
+            offset = 0;
+            count++;
+        }
+        return writev(fd, iov.data(), static_cast<int>(count));
+    }
+};
+
+// 连接可写时尽量多写：先写完请求头，再写正文；正文写完后只等待可读 (响应)
+static bool SendAvailable(UploadConnection *conn, PatternSender *sender, int epollFd, std::string *error) {
+    for (int writes = 0; writes < MAX_WRITES_PER_WAKE; writes++) {
+        ssize_t n = 0;
+        bool inBody = conn->requestSent == conn->request.size();
+        if (!inBody) {
+            n = send(conn->fd, conn->request.data() + conn->requestSent, conn->request.size() - conn->requestSent,
+                     MSG_NOSIGNAL);
+        } else if (conn->bodySent < conn->totalBytes) {
+            n = sender->Send(conn->fd, conn->bodySent, conn->totalBytes - conn->bodySent);
+        } else {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            *error = std::string(inBody ? "send body: " : "send: ") + std::strerror(errno);
+            return false;
+        }
+        if (inBody) {
+            conn->bodySent += static_cast<uint64_t>(n);
+        } else {
+            conn->requestSent += static_cast<size_t>(n);
+        }
+    }
+    if (conn->bodySent == conn->totalBytes && conn->requestSent == conn->request.size()) {
+        epoll_event event = {};
+        event.events = EPOLLIN | EPOLLRDHUP;
+        event.data.u32 = 0;
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, conn->fd, &event);
+        conn->state = UploadConnection::WAITING;
+    }
+    return true;
+}
+
+// 读取响应头 (响应正文不关心，读到即丢弃)
+static bool ReadResponse(UploadConnection *conn, std::string *error) {
+    char buffer[4096];
+    while (true) {
+        ssize_t n = recv(conn->fd, buffer, sizeof(buffer), 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            *error = std::string("recv: ") + std::strerror(errno);
+            return false;
+        }
+        if (n == 0) {
+            if (!conn->responded) {
+                *error = "Connection closed before the response header";
+                return false;
+            }
+            conn->peerClosed = true;
+            return true;
+        }
+        if (conn->responded) continue;
+        conn->header.append(buffer, static_cast<size_t>(n));
+        size_t end = conn->header.find("\r\n\r\n");
+        if (end == std::string::npos) {
+            if (conn->header.size() > MAX_HEADER_BYTES) {
+                *error = "Response header too large";
+                return false;
+            }
+            continue;
+        }
+        conn->header.resize(end + 2);
+        int64_t contentLength = -1;
+        if (!ParseResponseHeader(conn->header, &conn->httpStatus, &contentLength)) {
+            *error = "Malformed HTTP response";
+            return false;
+        }
+        if (conn->httpStatus < 200 || conn->httpStatus >= 300) {
+            *error = "HTTP status " + std::to_string(conn->httpStatus);
+            return false;
+        }
+        conn->responded = true;
+    }
+}
+
+// 已确认的正文字节 = 已写入字节 - 发送队列中未确认的字节 (SIOCOUTQ 含未发出与已发出未确认)，扣除请求头
+static void UpdateAcked(UploadConnection *conn) {
+    int queued = 0;
+    if (ioctl(conn->fd, SIOCOUTQ, &queued) != 0 || queued < 0) {
+        return; // 查询失败时保持上一次的值
+    }
+    uint64_t written = conn->requestSent + conn->bodySent;
+    uint64_t ackedWire = written - std::min<uint64_t>(written, static_cast<uint64_t>(queued));
+    uint64_t acked = ackedWire > conn->request.size() ? ackedWire - conn->request.size() : 0;
+    conn->bodyAcked = std::max(conn->bodyAcked, std::min(acked, conn->bodySent));
+}
+
+HttpUploadEngine::HttpUploadEngine() {
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+HttpUploadEngine::~HttpUploadEngine() {
+    Stop();
+    Join();
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+    }
+}
+
+bool HttpUploadEngine::Start(const UploadOptions &options, ReportCallback onReport, FinishCallback onFinish) {
+    if (Running()) {
+        return false;
+    }
+    Join(); // 回收上一次测量已经结束的线程
+    stopRequested_.store(false, std::memory_order_release);
+    uint64_t pending = 0;
+    if (wakeFd_ >= 0 && read(wakeFd_, &pending, sizeof(pending)) < 0) {
+        pending = 0; // 没有遗留的唤醒
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread(&HttpUploadEngine::ThreadMain, this, options, std::move(onReport), std::move(onFinish));
+    return true;
+}
+
+void HttpUploadEngine::Stop() {
+    stopRequested_.store(true, std::memory_order_release);
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        if (write(wakeFd_, &one, sizeof(one)) < 0) {
+            one = 0; // 计数器已满也会被唤醒
+        }
+    }
+}
+
+void HttpUploadEngine::Join() {
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void HttpUploadEngine::ThreadMain(UploadOptions options, ReportCallback onReport, FinishCallback onFinish) {
+    result_ = Run(options, onReport);
+    UploadResult result = result_;
+    running_.store(false, std::memory_order_release);
+    if (onFinish) {
+        onFinish(result);
+    }
+}
+
+UploadResult HttpUploadEngine::Run(const UploadOptions &options, const ReportCallback &onReport) {
+    UploadResult result;
+    ClockSource *clock = ClockSource::Steady();
+    int64_t startUs = clock->NowUs();
+    analyzer_.SetConvergenceConfig(options.convergence);
+    analyzer_.Reset();
+    if (pattern_.size() != std::max(options.patternSize, MIN_PATTERN_SIZE)) {
+        FillPattern(&pattern_, std::max(options.patternSize, MIN_PATTERN_SIZE));
+    }
+
+    TraceWriter traceWriter;
+    if (!options.tracePath.empty() && traceWriter.Open(options.tracePath)) {
+        analyzer_.SetTraceWriter(&traceWriter);
+    }
+
+    PatternSender sender;
+    sender.pattern = &pattern_;
+    sender.iov.resize(static_cast<size_t>(std::min(std::max(options.iovCount, 1), MAX_IOV_COUNT)));
+    if (options.sendMode == UPLOAD_SEND_SENDFILE) {
+        sender.patternFd = CreatePatternFile(pattern_);
+        result.sendfileUsed = sender.patternFd >= 0;
+    }
+
+    UploadConnection conn;
+    conn.totalBytes = options.totalBytes;
+    HttpUrl url;
+    int epollFd = -1;
+    if (!ParseHttpUrl(options.url, &url)) {
+        result.error = "Invalid http:// URL";
+    } else if ((epollFd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+        result.error = std::string("epoll_create1: ") + std::strerror(errno);
+    } else if (addrinfo *addresses = ResolveHost(url, &result.error)) {
+        conn.request = BuildRequest(url, options.totalBytes);
+        conn.fd = ConnectNonBlocking(addresses, &result.error);
+        freeaddrinfo(addresses);
+    }
+
+    bool finished = conn.fd < 0;
+    if (!finished) {
+        epoll_event event = {};
+        event.events = EPOLLOUT | EPOLLIN | EPOLLRDHUP;
+        event.data.u32 = 0;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, conn.fd, &event);
+        if (wakeFd_ >= 0) {
+            event.events = EPOLLIN;
+            event.data.u32 = WAKE_EVENT;
+            epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd_, &event);
+        }
+    }
+
+    // 每次上报前采样一次 TCP_INFO，送入分析器
+    auto makeReport = [&](int64_t nowUs) {
+        TcpMetrics tcp;
+        if (conn.fd >= 0 && conn.state != UploadConnection::CONNECTING && SampleTcpMetrics(conn.fd, &tcp)) {
+            analyzer_.SetTcpMetrics(tcp);
+        }
+        UploadReport report;
+        report.stats = analyzer_.Current();
+        report.sentBytes = conn.bodySent;
+        report.ackedBytes = conn.bodyAcked;
+        report.totalBytes = conn.totalBytes;
+        report.elapsedUs = nowUs - startUs;
+        return report;
+    };
+
+    const int64_t reportIntervalUs = std::max<int64_t>(options.reportIntervalUs, 1000);
+    const int64_t connectDeadlineUs = startUs + static_cast<int64_t>(std::max(options.connectTimeoutMs, 1)) * 1000;
+    const int64_t endUs = options.durationUs > 0 ? startUs + options.durationUs : INT64_MAX;
+    int64_t nextReportUs = startUs + reportIntervalUs;
+    int64_t nowUs = startUs;
+    result.reason = UPLOAD_FAILED;
+    epoll_event events[2];
+    while (!finished) {
+        nowUs = clock->NowUs();
+        if (stopRequested_.load(std::memory_order_acquire)) {
+            result.reason = UPLOAD_STOPPED;
+            break;
+        }
+        if (nowUs >= endUs) {
+            result.reason = UPLOAD_DURATION;
+            break;
+        }
+        if (conn.state == UploadConnection::CONNECTING && nowUs >= connectDeadlineUs) {
+            result.error = "Timed out connecting";
+            break;
+        }
+        if (nowUs >= nextReportUs) {
+            if (onReport) onReport(makeReport(nowUs));
+            // 回调太慢时不补发积压的上报
+            nextReportUs = std::max(nextReportUs + reportIntervalUs, nowUs + reportIntervalUs / 2);
+        }
+
+        int64_t wakeUs = std::min(nextReportUs, endUs);
+        if (conn.state == UploadConnection::CONNECTING) wakeUs = std::min(wakeUs, connectDeadlineUs);
+        // 确认不会产生 epoll 事件 (发送缓冲区未满时)，有在途数据就定期查询发送队列
+        if (conn.bodyAcked < conn.bodySent) wakeUs = std::min(wakeUs, nowUs + ACK_POLL_US);
+        // 上报间隔与超时由调用方决定，等待时长须限制在 epoll_wait 的 int 范围内
+        int64_t waitMs = std::min<int64_t>((wakeUs - nowUs + 999) / 1000, INT_MAX);
+        int timeoutMs = static_cast<int>(std::max<int64_t>(waitMs, 0));
+        int ready = epoll_wait(epollFd, events, 2, timeoutMs);
+        if (ready < 0 && errno != EINTR) {
+            result.error = std::string("epoll_wait: ") + std::strerror(errno);
+            break;
+        }
+
+        bool ok = true;
+        for (int i = 0; i < ready && ok; i++) {
+            if (events[i].data.u32 == WAKE_EVENT) {
+                uint64_t value = 0;
+                if (read(wakeFd_, &value, sizeof(value)) < 0) value = 0;
+                continue;
+            }
+            uint32_t flags = events[i].events;
+            if (conn.state == UploadConnection::CONNECTING) {
+                ok = CheckConnected(conn.fd, &result.error);
+                if (!ok || (flags & (EPOLLOUT | EPOLLERR | EPOLLHUP)) == 0) continue;
+                conn.state = UploadConnection::SENDING;
+            }
+            // 先读响应：服务端提前拒绝 (如 413) 后断开时，报告状态码而不是发送错误
+            if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                ok = ReadResponse(&conn, &result.error);
+                if (ok && conn.peerClosed) {
+                    // EOF 在水平触发下一直可读：注销 fd，之后只按 ACK_POLL_US 查询剩余的确认
+                    epoll_ctl(epollFd, EPOLL_CTL_DEL, conn.fd, nullptr);
+                    break;
+                }
+            }
+            if (ok && conn.state == UploadConnection::SENDING && (flags & EPOLLOUT)) {
+                ok = SendAvailable(&conn, &sender, epollFd, &result.error);
+            }
+        }
+        if (!ok) {
+            break;
+        }
+
+        if (conn.state != UploadConnection::CONNECTING) {
+            uint64_t before = conn.bodyAcked;
+            UpdateAcked(&conn);
+            if (conn.bodyAcked > before) {
+                nowUs = clock->NowUs();
+                analyzer_.ProcessAt(static_cast<size_t>(conn.bodyAcked - before), nowUs);
+            }
+        }
+        if (conn.responded && conn.state == UploadConnection::SENDING) {
+            // 服务端不等正文发完就回了 2xx：停止发送，与完整上传区分开
+            result.reason = UPLOAD_EARLY_RESPONSE;
+            break;
+        }
+        if (conn.responded && conn.bodyAcked == conn.totalBytes) {
+            result.reason = UPLOAD_COMPLETED;
+            break;
+        }
+        if (options.stopWhenStable && analyzer_.Stable()) {
+            result.reason = UPLOAD_CONVERGED;
+            break;
+        }
+    }
+
+    result.httpStatus = conn.httpStatus;
+    if (conn.fd >= 0 && conn.state != UploadConnection::CONNECTING) {
+        UpdateAcked(&conn); // 结果里的已确认字节取结束时刻的值
+    }
+    result.last = makeReport(clock->NowUs());
+    if (result.reason != UPLOAD_FAILED) {
+        result.error.clear();
+    }
+    if (conn.fd >= 0) close(conn.fd);
+    if (epollFd >= 0) close(epollFd);
+    if (sender.patternFd >= 0) close(sender.patternFd);
+    analyzer_.SetTraceWriter(nullptr);
+    return result;
+}
@@ -0,0 +1,36 @@
+#ifndef NET_GUARDIAN_CLOCK_SOURCE_H
+#define NET_GUARDIAN_CLOCK_SOURCE_H
+
+#include <cstdint>
+
+/**
+ * 分析器使用的单调时钟 (微秒)
+ * 所有实现共享 CLOCK_MONOTONIC 时间基，可以在同一会话中切换而不会产生时间跳变 (手动时钟除外)
+ */
+class ClockSource {
+public:
+    virtual ~ClockSource() = default;
+    virtual int64_t NowUs() = 0;
+
+    // 精确时钟：std::chrono::steady_clock (CLOCK_MONOTONIC)
+    static ClockSource *Steady();
+
+    // 粗粒度时钟：CLOCK_MONOTONIC_COARSE，直接读取内核在时钟中断时缓存的时间，开销远低于精确时钟
+    // 精度为一个时钟节拍 (通常 1~4ms)，相对 100ms 的计算间隔可以接受；平台不支持时退化为精确时钟
+    static ClockSource *CoarseMonotonic();
+};
+
+// 手动推进的时钟，用于测试与离线回放，时间完全由调用方决定
+class ManualClockSource : public ClockSource {
+public:
+    explicit ManualClockSource(int64_t startUs = 0) : nowUs_(startUs) {}
+
+    int64_t NowUs() override { return nowUs_; }
+    void SetUs(int64_t nowUs) { nowUs_ = nowUs; }
+    void AdvanceUs(int64_t deltaUs) { nowUs_ += deltaUs; }
+
+private:
+    int64_t nowUs_;
+};
+
+#endif
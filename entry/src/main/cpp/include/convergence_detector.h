@@ -0,0 +1,56 @@
+#ifndef NET_GUARDIAN_CONVERGENCE_DETECTOR_H
+#define NET_GUARDIAN_CONVERGENCE_DETECTOR_H
+
+#include "sliding_window.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * 判定速度 "已稳定" 的条件，三项同时满足且测量时长足够才算稳定
+ * 置信区间半宽 = z * 标准差 / sqrt(windowSamples)，所以置信区间条件等价于 标准差 / 均值 <=
+ * maxConfidenceRatio * sqrt(windowSamples) / z；默认值下为 0.114，抖动上限 (0.10) 取得比它小，
+ * 两个条件各自起作用：抖动条件拒绝噪声大的链路，置信区间条件在调小 maxConfidenceRatio 时收紧
+ */
+struct ConvergenceConfig {
+    size_t windowSamples = 20;       // 参与判断的最近瞬时速度样本数 (100ms 一个，约 2 秒)
+    double maxJitterRatio = 0.10;    // 窗口抖动 (标准差) / 窗口均值 的上限
+    double maxConfidenceRatio = 0.05; // 窗口均值的置信区间半宽 / 窗口均值 的上限
+    double confidenceZ = 1.96;       // 置信区间的 z 值 (1.96 对应 95%)
+    size_t driftSamples = 5;         // 窗口均值在最近这么多个样本内的变化 ...
+    double maxDriftRatio = 0.03;     // ... 相对窗口均值不超过该比例 (估计值不再移动)
+    int64_t minDurationUs = 2000000; // 至少测量这么久，避开 TCP 慢启动
+};
+
+/**
+ * 速度收敛检测：跟踪瞬时速度的滑动窗口均值、抖动与均值的置信区间，
+ * 估计值不再移动时报告 "稳定"，稳定的链路可以提前结束测量，抖动大的链路继续采样
+ * 每个瞬时速度样本调用一次 Update；状态不锁存，链路重新波动时 Stable() 会回到 false
+ */
+class ConvergenceDetector {
+public:
+    explicit ConvergenceDetector(const ConvergenceConfig &config = ConvergenceConfig());
+
+    // 替换判定条件并清空状态
+    void Configure(const ConvergenceConfig &config);
+    void Reset();
+
+    // 送入一个瞬时速度样本，elapsedUs 为自会话开始的时长；返回送入后是否稳定
+    bool Update(double instantKbps, int64_t elapsedUs);
+
+    bool Stable() const { return stable_; }
+    double MeanKbps() const { return window_.Mean(); }
+    // 窗口均值的置信区间半宽 (kbps)，样本不足两个时为 0
+    double ConfidenceKbps() const;
+    const ConvergenceConfig &Config() const { return config_; }
+
+private:
+    ConvergenceConfig config_;
+    SlidingWindowStats window_;
+    std::vector<double> recentMeans_; // 最近 driftSamples 个窗口均值 (环形)
+    size_t meanHead_ = 0;
+    size_t meanCount_ = 0;
+    bool stable_ = false;
+};
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef NET_GUARDIAN_HEADLESS_SURFACE_H
+#define NET_GUARDIAN_HEADLESS_SURFACE_H
+
+#include "render_surface.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 无窗口的渲染目标：若干块内存 RGBA 缓冲区按顺序轮流出队，模拟窗口的缓冲队列 (每块缓冲区保留上次画的内容)
+ * 用于宿主机上的帧耗时基准与像素级测试，记录最近一次提交的缓冲区与脏区域
+ */
+class HeadlessSurface : public RenderSurface {
+public:
+    // stride 为 0 时取 width * 4；大于 width * 4 时模拟带行填充的窗口缓冲区
+    HeadlessSurface(uint64_t width, uint64_t height, size_t bufferCount = 3, int32_t stride = 0);
+
+    // 重新分配全部缓冲区 (内容清零)，相当于窗口尺寸变化
+    void Resize(uint64_t width, uint64_t height, int32_t stride = 0);
+
+    uint64_t Width() const override { return width_; }
+    uint64_t Height() const override { return height_; }
+    AcquireResult AcquireFrame(SurfaceFrame *frame) override;
+    void PresentFrame(const SurfaceFrame &frame, const SurfaceDamage *damage) override;
+    void DiscardFrame(const SurfaceFrame &frame) override;
+
+    // 模拟接下来 count 次出队时没有可写的缓冲区 (合成器仍持有全部缓冲区)，返回 ACQUIRE_NOT_READY
+    void StallAcquires(size_t count) { stalledAcquires_ = count; }
+
+    int32_t Stride() const { return stride_; }
+    // 最近一次提交的缓冲区 (还没有提交过时返回 nullptr)
+    const uint8_t *PresentedPixels() const;
+    // 最近一次提交的缓冲区在 (x, y) 处的像素，按 0xAARRGGBB 返回 (premultiplied)
+    uint32_t PresentedPixel(uint64_t x, uint64_t y) const;
+    // 最近一次提交是否带脏区域，以及脏区域本身
+    bool LastDamagePartial() const { return lastDamagePartial_; }
+    const SurfaceDamage &LastDamage() const { return lastDamage_; }
+    uint64_t PresentedCount() const { return presentedCount_; }
+    uint64_t DiscardedCount() const { return discardedCount_; }
+    uint64_t NotReadyCount() const { return notReadyCount_; }
+
+    // 把最近一次提交的画面写成 PPM (P6，忽略 alpha)，便于肉眼检查像素测试的结果
+    bool WritePpm(const std::string &path) const;
+
+private:
+    uint64_t width_ = 0;
+    uint64_t height_ = 0;
+    int32_t stride_ = 0;
+    uint32_t epoch_ = 0;
+    std::vector<std::vector<uint8_t>> buffers_;
+    size_t nextBuffer_ = 0;
+    int64_t presentedBuffer_ = -1;
+    bool lastDamagePartial_ = false;
+    SurfaceDamage lastDamage_;
+    uint64_t presentedCount_ = 0;
+    uint64_t discardedCount_ = 0;
+    size_t stalledAcquires_ = 0;
+    uint64_t notReadyCount_ = 0;
+};
+
+#endif
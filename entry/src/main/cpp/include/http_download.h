@@ -0,0 +1,120 @@
+#ifndef NET_GUARDIAN_HTTP_DOWNLOAD_H
+#define NET_GUARDIAN_HTTP_DOWNLOAD_H
+
+#include "http_socket.h"
+#include "traffic_analyzer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+static constexpr int MAX_DOWNLOAD_STREAMS = 16;  // 并行连接数上限
+static constexpr double STRAGGLER_RATIO = 0.5;   // 均速低于各流中位数的这个比例视为掉队
+
+struct DownloadOptions {
+    std::string url;
+    int streams = 1;                      // 对同一 URL 并行的连接数 (1 ~ MAX_DOWNLOAD_STREAMS)
+    int64_t durationUs = 8000000;         // 最长测量时长，到时主动结束 (<= 0 不限)
+    uint64_t maxBytes = 0;                // 所有流合计收到这么多正文字节后结束 (0 不限)
+    bool stopWhenStable = false;          // 聚合速度收敛 (Analyzer().Stable()) 后提前结束
+    ConvergenceConfig convergence;        // 收敛判定条件，每次开始时设置给聚合分析器
+    int connectTimeoutMs = 10000;         // 解析、连接到收到响应头的超时
+    int64_t reportIntervalUs = 100000;    // 上报聚合结果的间隔
+    size_t bufferSize = 256 * 1024;       // 接收缓冲区 (整个会话复用)
+    std::string tracePath;                // 非空时把送入分析器的流量记录到该轨迹文件
+};
+
+enum DownloadEndReason {
+    DOWNLOAD_COMPLETED = 0, // 响应正文接收完毕
+    DOWNLOAD_DURATION,      // 达到 durationUs
+    DOWNLOAD_BYTES,         // 达到 maxBytes
+    DOWNLOAD_CONVERGED,     // 聚合速度已收敛 (stopWhenStable)
+    DOWNLOAD_STOPPED,       // 调用了 Stop()
+    DOWNLOAD_FAILED,        // 所有流都在解析 / 连接 / HTTP 阶段出错，见 error
+};
+
+enum StreamState {
+    STREAM_CONNECTING = 0, // 连接中或等待响应头
+    STREAM_RECEIVING,      // 接收正文
+    STREAM_COMPLETED,      // 正文接收完毕
+    STREAM_FAILED,         // 出错 (其他流继续测量)
+};
+
+// 单条连接的统计
+struct StreamReport {
+    StreamState state = STREAM_CONNECTING;
+    int httpStatus = 0;
+    uint64_t bytes = 0;     // 该流已接收的正文字节
+    TrafficStats stats;     // 该流独立分析器的统计，avgKbps 用于公平性与掉队判断
+    bool straggler = false; // 均速低于各流中位数的 STRAGGLER_RATIO
+};
+
+// 测量期间的周期性聚合结果
+struct DownloadReport {
+    TrafficStats stats;        // 聚合分析器 (所有流合计) 的最新统计
+    uint64_t bytes = 0;        // 所有流合计已接收的正文字节
+    int64_t elapsedUs = 0;     // 自开始连接起的时长
+    int64_t contentLength = -1; // 各流响应头声明的正文长度之和，任一未知时为 -1
+    std::vector<StreamReport> streams;
+    double fairness = 1.0;     // 各流均速的 Jain 公平性指数 (1 / n ~ 1，越接近 1 越均衡)
+    int stragglers = 0;        // 掉队的流数
+};
+
+// 按各流的均速计算 report 的公平性指数并标记掉队的流 (至少两条流产生速度样本后才有意义)
+void AssessStreams(DownloadReport *report);
+
+struct DownloadResult {
+    DownloadEndReason reason = DOWNLOAD_FAILED;
+    int httpStatus = 0; // 第一条收到响应头的流的状态码，0 表示都没有收到
+    DownloadReport last; // 结束时的聚合结果
+    std::string error;   // reason 为 DOWNLOAD_FAILED 时的说明 (第一条出错的流)
+};
+
+/**
+ * 原生 HTTP 下载测速引擎：非阻塞 socket + epoll，在自己的线程上接收
+ * 正文读入一块复用的缓冲区后原地丢弃 (Linux 上用 MSG_TRUNC 由内核直接丢弃，不拷贝到用户态)，
+ * 只把字节数送入分析器；调用方只在固定间隔收到聚合结果 (DownloadReport)，不接触数据本身
+ * 多流模式下所有连接共用一个 epoll 与缓冲区，合计流量送入 Analyzer()，每条流另有独立分析器
+ * 一个实例同一时刻只运行一次测量，结束后可以再次 Start
+ */
+class HttpDownloadEngine {
+public:
+    // 两个回调都在引擎线程上调用，不能阻塞太久 (会推迟接收)
+    using ReportCallback = std::function<void(const DownloadReport &report)>;
+    using FinishCallback = std::function<void(const DownloadResult &result)>;
+
+    HttpDownloadEngine();
+    ~HttpDownloadEngine(); // 停止并等待引擎线程结束
+    HttpDownloadEngine(const HttpDownloadEngine &) = delete;
+    HttpDownloadEngine &operator=(const HttpDownloadEngine &) = delete;
+
+    // 样本推送 (SetSampleListener)、时钟等的配置入口，只能在没有运行时修改
+    TrafficAnalyzer &Analyzer() { return analyzer_; }
+
+    // 开始一次测量 (每次开始前重置分析器)；正在运行或无法创建线程时返回 false
+    bool Start(const DownloadOptions &options, ReportCallback onReport, FinishCallback onFinish);
+    // 请求停止 (任意线程，不等待)，引擎线程会尽快以 DOWNLOAD_STOPPED 结束
+    void Stop();
+    // 等待引擎线程结束 (不能在回调里调用)
+    void Join();
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+    // 最近一次测量的结果 (Join 之后有效)
+    const DownloadResult &Result() const { return result_; }
+
+private:
+    DownloadResult Run(const DownloadOptions &options, const ReportCallback &onReport);
+    void ThreadMain(DownloadOptions options, ReportCallback onReport, FinishCallback onFinish);
+
+    TrafficAnalyzer analyzer_;
+    std::vector<char> buffer_;
+    DownloadResult result_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopRequested_{false};
+    int wakeFd_ = -1; // eventfd：Stop() 写入以唤醒 epoll_wait
+};
+
+#endif
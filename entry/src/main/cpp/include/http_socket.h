@@ -0,0 +1,43 @@
+#ifndef NET_GUARDIAN_HTTP_SOCKET_H
+#define NET_GUARDIAN_HTTP_SOCKET_H
+
+#include "tcp_metrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <netdb.h>
+#include <string>
+
+// 测速引擎 (下载 / 上传) 共用的 HTTP/1.1 与非阻塞 socket 工具
+
+static constexpr size_t MAX_HEADER_BYTES = 64 * 1024; // 响应头上限，超出视为异常响应
+
+// http:// URL 的组成部分 (测速源都是明文 HTTP，不支持 https)
+struct HttpUrl {
+    std::string host;
+    uint16_t port = 80;
+    std::string path = "/"; // 含查询串
+};
+
+// 解析 http://host[:port][/path]，格式不对或端口越界时返回 false
+bool ParseHttpUrl(const std::string &url, HttpUrl *out);
+
+// Host 头：非默认端口要带上，IPv6 字面量要加方括号
+std::string HostHeader(const HttpUrl &url);
+
+// 解析状态行与 Content-Length (chunked 编码时长度未知，分块开销一并计入正文字节)
+bool ParseResponseHeader(const std::string &header, int *status, int64_t *contentLength);
+
+// 解析主机名 (阻塞，在引擎线程上执行)，失败时返回 nullptr 并写入 error；结果由调用方 freeaddrinfo
+addrinfo *ResolveHost(const HttpUrl &url, std::string *error);
+
+// 按地址顺序发起非阻塞连接，返回正在连接的 socket；全部立即失败时返回 -1 并写入 error
+int ConnectNonBlocking(const addrinfo *addresses, std::string *error);
+
+// 非阻塞连接可写 / 出错后取连接结果，失败时返回 false 并写入 error
+bool CheckConnected(int fd, std::string *error);
+
+// 从已连接 socket 的 TCP_INFO 取一次指标 (单条连接)，失败时返回 false 且不修改 *out
+// 内核较旧、不提供 pacing 速率 / 最小 RTT / 发出段数时这些字段为 0
+bool SampleTcpMetrics(int fd, TcpMetrics *out);
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef NET_GUARDIAN_HTTP_UPLOAD_H
+#define NET_GUARDIAN_HTTP_UPLOAD_H
+
+#include "http_socket.h"
+#include "traffic_analyzer.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 正文的发送方式
+enum UploadSendMode {
+    UPLOAD_SEND_WRITEV = 0, // writev：一次提交多个指向同一块模板的 iovec
+    UPLOAD_SEND_SENDFILE,   // sendfile：模板写入 memfd 一次，之后由内核从页缓存发送 (不可用时退回 writev)
+};
+
+struct UploadOptions {
+    std::string url;
+    uint64_t totalBytes = 100ULL * 1024 * 1024; // 请求正文长度 (Content-Length)，不占用对应大小的内存
+    int64_t durationUs = 8000000;               // 最长测量时长，到时主动结束 (<= 0 不限)
+    int connectTimeoutMs = 10000;               // 解析、连接的超时
+    int64_t reportIntervalUs = 100000;          // 上报聚合结果的间隔
+    UploadSendMode sendMode = UPLOAD_SEND_WRITEV;
+    size_t patternSize = 64 * 1024;             // 反复发送的模板大小 (整个会话唯一的正文内存)
+    int iovCount = 16;                          // writev 每次提交的 iovec 数
+    bool stopWhenStable = false;                // 速度收敛 (Analyzer().Stable()) 后提前结束
+    ConvergenceConfig convergence;              // 收敛判定条件，每次开始时设置给分析器
+    std::string tracePath;                      // 非空时把送入分析器的流量记录到该轨迹文件
+};
+
+enum UploadEndReason {
+    UPLOAD_COMPLETED = 0,  // 正文全部被对端确认并收到 2xx 响应
+    UPLOAD_EARLY_RESPONSE, // 正文还没发完服务端就回了 2xx，实际发出 / 确认的量见 last.sentBytes / ackedBytes
+    UPLOAD_DURATION,       // 达到 durationUs
+    UPLOAD_CONVERGED,      // 速度已收敛 (stopWhenStable)
+    UPLOAD_STOPPED,        // 调用了 Stop()
+    UPLOAD_FAILED,         // 解析 / 连接 / 发送 / HTTP 出错，见 error
+};
+
+// 测量期间的周期性聚合结果
+struct UploadReport {
+    TrafficStats stats;      // 分析器的最新统计 (按已确认字节计算)
+    uint64_t sentBytes = 0;  // 已写入 socket 的正文字节 (含仍在发送队列里的)
+    uint64_t ackedBytes = 0; // 已被对端 TCP 确认的正文字节
+    uint64_t totalBytes = 0; // 正文总长度
+    int64_t elapsedUs = 0;   // 自开始连接起的时长
+};
+
+struct UploadResult {
+    UploadEndReason reason = UPLOAD_FAILED;
+    int httpStatus = 0;  // 0 表示没有收到响应头
+    UploadReport last;   // 结束时的聚合结果
+    std::string error;   // reason 为 UPLOAD_FAILED 时的说明
+    bool sendfileUsed = false; // 实际是否用了 sendfile (memfd 不可用时为 false)
+};
+
+/**
+ * 原生 HTTP 上传测速引擎：非阻塞 socket + epoll，在自己的线程上发送
+ * 正文由一块固定大小的模板反复发送 (writev 或 memfd + sendfile)，内存占用与上传总量无关
+ * 吞吐按对端已确认的字节计算：已写入字节减去 socket 发送队列中尚未确认的字节 (SIOCOUTQ)，
+ * 不会把填满本机发送缓冲区的瞬间突发计为速度
+ * 一个实例同一时刻只运行一次测量，结束后可以再次 Start
+ */
+class HttpUploadEngine {
+public:
+    // 两个回调都在引擎线程上调用，不能阻塞太久 (会推迟发送)
+    using ReportCallback = std::function<void(const UploadReport &report)>;
+    using FinishCallback = std::function<void(const UploadResult &result)>;
+
+    HttpUploadEngine();
+    ~HttpUploadEngine(); // 停止并等待引擎线程结束
+    HttpUploadEngine(const HttpUploadEngine &) = delete;
+    HttpUploadEngine &operator=(const HttpUploadEngine &) = delete;
+
+    // 样本推送 (SetSampleListener)、时钟等的配置入口，只能在没有运行时修改
+    TrafficAnalyzer &Analyzer() { return analyzer_; }
+
+    // 开始一次测量 (每次开始前重置分析器)；正在运行时返回 false
+    bool Start(const UploadOptions &options, ReportCallback onReport, FinishCallback onFinish);
+    // 请求停止 (任意线程，不等待)，引擎线程会尽快以 UPLOAD_STOPPED 结束
+    void Stop();
+    // 等待引擎线程结束 (不能在回调里调用)
+    void Join();
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+    // 最近一次测量的结果 (Join 之后有效)
+    const UploadResult &Result() const { return result_; }
+
+private:
+    UploadResult Run(const UploadOptions &options, const ReportCallback &onReport);
+    void ThreadMain(UploadOptions options, ReportCallback onReport, FinishCallback onFinish);
+
+    TrafficAnalyzer analyzer_;
+    std::vector<char> pattern_; // 正文模板，整个会话复用
+    UploadResult result_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopRequested_{false};
+    int wakeFd_ = -1; // eventfd：Stop() 写入以唤醒 epoll_wait
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef NET_GUARDIAN_NATIVE_WINDOW_SURFACE_H
+#define NET_GUARDIAN_NATIVE_WINDOW_SURFACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <native_window/external_window.h>
+#include <vector>
+
+#include "render_surface.h"
+
+/**
+ * 基于 OHNativeWindow 的渲染目标 (XComponent SURFACE)
+ * 出队 = RequestBuffer，提交 = FlushBuffer (带脏区域)，放弃 = AbortBuffer
+ * 出队不会无限期阻塞：RequestBuffer 设置了超时，取到缓冲区后在限定时间内等待它的 acquire fence；
+ * Fence 未触发时暂存这块缓冲区 (连同 Fence) 并跳过本帧，下一帧优先重新检查它，绝不写入合成器仍在读取的缓冲区
+ * 窗口缓冲区按 fd 缓存映射：每块缓冲区只 mmap 一次 (系统已映射时直接使用 virAddr)
+ */
+class NativeWindowSurface : public RenderSurface {
+public:
+    // 设置 CPU 读写用途与 RGBA_8888 格式
+    explicit NativeWindowSurface(OHNativeWindow* window);
+    ~NativeWindowSurface() override;
+    NativeWindowSurface(const NativeWindowSurface&) = delete;
+    NativeWindowSurface& operator=(const NativeWindowSurface&) = delete;
+
+    // 设置缓冲区尺寸 (XComponent 创建 / 尺寸变化时调用)，旧的缓冲区映射全部失效
+    void Resize(uint64_t width, uint64_t height);
+
+    uint64_t Width() const override { return width_; }
+    uint64_t Height() const override { return height_; }
+    AcquireResult AcquireFrame(SurfaceFrame* frame) override;
+    void PresentFrame(const SurfaceFrame &frame, const SurfaceDamage* damage) override;
+    void DiscardFrame(const SurfaceFrame &frame) override;
+
+private:
+    // 一块窗口缓冲区的映射
+    struct BufferMapping {
+        int32_t fd = -1;
+        void* pixels = nullptr;  // 缓冲区像素地址 (系统映射或自行 mmap)
+        size_t mappedSize = 0;   // 非 0 表示由我们 mmap，释放时需要 munmap
+        int32_t stride = 0;
+        int32_t bufferSize = 0;
+        int32_t width = 0;
+        int32_t height = 0;
+    };
+    static constexpr size_t MAX_BUFFER_MAPPINGS = 8;
+    BufferMapping* AcquireMapping(BufferHandle* handle);
+    void ReleaseMappings();
+
+    // 出队等待预算：一帧 60fps 的时间内取不到可写缓冲区就跳帧，渲染线程不被合成器拖住
+    static constexpr int32_t REQUEST_TIMEOUT_MS = 16; // RequestBuffer 在队列已满时最多等待的时间
+    static constexpr int FENCE_WAIT_MS = 8;           // 取到缓冲区后等待其 acquire fence 的时间
+    // 放弃暂存的缓冲区并关闭其 Fence (尺寸变化 / 销毁时)
+    void ReleasePendingBuffer();
+
+    OHNativeWindow* window_ = nullptr;
+    uint64_t width_ = 0;
+    uint64_t height_ = 0;
+    std::vector<BufferMapping> mappings_;
+    OHNativeWindowBuffer* pendingBuffer_ = nullptr; // 已出队但 Fence 尚未触发的缓冲区
+    int pendingFence_ = -1;
+    uint32_t epoch_ = 0; // 每次释放映射后递增，通知绘制方丢弃包装在旧映射上的画布
+};
+
+#endif
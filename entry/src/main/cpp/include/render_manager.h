@@ -7,38 +7,74 @@
 #include <native_window/external_window.h>
 #include <string>
 #include <vector>
-#include <deque>
-#include <mutex>
 #include <atomic> 
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 
-#include <native_drawing/drawing_types.h>
-#include <native_drawing/drawing_canvas.h>
-#include <native_drawing/drawing_pen.h>
-#include <native_drawing/drawing_brush.h>
-#include <native_drawing/drawing_path.h>
-#include <native_drawing/drawing_color.h>
-#include <native_drawing/drawing_bitmap.h>
-#include <native_drawing/drawing_shader_effect.h>
-#include <native_drawing/drawing_point.h>
+#include "native_window_surface.h"
+#include "sample_history.h"
+#include "waveform_feed.h"
+#include "waveform_renderer.h"
 
+/**
+ * 波形渲染管理器
+ * 绘制在独立的渲染线程上完成：PushData 只写入无锁采样历史并唤醒渲染线程，永远不会阻塞在
+ * RequestBuffer 上；渲染线程按帧率上限出帧，两帧之间推送的所有样本合并到下一帧一次绘制
+ * 横轴为固定时长的时间窗口，屏幕上还有曲线时渲染线程按帧率持续出帧，让窗口随时间平滑滚动
+ * 每个 XComponent (按 id 区分) 对应一个实例，各自拥有 Surface、采样历史与渲染线程，可以并排显示多条波形
+ */
 class RenderManager {
 public:
-    static RenderManager* GetInstance();
+    // 默认通道，与旧版单实例使用的 XComponent id 相同
+    static constexpr const char* DEFAULT_ID = "NetGuardian_Waveform";
+    
+    // 按 XComponent id 取实例，不存在时创建；实例在进程生命周期内一直有效，指针可以长期持有
+    static RenderManager* GetInstance(const std::string &id);
+    static RenderManager* GetInstance(); // 默认通道
+    ~RenderManager();
     
     // 暴露给 NAPI 的初始化接口, 当 ArkTS 调用 XComponentContext.register() 时触发
     void RegisterCallback(OH_NativeXComponent* nativeXComponent);
     
-    // 设置组件 ID (用于区分多个 XComponent)
-    void SetId(std::string id);
+    const std::string& Id() const { return id_; }
+    
+    // 生产者身份 (见 WaveformFeed)：同一时刻只有一个持有者可以 PushData / ClearData
+    // 测量引擎在整个测量期间持有；JS 线程上的分析器共用一个身份，只在每次推送时短暂持有
+    bool ClaimProducer(const void *owner) { return feed_.ClaimProducer(owner); }
+    void ReleaseProducer(const void *owner) { feed_.ReleaseProducer(owner); }
+    const void *Producer() const { return feed_.Producer(); }
     
-    // 数据入口 (生产者调用)
-    void PushData(double speedKbps);
+    // 数据入口 (持有生产者身份的线程调用，不阻塞)：sampleTimeUs 为样本的时间戳 (分析器的时间基)
+    void PushData(double speedKbps, int64_t sampleTimeUs);
     
-    // 清空渲染队列
+    // 清空渲染队列 (持有生产者身份的线程调用)
     void ClearData(); 
     
-    // 数据快照出口 (消费者/绘图调用), 为了线程安全，不返回引用，而是返回一个拷贝的 vector
-    std::vector<double> GetDataSnapshot();
+    // 请求渲染线程在下一个帧间隔绘制一帧 (同一帧内的多次请求会被合并)
+    void RequestFrame();
+    
+    // 渲染管线计数与计时的快照 (任意线程调用)
+    RenderMetrics GetRenderMetrics();
+    
+    // 修改配色 / 描边样式，下一帧重建画笔、画刷与渐变
+    void SetWaveformStyle(const WaveformStyle &style);
+    WaveformStyle GetWaveformStyle();
+    
+    // 修改历史深度 (保留的样本数，2 ~ MAX_HISTORY_DEPTH)，会清空已有数据；超出范围返回 false
+    // 时间窗口随之变为 (depth - 1) * SAMPLE_INTERVAL_US：样本间隔不小于分析器的出样间隔，历史总能覆盖整个窗口
+    // 任意线程调用：没有生产者时立即生效，否则只记录请求，由生产者在下一次 PushData / ClearData 时换上新历史
+    bool SetHistoryDepth(size_t depth);
+    size_t HistoryDepth() const { return feed_.HistoryDepth(); }
+    
+    static constexpr size_t DEFAULT_HISTORY_DEPTH = WaveformFeed::DEFAULT_HISTORY_DEPTH;
+    static constexpr size_t MAX_HISTORY_DEPTH = WaveformFeed::MAX_HISTORY_DEPTH;
+    static constexpr int64_t SAMPLE_INTERVAL_US = 100000; // 分析器的出样间隔下限 (TrafficAnalyzer::MIN_CALC_INTERVAL_US)
+    
+    // 数据快照出口 (消费者/绘图调用)：无锁拷贝最近的采样到 out (至少 HistoryDepth() 个元素)，返回点数
+    // endSeq 非空时写入最新一个点的序号 + 1
+    size_t GetDataSnapshot(WaveformSample *out, uint64_t *endSeq = nullptr);
     
 public:
     // --- XComponent 生命周期回调 (必须是静态函数以匹配 C 接口) ---
@@ -48,22 +84,45 @@ public:
     static void OnDispatchTouchEvent(OH_NativeXComponent* component, void* window);
     
 private:
-    // 执行绘制一帧的核心逻辑
-    void DrawFrame();
+    explicit RenderManager(std::string id);
+    RenderManager(const RenderManager&) = delete;
+    RenderManager& operator=(const RenderManager&) = delete;
+    
+    // 由回调里的组件指针找到对应实例 (按组件 id)，取不到 id 时返回 nullptr
+    static RenderManager* FromComponent(OH_NativeXComponent* component);
+    
+    // 绘制并提交一帧 (只在渲染线程上调用，调用方持有 surfaceMutex_)
+    // 返回 true 表示下一个帧间隔还要再画：曲线仍需随时间滚动，或没有可写的缓冲区而跳帧
+    bool DrawFrame();
+    
+    // 渲染线程：等待帧请求，按帧率上限出帧
+    void RenderLoop();
+    void StartRenderThread();
+    void StopRenderThread();
     
     std::string id_;
     OH_NativeXComponent_Callback callback_; // 保存回调结构体
-    OHNativeWindow* nativeWindow_ = nullptr; // 指向屏幕缓冲区的句柄
     OH_NativeXComponent* component_ = nullptr; // 保存组件指针，用于主动请求重绘
     
-    // 缓存画布宽高
-    uint64_t width_ = 0;
-    uint64_t height_ = 0;
+    // 渲染目标与绘制器 (由 surfaceMutex_ 保护)：surface_ 随 XComponent 的 Surface 创建 / 销毁
+    std::unique_ptr<NativeWindowSurface> surface_;
+    WaveformRenderer renderer_;
+    uint32_t skippedFrames_ = 0; // 连续跳帧数 (渲染线程)
+    static constexpr uint32_t SKIP_LOG_INTERVAL = 60;
+    
+    // 采样历史与时钟映射：生产者推送并负责替换历史，渲染线程持历史锁读取
+    WaveformFeed feed_;
+    uint64_t drawnGeneration_ = 0; // 上一帧所用历史的代数 (渲染线程)，变化时丢弃增量绘制的内容
     
-    std::mutex dataMutex_; // 互斥锁
-    std::deque<double> speedHistory_; // 环形缓冲
-    const size_t MAX_HISTORY_SIZE = 15; // 屏幕上显示的采样点数量
-    std::atomic<bool> isRendering_{false};
+    static constexpr int64_t FRAME_INTERVAL_US = 1000000 / 60; // 帧率上限 60fps
+    std::thread renderThread_;
+    std::mutex surfaceMutex_; // 保护 surface_ / renderer_ (渲染线程 vs XComponent 生命周期回调)
+    std::mutex wakeMutex_;    // 只用于渲染线程的等待/唤醒，持有时间极短
+    std::condition_variable frameCv_;
+    std::atomic<bool> framePending_{false}; // 已有未处理的帧请求
+    std::atomic<uint64_t> frameRequests_{0};     // RequestFrame 次数
+    std::atomic<uint64_t> coalescedRequests_{0}; // 其中被合并进已挂起帧的次数
+    bool stopRender_ = false; // 由 wakeMutex_ 保护
 };
 
 #endif
@@ -0,0 +1,62 @@
+#ifndef NET_GUARDIAN_RENDER_METRICS_H
+#define NET_GUARDIAN_RENDER_METRICS_H
+
+#include <cstddef>
+#include <cstdint>
+
+// 一帧的各个阶段
+enum RenderStage {
+    RENDER_STAGE_PREPARE = 0, // 取快照、抽取、计算布局与像素纵坐标
+    RENDER_STAGE_ACQUIRE,     // 出队缓冲区 (含等待空闲缓冲区与 acquire fence)
+    RENDER_STAGE_DRAW,        // native_drawing 绘制
+    RENDER_STAGE_COPY,        // 像素搬移：增量滚动的平移，或回退路径从离屏位图拷贝到缓冲区
+    RENDER_STAGE_PRESENT,     // 计算脏区域并提交
+    RENDER_STAGE_COUNT,
+};
+
+// 阶段名 (NAPI 属性名与 hitrace 标签共用)
+const char* RenderStageName(RenderStage stage);
+
+// 一个阶段的耗时统计 (微秒)
+struct StageTiming {
+    uint64_t count = 0;
+    int64_t totalUs = 0;
+    int64_t maxUs = 0;
+    int64_t lastUs = 0;
+
+    void Record(int64_t us);
+    double AverageUs() const { return count > 0 ? static_cast<double>(totalUs) / count : 0.0; }
+};
+
+// 帧耗时直方图：按帧预算划分的固定桶，最后一档没有上限
+struct FrameTimeHistogram {
+    static constexpr size_t BUCKET_COUNT = 8;
+    static const int64_t BUCKET_UPPER_US[BUCKET_COUNT - 1]; // 各桶的上界 (不含)，单调递增
+
+    uint64_t counts[BUCKET_COUNT] = {};
+
+    void Record(int64_t us);
+    uint64_t Total() const;
+    // 第 p 分位 (0 ~ 1) 所在桶的上界，最后一档返回 -1；没有样本时返回 0
+    int64_t PercentileUpperUs(double p) const;
+};
+
+/**
+ * 渲染管线计数与计时
+ * 帧结果、各阶段耗时与帧耗时直方图由 WaveformRenderer 在渲染线程上记录；
+ * 帧请求与合并计数由 RenderManager 在生产者线程上累计，读取时合并进快照
+ */
+struct RenderMetrics {
+    uint64_t framesPresented = 0;
+    uint64_t framesSkipped = 0;     // 没有可写的缓冲区而跳过的帧
+    uint64_t framesFailed = 0;      // 资源 / 出队 / 绘制失败而丢弃的帧
+    uint64_t incrementalFrames = 0; // 只平移并重画右侧条带的帧 (其余为整帧重画)
+    uint64_t frameRequests = 0;     // 帧请求次数 (每个样本一次)
+    uint64_t coalescedRequests = 0; // 到达时已有挂起的帧、被合并进同一帧的请求
+
+    StageTiming stages[RENDER_STAGE_COUNT];
+    StageTiming frame;              // 已提交帧的总耗时
+    FrameTimeHistogram frameTimes;  // 已提交帧的耗时分布
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef NET_GUARDIAN_RENDER_SURFACE_H
+#define NET_GUARDIAN_RENDER_SURFACE_H
+
+#include <cstdint>
+
+// 从 Surface 出队的一块可写缓冲区 (RGBA_8888，premultiplied)
+struct SurfaceFrame {
+    void* pixels = nullptr;
+    int32_t stride = 0;     // 每行字节数 (>= width * 4)
+    uint64_t width = 0;
+    uint64_t height = 0;
+    int64_t bufferId = -1;  // 缓冲区标识：同一块缓冲区每次出队都相同 (如窗口缓冲区的 fd)，用于按缓冲区缓存画布
+    uint32_t epoch = 0;     // 缓冲区集合的版本：变化后之前见过的 bufferId / 像素地址全部不再可信
+    void* native = nullptr; // 实现私有的句柄 (如 OHNativeWindowBuffer*)
+};
+
+// 提交时的脏区域
+struct SurfaceDamage {
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t w = 0;
+    int32_t h = 0;
+};
+
+/**
+ * 渲染目标：出队一块缓冲区 -> 绘制 -> 提交 (或放弃)
+ * 设备上由 OHNativeWindow 实现 (NativeWindowSurface)，宿主机上由内存缓冲区实现 (HeadlessSurface)，
+ * 同一套波形绘制逻辑 (WaveformRenderer) 因此可以在宿主机上做帧耗时基准与像素级测试
+ * 缓冲区在多帧之间保留内容 (增量绘制依赖这一点)
+ */
+class RenderSurface {
+public:
+    virtual ~RenderSurface() = default;
+
+    // 当前尺寸，布局按此计算
+    virtual uint64_t Width() const = 0;
+    virtual uint64_t Height() const = 0;
+
+    enum AcquireResult {
+        ACQUIRE_OK = 0,     // 已出队，缓冲区可以写
+        ACQUIRE_NOT_READY,  // 限定时间内没有可写的缓冲区 (队列已满或合成器仍在读)，本帧应跳过，稍后重试
+        ACQUIRE_FAILED,     // 出错
+    };
+    // 出队一块可写的缓冲区：不会无限期阻塞，也不会交出合成器仍在读取的缓冲区
+    virtual AcquireResult AcquireFrame(SurfaceFrame *frame) = 0;
+    // 提交缓冲区，damage 为 nullptr 表示整屏都变了
+    virtual void PresentFrame(const SurfaceFrame &frame, const SurfaceDamage *damage) = 0;
+    // 放弃本帧，缓冲区内容不提交
+    virtual void DiscardFrame(const SurfaceFrame &frame) = 0;
+};
+
+#endif
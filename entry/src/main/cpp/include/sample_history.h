@@ -0,0 +1,64 @@
+#ifndef NET_GUARDIAN_SAMPLE_HISTORY_H
+#define NET_GUARDIAN_SAMPLE_HISTORY_H
+
+#include "spsc_ring.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// 一个采样点：时间戳 (TICK_US 为单位，只保留低 32 位) 与数值，共 8 字节，std::atomic 可以无锁读写
+struct WaveformSample {
+    uint32_t tick = 0;
+    float value = 0;
+};
+
+/**
+ * 波形图的采样历史 (固定长度，超出后丢弃最旧的点)，每个点带有到达时间，按时间轴绘制
+ * 生产者 (网络回调线程) Push / Clear，消费者 (绘制) 取快照；两侧都不加锁、不分配内存
+ * 约束：同一时刻只能有一个生产者线程和一个消费者线程；时间戳单调不减
+ */
+class SampleHistory {
+public:
+    static constexpr int64_t TICK_US = 100; // 时间戳精度 100 微秒，32 位可以表示前后约 59 小时
+
+    // 底层环形缓冲取窗口的 2 倍，绘制一帧期间生产者继续写入也不会破坏窗口
+    explicit SampleHistory(size_t capacity) : ring_(capacity * 2), capacity_(capacity) {}
+
+    // 数据入口 (生产者调用)：timeUs 为单调时钟 (微秒)
+    void Push(int64_t timeUs, double value) {
+        WaveformSample sample;
+        sample.tick = static_cast<uint32_t>(timeUs / TICK_US);
+        sample.value = static_cast<float>(value);
+        ring_.Push(sample);
+    }
+
+    void Clear() { ring_.Clear(); }
+
+    // 数据快照出口 (消费者调用)：把最近至多 Capacity() 个点按时间顺序拷贝到 out，返回点数
+    // out 至少要能容纳 Capacity() 个元素；endSeq 非空时写入最新一个点的序号 + 1 (用于增量绘制)
+    size_t Snapshot(WaveformSample *out, uint64_t *endSeq = nullptr) const {
+        return ring_.ReadLatest(out, capacity_, endSeq);
+    }
+
+    // 以 nowUs 为参照还原采样点的完整时间戳 (微秒)，两者相差须在 32 位 tick 的有符号范围内
+    // 更早的点早已滑出任何可显示的时间窗口；晚于 nowUs 的点 (取快照期间刚写入) 还原为大于 nowUs 的值
+    static int64_t SampleTimeUs(const WaveformSample &sample, int64_t nowUs) {
+        int64_t nowTick = nowUs / TICK_US;
+        int32_t age = static_cast<int32_t>(static_cast<uint32_t>(nowTick) - sample.tick);
+        return (nowTick - age) * TICK_US;
+    }
+
+    // 累计写入次数，用于判断自上次绘制以来是否有新样本
+    uint64_t TotalPushed() const { return ring_.TotalPushed(); }
+    // 最近一次 Clear 时的写入次数，变化说明历史被清空过
+    uint64_t ClearSeq() const { return ring_.StartSeq(); }
+
+    size_t Capacity() const { return capacity_; }
+
+private:
+    static_assert(std::atomic<WaveformSample>::is_always_lock_free, "WaveformSample must be lock-free");
+    SpscRing<WaveformSample> ring_;
+    size_t capacity_;
+};
+
+#endif
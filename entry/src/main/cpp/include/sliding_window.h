@@ -0,0 +1,106 @@
+#ifndef NET_GUARDIAN_SLIDING_WINDOW_H
+#define NET_GUARDIAN_SLIDING_WINDOW_H
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+/**
+ * 固定容量滑动窗口的流式统计 (均值 / 总体标准差)
+ * - 环形缓冲：构造时一次性分配，Push 不再触发堆分配
+ * - 累加和与平方和以 anchor_ 为偏移量维护，Push 为 O(1)
+ * - 每淘汰 capacity 个旧样本后整体重算一次，抑制加减抵消带来的浮点误差累积 (均摊仍为 O(1))
+ */
+class SlidingWindowStats {
+public:
+    explicit SlidingWindowStats(size_t capacity) : buffer_(capacity > 0 ? capacity : 1) {}
+
+    void Push(double value) {
+        if (count_ == 0) {
+            anchor_ = value; // 以第一个样本为偏移基准，减小平方和的量级
+        }
+
+        if (count_ == buffer_.size()) {
+            // 窗口已满：淘汰最旧的样本 (即当前写指针所在位置)
+            double old = buffer_[head_] - anchor_;
+            sum_ -= old;
+            sumSq_ -= old * old;
+            evictions_++;
+        } else {
+            count_++;
+        }
+
+        buffer_[head_] = value;
+        head_ = (head_ + 1 == buffer_.size()) ? 0 : head_ + 1;
+
+        double shifted = value - anchor_;
+        sum_ += shifted;
+        sumSq_ += shifted * shifted;
+
+        if (evictions_ >= buffer_.size()) {
+            Rebuild();
+        }
+    }
+
+    void Clear() {
+        head_ = 0;
+        count_ = 0;
+        evictions_ = 0;
+        anchor_ = 0.0;
+        sum_ = 0.0;
+        sumSq_ = 0.0;
+    }
+
+    size_t Size() const { return count_; }
+    size_t Capacity() const { return buffer_.size(); }
+    bool Empty() const { return count_ == 0; }
+
+    // 最近一次写入的样本
+    double Back() const {
+        if (count_ == 0) return 0.0;
+        return buffer_[head_ == 0 ? buffer_.size() - 1 : head_ - 1];
+    }
+
+    double Mean() const {
+        if (count_ == 0) return 0.0;
+        return anchor_ + sum_ / static_cast<double>(count_);
+    }
+
+    // 总体标准差 (除以 N)，与原先两遍扫描的 CalculateJitter 口径一致
+    double StdDev() const {
+        if (count_ < 2) return 0.0;
+        double n = static_cast<double>(count_);
+        double meanShift = sum_ / n;
+        double variance = sumSq_ / n - meanShift * meanShift;
+        return variance > 0.0 ? std::sqrt(variance) : 0.0;
+    }
+
+private:
+    // 以当前均值为新的偏移基准重算累加量
+    void Rebuild() {
+        double total = 0.0;
+        for (size_t i = 0; i < count_; i++) {
+            total += buffer_[i];
+        }
+        anchor_ = total / static_cast<double>(count_);
+
+        sum_ = 0.0;
+        sumSq_ = 0.0;
+        for (size_t i = 0; i < count_; i++) {
+            double shifted = buffer_[i] - anchor_;
+            sum_ += shifted;
+            sumSq_ += shifted * shifted;
+        }
+        evictions_ = 0;
+    }
+
+    std::vector<double> buffer_;
+    size_t head_ = 0; // 下一个写入位置
+    size_t count_ = 0;
+    size_t evictions_ = 0; // 自上次重算以来淘汰的样本数
+    double anchor_ = 0.0;
+    double sum_ = 0.0;   // Σ(x - anchor)
+    double sumSq_ = 0.0; // Σ(x - anchor)²
+};
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef NET_GUARDIAN_SPSC_RING_H
+#define NET_GUARDIAN_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * 单生产者 / 单消费者的无锁覆盖式环形缓冲
+ * - 生产者 Push 永不阻塞：缓冲满时直接覆盖最旧的元素
+ * - 消费者 ReadLatest 拷贝最近的 N 个元素，不加锁、不分配内存；
+ *   拷贝完成后重新读取写指针，丢弃拷贝期间可能被生产者覆盖的部分，保证返回的窗口是连续且一致的
+ * - 容量向上取整为 2 的幂，建议至少为消费者读取窗口的 2 倍，给生产者留出追赶余量；
+ *   下一次写入的槽位 (最旧的那个) 随时可能被覆盖，所以一次最多读出 Capacity() - 1 个元素
+ * T 需要是可平凡拷贝且 std::atomic<T> 无锁的类型 (如 double / int64_t / 8 字节的结构体)
+ */
+template <typename T> class SpscRing {
+public:
+    explicit SpscRing(size_t capacity) {
+        size_t cap = 2; // 至少能读出一个元素
+        while (cap < capacity) cap <<= 1;
+        capacity_ = cap;
+        mask_ = cap - 1;
+        slots_.reset(new std::atomic<T>[cap]);
+        for (size_t i = 0; i < cap; i++) slots_[i].store(T(), std::memory_order_relaxed);
+    }
+
+    size_t Capacity() const { return capacity_; }
+
+    // 生产者：写入一个元素
+    // 与 seqlock 的写端相同，写槽位前加 release 栅栏：消费者一旦读到这次写入的值，
+    // 其后的 acquire 栅栏保证它也能看到之前对 head_ 的所有更新 (见 ReadLatest 的覆盖检查)
+    void Push(const T &value) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slots_[head & mask_].store(value, std::memory_order_relaxed);
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    // 生产者：逻辑清空 (只移动起点，不触碰数据)
+    void Clear() {
+        start_.store(head_.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    // 消费者：把最近至多 maxCount 个元素按时间顺序拷贝到 out，返回实际个数
+    // endSeq 非空时写入最后一个元素的序号 + 1 (即第 i 个元素的序号为 *endSeq - count + i)
+    size_t ReadLatest(T *out, size_t maxCount, uint64_t *endSeq = nullptr) const {
+        uint64_t head = head_.load(std::memory_order_acquire);
+        if (endSeq != nullptr) *endSeq = head;
+        uint64_t start = start_.load(std::memory_order_acquire);
+        uint64_t available = head > start ? head - start : 0;
+        if (available > capacity_ - 1) available = capacity_ - 1;
+        size_t count = static_cast<size_t>(available < maxCount ? available : maxCount);
+        uint64_t first = head - count;
+
+        for (size_t i = 0; i < count; i++) {
+            out[i] = slots_[(first + i) & mask_].load(std::memory_order_relaxed);
+        }
+
+        // 拷贝期间生产者若已绕回覆盖了窗口开头，丢弃被覆盖的那部分
+        // 写指针为 headAfter 时，序号 headAfter 的写入可能已经写了槽位而还没推进 head_，
+        // 它覆盖的是序号 headAfter - capacity_ 的元素，所以该元素也要丢弃 (因此是 >= 与 + 1)
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t headAfter = head_.load(std::memory_order_relaxed);
+        if (headAfter - first >= capacity_) {
+            size_t overwritten = static_cast<size_t>(headAfter - first - capacity_ + 1);
+            if (overwritten >= count) return 0;
+            for (size_t i = overwritten; i < count; i++) out[i - overwritten] = out[i];
+            count -= overwritten;
+        }
+        return count;
+    }
+
+    // 自创建以来写入的元素总数 (消费者可据此判断是否有新数据)
+    uint64_t TotalPushed() const { return head_.load(std::memory_order_acquire); }
+
+    // 最近一次 Clear 时的写入序号 (从未清空时为 0)
+    uint64_t StartSeq() const { return start_.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<std::atomic<T>[]> slots_;
+    size_t capacity_ = 0;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<uint64_t> head_{0};  // 下一个写入序号 (只由生产者修改)
+    alignas(64) std::atomic<uint64_t> start_{0}; // Clear 之后的有效起点
+};
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef NET_GUARDIAN_SYNC_FENCE_H
+#define NET_GUARDIAN_SYNC_FENCE_H
+
+enum FenceWaitResult {
+    FENCE_SIGNALED = 0, // 已触发 (或没有 Fence)，缓冲区可以写
+    FENCE_TIMEOUT,      // 超时仍未触发，合成器 / GPU 还在读这块缓冲区
+    FENCE_ERROR,        // Fence 无效或处于错误状态
+};
+
+// 等待一个 sync fence (可 poll 的 fd，触发后变为可读) 最多 timeoutMs 毫秒
+// fenceFd < 0 表示没有 Fence，直接返回 FENCE_SIGNALED；timeoutMs 为 0 时只检查当前状态不等待
+// 被信号打断时按剩余时间继续等待；不关闭 fenceFd，由调用方负责
+FenceWaitResult WaitFence(int fenceFd, int timeoutMs);
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef NET_GUARDIAN_TCP_METRICS_H
+#define NET_GUARDIAN_TCP_METRICS_H
+
+#include <cstdint>
+
+/**
+ * 一条或多条 TCP 连接的传输层指标 (由引擎定期从 TCP_INFO 采样)，用来解释吞吐为什么低
+ * 发送方向的指标 (RTT / 重传 / cwnd / pacing) 只对本端发出的数据有意义：上传时反映链路，
+ * 下载时本端几乎只发 ACK，以接收方向估计的 rcvRttUs 为准，重传发生在服务端看不到
+ */
+struct TcpMetrics {
+    bool valid = false;
+    int connections = 0;      // 合并了多少条连接
+    double rttUs = 0;         // 平滑 RTT (多连接取均值)
+    double rttVarUs = 0;      // RTT 平均偏差 (多连接取均值)
+    double minRttUs = 0;      // 连接期间的最小 RTT (多连接取最小)，0 表示内核不提供
+    double rcvRttUs = 0;      // 接收方向估计的 RTT (有估计的连接取均值)，0 表示尚无估计
+    int rcvRttConnections = 0; // 参与 rcvRttUs 均值的连接数
+    uint64_t retransmits = 0; // 累计重传的段数 (多连接求和，下同)
+    uint64_t segmentsOut = 0; // 累计发出的段数 (含重传)
+    uint64_t cwnd = 0;        // 拥塞窗口 (段)
+    uint32_t mss = 0;         // 发送 MSS (多连接取最大)
+    double pacingKbps = 0;    // 内核的 pacing 速率，0 表示未知或不限速
+};
+
+// 链路状况：拥塞表现为排队 (RTT 明显高于最小 RTT)，随机丢包表现为重传多而 RTT 不涨
+enum LinkCondition {
+    LINK_UNKNOWN = 0, // 指标不足 (无效，或发出的段太少且没有 RTT 基线)
+    LINK_GOOD,
+    LINK_CONGESTED,
+    LINK_LOSSY,
+};
+
+// 把一条连接的指标合并进 total (total 初始为默认值)
+void MergeTcpMetrics(TcpMetrics *total, const TcpMetrics &connection);
+
+// 重传段数 / 发出段数，没有发出过数据时为 0
+double RetransmitRatio(const TcpMetrics &metrics);
+
+LinkCondition ClassifyLink(const TcpMetrics &metrics);
+
+#endif
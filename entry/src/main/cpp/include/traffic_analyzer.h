@@ -0,0 +1,95 @@
+#ifndef NET_GUARDIAN_TRAFFIC_ANALYZER_H
+#define NET_GUARDIAN_TRAFFIC_ANALYZER_H
+
+#include "clock_source.h"
+#include "convergence_detector.h"
+#include "sliding_window.h"
+#include "tcp_metrics.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+class TraceWriter;
+
+// 一次分析的结果，valid 为 false 表示尚未产生统计 (会话的第一个包)
+struct TrafficStats {
+    bool valid = false;
+    double instantKbps = 0; // 瞬时速度 (画波形图用)
+    double maxKbps = 0;     // 全局峰值
+    double minKbps = 0;     // 全局谷值 (稳定后)
+    double avgKbps = 0;     // 全局均值 (总流量/总时间)
+    double jitter = 0;      // 抖动
+    double totalBytes = 0;  // 总流量
+    bool stable = false;       // 速度已收敛 (见 ConvergenceDetector)，可以提前结束测量
+    double confidenceKbps = 0; // 近期均速的置信区间半宽
+    TcpMetrics tcp;            // 最近一次送入的 TCP 指标 (SetTcpMetrics)，没有时 tcp.valid 为 false
+};
+
+/**
+ * 单条流 (一个测速阶段 / 一条连接 / 一个网卡) 的流量分析器
+ * 每个实例拥有独立的窗口与全局统计，多条流可以并行测量互不干扰
+ * 非线程安全：同一实例只应在一个线程上调用
+ */
+class TrafficAnalyzer {
+public:
+    // 每产生一个新的瞬时速度样本时回调 (例如推送给波形渲染)，timestampUs 为样本所在时刻 (与 ProcessAt 同一时间基)
+    using SampleListener = std::function<void(double instantKbps, int64_t timestampUs)>;
+
+    static constexpr size_t DEFAULT_WINDOW_SIZE = 100; // 默认抖动窗口大小
+
+    explicit TrafficAnalyzer(size_t windowSize = DEFAULT_WINDOW_SIZE);
+
+    // 清空所有统计，开始新的会话
+    void Reset();
+
+    // 累加一段流量并返回最新统计 (以时钟源的当前时间作为到达时间)
+    TrafficStats Process(size_t byteLength);
+
+    // 同上，但由调用方提供到达时间 (微秒，任意单调时间基)
+    // 同一会话内的时间戳必须来自同一个时间基，与 Process 混用时需保证和时钟源同基
+    TrafficStats ProcessAt(size_t byteLength, int64_t timestampUs);
+
+    // 不累加流量，只取当前统计 (首包之前为空统计)
+    TrafficStats Current() const;
+
+    void SetSampleListener(SampleListener listener);
+
+    // 替换 Process 使用的时钟源 (不转移所有权，nullptr 恢复为 steady_clock)
+    void SetClock(ClockSource *clock) { clock_ = clock != nullptr ? clock : ClockSource::Steady(); }
+
+    // 替换收敛判定条件 (清空收敛状态)
+    void SetConvergenceConfig(const ConvergenceConfig &config) { convergence_.Configure(config); }
+    bool Stable() const { return convergence_.Stable(); }
+
+    // 记录流量所在连接的最新 TCP 指标 (由采样方定期送入)，之后的统计结果都带上它，Reset 时清空
+    void SetTcpMetrics(const TcpMetrics &metrics) { tcp_ = metrics; }
+
+    // 设置轨迹记录器 (不转移所有权，传 nullptr 停止记录)，之后每次 ProcessAt 的输入都会被追加到轨迹中
+    void SetTraceWriter(TraceWriter *writer) { traceWriter_ = writer; }
+
+private:
+    TrafficStats MakeStats(double instantKbps, double jitter) const;
+
+    static constexpr long long MIN_CALC_INTERVAL_US = 100000; // 最小计算间隔 (微秒): 100ms = 100,000us
+
+    SlidingWindowStats speedWindow_; // 最近N次瞬时速度（kbps）的流式统计
+    ConvergenceDetector convergence_; // 同一组瞬时速度样本上的收敛检测 (窗口更短，判断近期是否稳定)
+    TcpMetrics tcp_;
+    double lastJitter_ = 0; // 最近一次计算出的 Jitter，供快速路径直接返回
+    double totalBytes_ = 0; // 总流量
+    double accumulatedBytes_ = 0; // 临时累积的字节数
+    int64_t lastPacketTimeUs_ = 0; // 上一次计算样本的时间 (微秒)
+    int64_t sessionStartTimeUs_ = 0; // 整个会话开始时间 (微秒)
+    bool isFirstPacket_ = true; // 标记是否是第一个包
+
+    double globalMax_ = 0;
+    double globalAvgKbps_ = 0;
+    double globalMin_ = -1.0; // -1 表示尚未初始化
+    int sampleCount_ = 0; // 采样计数，用于忽略启动阶段
+
+    SampleListener sampleListener_;
+    TraceWriter *traceWriter_ = nullptr;
+    ClockSource *clock_ = ClockSource::Steady();
+};
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef NET_GUARDIAN_TRAFFIC_TRACE_H
+#define NET_GUARDIAN_TRAFFIC_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 流量轨迹文件 (.ngtrace)：记录送入 TrafficAnalyzer 的 (时间戳, 字节数) 序列，用于离线回放复现问题
+ *
+ * 文件布局 (小端)：
+ *   [0, 4)   magic "NGTR"
+ *   [4, 6)   版本号 (当前为 1)
+ *   [6, 8)   保留
+ *   [8, 16)  已提交的记录区字节数 (每次追加后更新，崩溃后也能知道有效数据的边界)
+ *   [16, ..) 记录区：每条记录 = zigzag varint(时间戳增量, 微秒) + varint(字节数)
+ * 第一条记录的时间增量相对 0 计算，即绝对时间戳
+ */
+constexpr uint32_t TRACE_MAGIC = 0x5254474E; // "NGTR"
+constexpr uint16_t TRACE_VERSION = 1;
+constexpr size_t TRACE_HEADER_SIZE = 16;
+constexpr size_t MAX_VARINT_BYTES = 10;
+
+struct TraceRecord {
+    int64_t timestampUs = 0;
+    uint64_t byteLength = 0;
+};
+
+// LEB128 变长整数编码，返回写入的字节数 (out 至少需要 MAX_VARINT_BYTES 字节)
+size_t EncodeVarint(uint64_t value, uint8_t *out);
+
+// 解码变长整数，返回消耗的字节数，数据不完整或超长时返回 0
+size_t DecodeVarint(const uint8_t *data, size_t size, uint64_t *value);
+
+inline uint64_t ZigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+/**
+ * 基于 mmap 的追加写入器
+ * 文件按 GROW_STEP 预扩容并整体映射，Append 只是一次内存写入，不产生系统调用
+ * (扩容时才 munmap / ftruncate / mmap)；Close 时把文件截断到实际长度
+ */
+class TraceWriter {
+public:
+    TraceWriter() = default;
+    ~TraceWriter();
+    TraceWriter(const TraceWriter &) = delete;
+    TraceWriter &operator=(const TraceWriter &) = delete;
+
+    // 创建 (覆盖) 轨迹文件，失败返回 false
+    bool Open(const std::string &path);
+    bool Append(int64_t timestampUs, uint64_t byteLength);
+    void Close();
+
+    bool IsOpen() const { return base_ != nullptr; }
+    uint64_t RecordCount() const { return recordCount_; }
+
+private:
+    bool EnsureCapacity(size_t extra);
+    void CommitLength();
+
+    static constexpr size_t GROW_STEP = 1 << 20; // 每次扩容 1MB
+
+    int fd_ = -1;
+    uint8_t *base_ = nullptr;
+    size_t mappedSize_ = 0;
+    size_t writeOffset_ = 0;
+    int64_t lastTimestampUs_ = 0;
+    uint64_t recordCount_ = 0;
+};
+
+/**
+ * 轨迹读取器：在内存中顺序解码记录
+ */
+class TraceReader {
+public:
+    // 从内存数据解析 (数据需在读取期间保持有效)
+    bool Load(const uint8_t *data, size_t size);
+    // 读取整个文件后解析
+    bool LoadFile(const std::string &path);
+
+    // 读取下一条记录，没有更多记录或数据损坏时返回 false (可用 HasError 区分)
+    bool Next(TraceRecord *record);
+    bool HasError() const { return error_; }
+
+private:
+    std::vector<uint8_t> fileData_;
+    const uint8_t *cursor_ = nullptr;
+    const uint8_t *end_ = nullptr;
+    int64_t lastTimestampUs_ = 0;
+    bool error_ = false;
+};
+
+#endif
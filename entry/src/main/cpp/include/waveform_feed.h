@@ -0,0 +1,70 @@
+#ifndef NET_GUARDIAN_WAVEFORM_FEED_H
+#define NET_GUARDIAN_WAVEFORM_FEED_H
+
+#include "sample_history.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+/**
+ * 一个波形通道的数据入口：采样历史、样本时钟到渲染时钟的映射、历史深度的切换
+ * 生产者 (分析器所在线程) Push / Clear，消费者 (渲染线程) 持 LockHistory() 读取 History()
+ * 采样历史是严格的单生产者结构：可能推送的一方先 ClaimProducer，同一时刻只有一个持有者能推送，
+ * 持有者换成别的线程时，释放与获取之间的 acq_rel 保证新生产者看到旧生产者的全部写入
+ * 历史深度可以在任意线程请求修改，但替换历史只由生产者完成：生产者在下一次 Push / Clear 时
+ * 尝试获取历史锁 (不等待)，消费者正在读取时推迟到再下一次，生产者永远不会阻塞
+ */
+class WaveformFeed {
+public:
+    static constexpr size_t DEFAULT_HISTORY_DEPTH = 15; // 默认显示的采样点数量 (约 1.5 秒)
+    static constexpr size_t MAX_HISTORY_DEPTH = 65536;
+    static constexpr int64_t MAX_SAMPLE_LAG_US = 2000000; // 映射后落后当前时刻超过 2 秒时重新锚定
+
+    explicit WaveformFeed(size_t depth = DEFAULT_HISTORY_DEPTH);
+
+    // 获取生产者身份 (任意线程)：没有持有者或已由 owner 持有时返回 true，否则返回 false
+    bool ClaimProducer(const void *owner);
+    // 释放生产者身份，owner 不是当前持有者时忽略
+    void ReleaseProducer(const void *owner);
+    // 当前持有者，nullptr 表示空闲
+    const void *Producer() const { return producer_.load(std::memory_order_acquire); }
+
+    // 生产者 (须持有生产者身份)：sampleTimeUs 为样本的时间戳 (分析器的时间基)，nowUs 为渲染时钟 (CLOCK_MONOTONIC) 的当前时刻
+    void Push(double value, int64_t sampleTimeUs, int64_t nowUs);
+    void Clear();
+
+    // 任意线程：请求修改历史深度 (2 ~ MAX_HISTORY_DEPTH)，超出范围返回 false
+    // 生产者在下一次 Push / Clear 时换上新的 (空) 历史，在此之前 HistoryDepth() 仍是旧值
+    bool RequestHistoryDepth(size_t depth);
+    // 生产者：立即换上待生效的深度，消费者正在读取时等待它读完 (只适合可以阻塞的线程)
+    void ApplyHistoryDepth();
+    // 当前生效的历史深度
+    size_t HistoryDepth() const { return depth_.load(std::memory_order_acquire); }
+
+    // 消费者：持有返回的锁期间 History() 不会被替换
+    std::unique_lock<std::mutex> LockHistory() { return std::unique_lock<std::mutex>(historyMutex_); }
+    const SampleHistory &History() const { return *history_; }
+    // 历史每被替换一次加一 (持锁读取)，消费者据此丢弃基于旧历史的增量状态
+    uint64_t HistoryGeneration() const { return generation_; }
+
+private:
+    // 生产者：有未生效的深度请求时替换历史；wait 为 false 时拿不到历史锁就推迟
+    void ApplyPendingDepth(bool wait);
+
+    std::atomic<const void *> producer_{nullptr};
+
+    std::mutex historyMutex_; // 保护 history_ 的替换 (生产者) 与读取 (消费者)
+    std::unique_ptr<SampleHistory> history_;
+    std::atomic<size_t> depth_;
+    std::atomic<size_t> requestedDepth_;
+    uint64_t generation_ = 0;
+
+    // 样本时钟到渲染时钟的映射，只在生产者线程上访问
+    int64_t clockOffsetUs_ = 0;
+    bool clockAnchored_ = false;
+    int64_t lastSampleTimeUs_ = 0;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef NET_GUARDIAN_WAVEFORM_KERNELS_H
+#define NET_GUARDIAN_WAVEFORM_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 波形绘制热路径的向量化内核
+ * arm64-v8a 使用 NEON，x86_64 使用 SSE2 (x86_64 的基线指令集，无需运行时检测)，其余平台走标量实现
+ * 定义 NET_GUARDIAN_DISABLE_SIMD 可强制使用标量实现
+ * *Scalar 版本始终可用，供测试对照与基准比较
+ */
+
+// 当前编译使用的实现："neon" / "sse2" / "scalar"
+const char *WaveformKernelBackend();
+
+// 求 data[0, count) 的最小值与最大值 (count 必须 >= 1)
+void ScanMinMax(const double *data, size_t count, double *outMin, double *outMax);
+void ScanMinMaxScalar(const double *data, size_t count, double *outMin, double *outMax);
+
+// 数值 -> 像素纵坐标：y = height - value * (height / scale)，结果写入 outY (float，直接用于构建路径)
+void ValuesToPixelY(const double *values, size_t count, double scale, int32_t height, float *outY);
+void ValuesToPixelYScalar(const double *values, size_t count, double scale, int32_t height, float *outY);
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef NET_GUARDIAN_WAVEFORM_LAYOUT_H
+#define NET_GUARDIAN_WAVEFORM_LAYOUT_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * 波形图的几何布局与增量绘制规划 (纯计算，不依赖绘图 API，可在宿主机测试)
+ *
+ * 横向是时间轴：固定时长的窗口铺满宽度，每个像素列覆盖 windowUs / width 的时间，列号按绝对时间计算
+ * (WaveformColumn)；当前时刻位于最右一列，窗口随时间按整数列平移，与样本到达的节奏无关
+ * 同一列的样本聚合为 min/max (AggregateColumns)，每个点是一列，点的横坐标是整数，
+ * 整数像素平移保证旧像素可以原样搬移，与重新绘制的结果逐像素一致
+ * 纵向：满刻度按 1-2-5 序列取整，只有刻度变化时才需要整帧重画
+ */
+struct WaveformLayout {
+    bool valid = false;
+    uint64_t endSeq = 0;       // 历史累计写入次数 (本帧包含的最新样本的序号 + 1)
+    uint64_t clearSeq = 0;     // 历史最近一次清空时的序号，变化说明旧曲线已作废
+    size_t count = 0;          // 本帧的点数 (列数)
+    int32_t width = 0;
+    int32_t height = 0;
+    int64_t windowUs = 0;      // 时间窗口长度
+    int64_t originColumn = 0;  // 屏幕 x = 0 对应的绝对列 (当前时刻所在列位于 x = width - 1)
+    int64_t firstColumn = 0;   // 第一个 / 倒数第二个 / 最后一个点的绝对列 (count 不足时无意义)
+    int64_t prevColumn = 0;
+    int64_t lastColumn = 0;
+    double scale = 0;          // Y 轴满刻度
+    int32_t top = 0;           // 曲线 (含描边余量) 覆盖的行范围 [top, bottom)，无曲线时为空
+    int32_t bottom = 0;
+    uint32_t generation = 0;   // 样式等影响全部像素的状态的版本号，不同版本之间不能增量绘制
+    bool partialTail = false;  // 最后一个点位于当前时刻所在列，之后到达的样本还会改变它的值
+
+    float ColumnX(int64_t column) const { return static_cast<float>(column - originColumn); }
+    // 与 ValuesToPixelY 的计算方式一致
+    float PointY(double value) const {
+        return static_cast<float>(height - value * (height / scale));
+    }
+    // 最后一个点仍在屏幕内 (之后还需要随时间滚动)
+    bool HasVisiblePoints() const { return count > 0 && lastColumn >= originColumn; }
+};
+
+// 从一帧过渡到另一帧的增量绘制方案
+struct WaveformScrollPlan {
+    int32_t shiftPx = 0;    // 已有像素左移的距离
+    int32_t bandTop = 0;    // 需要平移的行范围 [bandTop, bandBottom) (新旧曲线的并集；填充的左边缘在屏幕内时延伸到底部)
+    int32_t bandBottom = 0;
+    int32_t stripX = 0;     // [stripX, width) × [bandTop, height) 需要重画
+    // 与上一帧相比发生变化的矩形 (作为提交时的脏区域)
+    int32_t damageX = 0;
+    int32_t damageY = 0;
+    int32_t damageW = 0;
+    int32_t damageH = 0;
+};
+
+// timeUs 所在的绝对列：floor(timeUs * width / windowUs)
+int64_t WaveformColumn(int64_t timeUs, int32_t width, int64_t windowUs);
+
+/**
+ * 按绝对列聚合样本：同一列的样本输出一个点 (最小值 / 最大值)
+ * 列按绝对时间对齐，同一列在相邻帧里的位置和值保持不变 (末列除外，见 partialTail)，因此可以与增量滚动配合
+ * originColumn 左侧 (屏幕外) 只保留最后一列，曲线从左边界外连进来，更早的列丢弃
+ * @param times / values 按时间顺序的样本 (时间单调不减)
+ * @param outColumns / outLows / outHighs 至少能容纳 count 个元素
+ * @return 输出的点数
+ */
+size_t AggregateColumns(const int64_t *times, const double *values, size_t count, int32_t width, int64_t windowUs,
+                        int64_t originColumn, int64_t *outColumns, double *outLows, double *outHighs);
+
+// 向上取整到 1-2-5 序列，并保留 20% 顶部余量 (最小刻度 100)
+double NiceWaveformScale(double maxValue);
+
+/**
+ * 计算一帧的布局
+ * @param columns / lows / highs 每个点的绝对列、最小值与最大值 (AggregateColumns 的输出)
+ * @param nowColumn 当前时刻所在的绝对列，位于屏幕最右一列
+ * @param margin 描边半宽 + 抗锯齿余量，用于计算曲线覆盖的行范围
+ */
+WaveformLayout ComputeWaveformLayout(const int64_t *columns, const double *lows, const double *highs, size_t count,
+                                     int32_t width, int32_t height, int64_t windowUs, int64_t nowColumn,
+                                     float margin, uint32_t generation);
+
+/**
+ * 规划从 from 帧增量过渡到 to 帧：平移已有像素并重画右侧新露出的条带
+ * 调用方负责填写两帧的 endSeq / clearSeq
+ * 返回 false 表示无法增量 (尺寸 / 窗口 / 刻度 / 版本变化、历史被清空、平移超过一屏等)，需要整帧重画
+ */
+bool PlanWaveformScroll(const WaveformLayout &from, const WaveformLayout &to, float margin, WaveformScrollPlan *plan);
+
+#endif
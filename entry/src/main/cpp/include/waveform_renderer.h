@@ -0,0 +1,157 @@
+#ifndef NET_GUARDIAN_WAVEFORM_RENDERER_H
+#define NET_GUARDIAN_WAVEFORM_RENDERER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "render_metrics.h"
+#include "render_surface.h"
+#include "sample_history.h"
+#include "waveform_layout.h"
+
+#include <native_drawing/drawing_types.h>
+#include <native_drawing/drawing_canvas.h>
+#include <native_drawing/drawing_pen.h>
+#include <native_drawing/drawing_brush.h>
+#include <native_drawing/drawing_path.h>
+#include <native_drawing/drawing_bitmap.h>
+#include <native_drawing/drawing_shader_effect.h>
+#include <native_drawing/drawing_point.h>
+#include <native_drawing/drawing_rect.h>
+
+// 波形配色与描边样式 (颜色均为 0xAARRGGBB)
+struct WaveformStyle {
+    uint32_t backgroundColor = 0xFFFFFFFF; // 背景
+    uint32_t lineColor = 0xFF007DFF;       // 描边
+    uint32_t fillTopColor = 0x66007DFF;    // 填充渐变顶部
+    uint32_t fillBottomColor = 0x00007DFF; // 填充渐变底部
+    float strokeWidth = 4.0f;              // 描边宽度 (px)
+};
+
+/**
+ * 波形绘制器：取采样历史快照，按固定时长的时间窗口 (当前时刻在最右侧) 画到 RenderSurface 出队的缓冲区上并提交
+ * 与窗口、线程、NAPI 无关 (设备上由 RenderManager 驱动，宿主机上配合 HeadlessSurface 与软件光栅化替身做基准和测试)
+ * 跨帧缓存绘图资源与每块缓冲区的画布；能增量时只平移已有像素并重画新露出的条带，提交精确的脏区域
+ * 每帧按阶段计时 (RenderMetrics) 并打 hitrace 区间 (宿主机上为空操作)
+ * 非线程安全：同一时刻只能有一个线程使用
+ */
+class WaveformRenderer {
+public:
+    enum FrameResult {
+        FRAME_PRESENTED = 0,   // 已提交
+        FRAME_EMPTY_SURFACE,   // Surface 尺寸为 0，没有出帧
+        FRAME_NO_RESOURCES,    // 绘图资源创建失败
+        FRAME_UNCHANGED,       // 与上一次提交的画面相同 (没有新样本且时间窗口还没移过一列)，没有出帧
+        FRAME_SKIPPED,         // 没有可写的缓冲区，本帧跳过 (已画内容不受影响，稍后重试即可)
+        FRAME_ACQUIRE_FAILED,  // 出队出错
+        FRAME_DRAW_FAILED,     // 绘制失败，缓冲区已放弃
+    };
+
+    WaveformRenderer() = default;
+    ~WaveformRenderer();
+    WaveformRenderer(const WaveformRenderer&) = delete;
+    WaveformRenderer& operator=(const WaveformRenderer&) = delete;
+
+    // 画一帧：时间窗口 [nowUs - windowUs, nowUs] 内的样本 (nowUs 与样本时间戳同一时间基)
+    FrameResult RenderFrame(RenderSurface* surface, const SampleHistory &history, int64_t windowUs, int64_t nowUs);
+
+    // 上一次提交的画面里还有曲线：窗口需要随时间继续滚动，调用方应按帧率持续出帧
+    bool Animating() const { return lastPresented_.HasVisiblePoints(); }
+
+    // 修改配色 / 描边样式，下一帧重建画笔、画刷与渐变并整帧重画
+    void SetStyle(const WaveformStyle &style);
+    const WaveformStyle& Style() const { return style_; }
+
+    // 使已画内容全部失效 (如历史被替换)，下一帧整帧重画
+    void InvalidateContent() { contentGeneration_++; }
+
+    // 释放全部绘图资源与缓冲区画布 (Surface 销毁时调用，之后仍可继续使用)，不清零计数
+    void ReleaseResources();
+
+    // 帧结果计数、各阶段耗时与帧耗时直方图 (帧请求 / 合并计数由调用方维护)
+    const RenderMetrics& Metrics() const { return metrics_; }
+    void ResetMetrics() { metrics_ = RenderMetrics(); }
+
+    // 一块缓冲区对应的零拷贝绘制目标
+    struct BufferTarget {
+        int64_t bufferId = -1;
+        void* pixels = nullptr;
+        int32_t stride = 0;
+        uint64_t width = 0;
+        uint64_t height = 0;
+        OH_Drawing_Bitmap* bitmap = nullptr; // 以缓冲区内存为像素存储的位图
+        OH_Drawing_Canvas* canvas = nullptr;
+        WaveformLayout drawn; // 这块缓冲区当前内容对应的帧 (用于增量滚动)
+    };
+
+private:
+    // RenderFrame 的主体，外层负责整帧计时与按结果计数
+    FrameResult RenderFrameStages(RenderSurface* surface, const SampleHistory &history, int64_t windowUs,
+                                  int64_t nowUs);
+
+    // 确保绘图资源与当前高度 / 样式匹配，必要时重建
+    bool EnsureDrawingResources(uint64_t height);
+    OH_Drawing_Canvas* EnsureOffscreenCanvas(uint64_t width, uint64_t height);
+
+    // 一帧要画的点：每个点的绝对列、最小值 / 最大值及其像素纵坐标
+    struct FramePoints {
+        const int64_t* columns = nullptr;
+        const double* lows = nullptr;
+        const double* highs = nullptr;
+        const float* lowYs = nullptr;
+        const float* highYs = nullptr;
+    };
+    // 取快照、还原时间戳并按列聚合 min/max，计算本帧布局
+    WaveformLayout PrepareFrame(const SampleHistory &history, int64_t windowUs, int64_t nowUs, uint64_t width,
+                                uint64_t height, FramePoints* points);
+
+    // 在 canvas 上按 layout 画一帧波形 (受 canvas 当前裁剪区域限制)
+    void DrawWaveform(OH_Drawing_Canvas* canvas, const WaveformLayout &layout, const FramePoints &points);
+    // 增量路径：平移缓冲区里已有的像素，只重画右侧新露出的条带；无法增量时返回 false
+    bool DrawWaveformIncremental(BufferTarget* target, const WaveformLayout &layout, const FramePoints &points);
+    // 回退路径：画到离屏位图再拷贝到缓冲区
+    bool DrawWaveformWithCopy(const SurfaceFrame &frame, const WaveformLayout &layout, const FramePoints &points);
+    // 描边半宽 + 抗锯齿余量
+    float StrokeMargin() const { return style_.strokeWidth / 2 + 2.0f; }
+
+    // 缓冲区画布缓存 (按 bufferId 索引)：每块缓冲区只包装一次位图 / 画布
+    static constexpr size_t MAX_BUFFER_TARGETS = 8;
+    BufferTarget* AcquireBufferTarget(const SurfaceFrame &frame);
+    void ReleaseBufferTargets();
+
+    std::vector<WaveformSample> frameSamples_; // 绘制用的快照缓冲，每帧复用
+    std::vector<int64_t> frameTimes_;          // 还原后的样本时间戳与数值，每帧复用
+    std::vector<double> frameValues_;
+    std::vector<int64_t> frameColumns_;        // 聚合后每个点的绝对列、最小值 / 最大值，每帧复用
+    std::vector<double> frameLows_;
+    std::vector<double> frameHighs_;
+    std::vector<float> frameLowYs_;  // 每个点的像素纵坐标 (填充与描边共用)，每帧复用
+    std::vector<float> frameHighYs_;
+
+    // 跨帧复用的绘图资源：尺寸变化时重建渐变 (与离屏位图)，样式变化时重建画笔 / 画刷 / 渐变
+    struct DrawingResources {
+        OH_Drawing_Bitmap* bitmap = nullptr;  // 离屏位图，仅回退路径使用
+        OH_Drawing_Canvas* canvas = nullptr;
+        uint64_t width = 0; // 离屏位图对应的尺寸
+        uint64_t height = 0;
+        OH_Drawing_Path* fillPath = nullptr;   // 每帧 Reset 后重新构建
+        OH_Drawing_Path* strokePath = nullptr;
+        OH_Drawing_Brush* brush = nullptr;
+        OH_Drawing_Brush* backgroundBrush = nullptr; // 背景 (受裁剪区域限制，局部重画时只覆盖条带)
+        OH_Drawing_Pen* pen = nullptr;
+        OH_Drawing_ShaderEffect* shader = nullptr;
+        uint64_t shaderHeight = 0; // 渐变对应的高度
+    };
+    DrawingResources resources_;
+
+    std::vector<BufferTarget> bufferTargets_;
+    uint32_t targetEpoch_ = 0;       // bufferTargets_ 对应的 Surface 缓冲区版本
+    WaveformStyle style_;
+    bool styleDirty_ = true;
+    uint32_t contentGeneration_ = 0; // 样式 / 历史变化时递增，旧内容不能再增量复用
+    WaveformLayout lastPresented_;   // 上一次提交的帧，用于计算脏区域
+    RenderMetrics metrics_;
+};
+
+#endif
@@ -0,0 +1,1440 @@
+// NAPI 适配层：把 TrafficAnalyzer 暴露给 ArkTS，并在模块加载时挂接 XComponent 渲染
+#include "napi/native_api.h"
+#include "http_download.h"
+#include "http_upload.h"
+#include "render_manager.h"
+#include "traffic_analyzer.h"
+#include "traffic_trace.h"
+#include <hilog/log.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+// 定义日志标签
+#undef LOG_TAG
+#define LOG_TAG "NativeTraffic"
+#define LOG_DOMAIN 0x0001
+#define OH_LOG_INFO(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_INFO, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
+#define OH_LOG_ERROR(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_ERROR, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
+
+// JS 线程上所有分析器 (含模块级默认分析器) 共用的波形生产者身份：它们在同一线程上串行推送，
+// 只在每次推送时短暂持有，通道被引擎占用 (测量进行中) 时丢弃样本
+static const char g_jsThreadProducer = 0;
+
+// 共享统计缓冲区 (Float64Array) 中各字段的下标，与 index.d.ts 中 bindStatsBuffer 的说明保持一致
+enum StatsSlot : size_t {
+    SLOT_INSTANT_KBPS = 0,
+    SLOT_MAX_KBPS,
+    SLOT_MIN_KBPS,
+    SLOT_AVG_KBPS,
+    SLOT_JITTER,
+    SLOT_TOTAL_BYTES,
+    SLOT_COUNT
+};
+
+// JS 侧 TrafficAnalyzer 对象包装的原生数据
+struct AnalyzerBinding {
+    TrafficAnalyzer analyzer;
+    RenderManager *waveform = nullptr; // 样本推送到的波形通道 (XComponent id)，nullptr 表示不画波形
+
+    // 通过 bindStatsBuffer 注册的共享缓冲区，*Into 接口把统计直接写到这里
+    napi_ref statsBufferRef = nullptr; // 强引用，保证 JS 侧缓冲区在绑定期间不被回收
+    double *statsSlots = nullptr;
+    uint32_t statsSeq = 0; // 每写入一次递增 (reset 后也不回退)，0 表示还没有写入过
+
+    std::unique_ptr<TraceWriter> traceWriter; // startTrace 开启的轨迹记录 (默认关闭)
+
+    void WriteStats(const TrafficStats &stats) {
+        statsSlots[SLOT_INSTANT_KBPS] = stats.instantKbps;
+        statsSlots[SLOT_MAX_KBPS] = stats.maxKbps;
+        statsSlots[SLOT_MIN_KBPS] = stats.minKbps;
+        statsSlots[SLOT_AVG_KBPS] = stats.avgKbps;
+        statsSlots[SLOT_JITTER] = stats.jitter;
+        statsSlots[SLOT_TOTAL_BYTES] = stats.totalBytes;
+        statsSeq++;
+    }
+
+    void StopTrace() {
+        analyzer.SetTraceWriter(nullptr);
+        traceWriter.reset();
+    }
+
+    void ReleaseStatsBuffer(napi_env env) {
+        if (statsBufferRef != nullptr) {
+            napi_delete_reference(env, statsBufferRef);
+            statsBufferRef = nullptr;
+        }
+        statsSlots = nullptr;
+    }
+
+    explicit AnalyzerBinding(RenderManager *target) {
+        BindWaveform(target);
+    }
+
+    // 切换样本推送的波形通道 (nullptr 表示停止推送)
+    void BindWaveform(RenderManager *target) {
+        waveform = target;
+        if (waveform != nullptr) {
+            analyzer.SetSampleListener([target](double kbps, int64_t timeUs) {
+                if (!target->ClaimProducer(&g_jsThreadProducer)) return;
+                target->PushData(kbps, timeUs);
+                target->ReleaseProducer(&g_jsThreadProducer);
+            });
+        } else {
+            analyzer.SetSampleListener(nullptr);
+        }
+    }
+
+    void Reset() {
+        analyzer.Reset();
+        if (waveform != nullptr && waveform->ClaimProducer(&g_jsThreadProducer)) {
+            waveform->ClearData();
+            waveform->ReleaseProducer(&g_jsThreadProducer);
+        }
+    }
+};
+
+// 模块级函数 (analyzeTraffic / analyzeLength / resetState) 共用的默认分析器，保持旧接口兼容
+static AnalyzerBinding g_defaultBinding(RenderManager::GetInstance());
+
+// 设置一个 number 属性
+static void SetNumberProperty(napi_env env, napi_value object, const char *name, double value) {
+    napi_value property = nullptr;
+    napi_create_double(env, value, &property);
+    napi_set_named_property(env, object, name, property);
+}
+
+// 设置一个 string 属性
+static void SetStringProperty(napi_env env, napi_value object, const char *name, const std::string &value) {
+    napi_value property = nullptr;
+    napi_create_string_utf8(env, value.c_str(), value.size(), &property);
+    napi_set_named_property(env, object, name, property);
+}
+
+static const char *LinkConditionName(LinkCondition condition) {
+    switch (condition) {
+        case LINK_GOOD: return "good";
+        case LINK_CONGESTED: return "congested";
+        case LINK_LOSSY: return "lossy";
+        default: return "unknown";
+    }
+}
+
+// TCP 指标打包为 JS 对象 (时间换算为毫秒)，附上重传率与链路状况判断
+static napi_value CreateTcpMetricsObject(napi_env env, const TcpMetrics &tcp) {
+    napi_value object = nullptr;
+    napi_create_object(env, &object);
+    SetNumberProperty(env, object, "connections", tcp.connections);
+    SetNumberProperty(env, object, "rttMs", tcp.rttUs / 1000.0);
+    SetNumberProperty(env, object, "rttVarMs", tcp.rttVarUs / 1000.0);
+    SetNumberProperty(env, object, "minRttMs", tcp.minRttUs / 1000.0);
+    SetNumberProperty(env, object, "rcvRttMs", tcp.rcvRttUs / 1000.0);
+    SetNumberProperty(env, object, "retransmits", static_cast<double>(tcp.retransmits));
+    SetNumberProperty(env, object, "segmentsOut", static_cast<double>(tcp.segmentsOut));
+    SetNumberProperty(env, object, "retransmitRatio", RetransmitRatio(tcp));
+    SetNumberProperty(env, object, "cwnd", static_cast<double>(tcp.cwnd));
+    SetNumberProperty(env, object, "mss", tcp.mss);
+    SetNumberProperty(env, object, "pacingKbps", tcp.pacingKbps);
+    SetStringProperty(env, object, "condition", LinkConditionName(ClassifyLink(tcp)));
+    return object;
+}
+
+// 辅助函数：将统计数据打包为 JS 对象
+static napi_value CreateResultObject(napi_env env, const TrafficStats &stats) {
+    napi_value resultObject;
+    napi_create_object(env, &resultObject);
+
+    // 第一个包没有统计数据，返回空对象
+    if (!stats.valid) {
+        return resultObject;
+    }
+
+    napi_value valInstant, valMax, valMin, valAvg, valJitter, valTotal, valStable, valConfidence;
+
+    // 创建 JS Number 对象
+    napi_create_double(env, stats.instantKbps, &valInstant);
+    napi_create_double(env, stats.maxKbps, &valMax);
+    napi_create_double(env, stats.minKbps, &valMin);
+    napi_create_double(env, stats.avgKbps, &valAvg);
+    napi_create_double(env, stats.jitter, &valJitter);
+    napi_create_double(env, stats.totalBytes, &valTotal);
+    napi_get_boolean(env, stats.stable, &valStable);
+    napi_create_double(env, stats.confidenceKbps, &valConfidence);
+
+    // 设置属性
+    napi_set_named_property(env, resultObject, "instantKbps", valInstant);
+    napi_set_named_property(env, resultObject, "maxKbps", valMax);
+    napi_set_named_property(env, resultObject, "minKbps", valMin);
+    napi_set_named_property(env, resultObject, "avgKbps", valAvg);
+    napi_set_named_property(env, resultObject, "jitter", valJitter);
+    napi_set_named_property(env, resultObject, "totalBytes", valTotal);
+    napi_set_named_property(env, resultObject, "stable", valStable);
+    napi_set_named_property(env, resultObject, "confidenceKbps", valConfidence);
+    if (stats.tcp.valid) {
+        napi_set_named_property(env, resultObject, "tcp", CreateTcpMetricsObject(env, stats.tcp));
+    }
+
+    return resultObject;
+}
+
+static constexpr double MAX_JS_SAFE_INTEGER = 9007199254740992.0; // 2^53，JS number 能精确表示的整数上限
+
+// JS 传入的字节数换算为 size_t：NaN 与非正数按 0 处理，超过 2^53 的按 2^53 截断，保证转换有定义
+static size_t ToByteLength(double len) {
+    if (!(len > 0)) return 0;
+    return static_cast<size_t>(std::min(len, MAX_JS_SAFE_INTEGER));
+}
+
+// 取出 ArrayBuffer 参数的长度，失败时抛出 TypeError 并返回 false
+static bool GetArrayBufferLength(napi_env env, napi_value value, size_t *byteLength) {
+    // 参数校验，检测是否为ArrayBuffer
+    bool isArrayBuffer = false;
+    napi_is_arraybuffer(env, value, &isArrayBuffer);
+    if (!isArrayBuffer) {
+        napi_throw_type_error(env, nullptr, "Argument 0 must be an ArrayBuffer");
+        return false;
+    }
+
+    void *data = nullptr; // 指向 JS 堆外内存的物理指针
+    return napi_get_arraybuffer_info(env, value, &data, byteLength) == napi_ok;
+}
+
+// TypedArray 参数的只读视图 (直接指向 JS 堆外内存，不拷贝)
+struct NumericArrayView {
+    napi_typedarray_type type = napi_float64_array;
+    size_t length = 0;
+    void *data = nullptr;
+
+    double At(size_t i) const {
+        switch (type) {
+            case napi_uint32_array: return static_cast<const uint32_t *>(data)[i];
+            case napi_int32_array: return static_cast<const int32_t *>(data)[i];
+            case napi_float32_array: return static_cast<const float *>(data)[i];
+            default: return static_cast<const double *>(data)[i];
+        }
+    }
+};
+
+// 解析数值型 TypedArray (Float64Array / Float32Array / Uint32Array / Int32Array)，失败时抛出 TypeError
+static bool GetNumericArray(napi_env env, napi_value value, const char *errorMsg, NumericArrayView *view) {
+    bool isTypedArray = false;
+    napi_is_typedarray(env, value, &isTypedArray);
+    if (!isTypedArray) {
+        napi_throw_type_error(env, nullptr, errorMsg);
+        return false;
+    }
+
+    napi_value arrayBuffer = nullptr;
+    size_t byteOffset = 0;
+    if (napi_get_typedarray_info(env, value, &view->type, &view->length, &view->data, &arrayBuffer, &byteOffset) !=
+        napi_ok) {
+        return false;
+    }
+    if (view->type != napi_float64_array && view->type != napi_float32_array && view->type != napi_uint32_array &&
+        view->type != napi_int32_array) {
+        napi_throw_type_error(env, nullptr, errorMsg);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 解析波形通道参数，失败时抛出 TypeError 并返回 false
+ * - true: 默认通道；false / null / undefined: 不画波形 (*target 为 nullptr)
+ * - string: 指定 XComponent id 的通道 (该组件稍后创建也可以，样本会先缓存在通道的历史里)
+ */
+static bool GetWaveformChannel(napi_env env, napi_value value, RenderManager **target) {
+    napi_valuetype type = napi_undefined;
+    napi_typeof(env, value, &type);
+    *target = nullptr;
+    if (type == napi_undefined || type == napi_null) {
+        return true;
+    }
+    if (type == napi_boolean) {
+        bool enabled = false;
+        napi_get_value_bool(env, value, &enabled);
+        *target = enabled ? RenderManager::GetInstance() : nullptr;
+        return true;
+    }
+    size_t length = 0;
+    if (type != napi_string || napi_get_value_string_utf8(env, value, nullptr, 0, &length) != napi_ok ||
+        length == 0 || length > OH_XCOMPONENT_ID_LEN_MAX) {
+        napi_throw_type_error(env, nullptr, "Waveform channel must be a boolean or a non-empty XComponent id");
+        return false;
+    }
+    std::string id(length, '\0');
+    napi_get_value_string_utf8(env, value, &id[0], length + 1, &length);
+    *target = RenderManager::GetInstance(id);
+    return true;
+}
+
+// 可选的通道参数：省略时为默认通道
+static bool GetOptionalWaveformChannel(napi_env env, size_t argc, napi_value *args, size_t index,
+                                       RenderManager **target) {
+    napi_valuetype type = napi_undefined;
+    if (argc > index) napi_typeof(env, args[index], &type);
+    if (type == napi_undefined) {
+        *target = RenderManager::GetInstance();
+        return true;
+    }
+    if (!GetWaveformChannel(env, args[index], target)) return false;
+    if (*target == nullptr) {
+        napi_throw_type_error(env, nullptr, "Waveform channel must be an XComponent id");
+        return false;
+    }
+    return true;
+}
+
+// 从 this 上解包出 AnalyzerBinding
+static AnalyzerBinding *UnwrapBinding(napi_env env, napi_value thisArg) {
+    AnalyzerBinding *binding = nullptr;
+    if (napi_unwrap(env, thisArg, reinterpret_cast<void **>(&binding)) != napi_ok || binding == nullptr) {
+        napi_throw_error(env, nullptr, "TrafficAnalyzer is not initialized");
+        return nullptr;
+    }
+    return binding;
+}
+
+// 重置状态 (供 JS 调用)
+static napi_value ResetState(napi_env env, napi_callback_info info) {
+    g_defaultBinding.Reset();
+    OH_LOG_INFO("Traffic Analyzer State Reset");
+    return nullptr;
+}
+
+/**
+ * 接口1：处理 ArrayBuffer (下载用)
+ * analyzeTraffic(buffer: ArrayBuffer)
+ */
+static napi_value AnalyzeTraffic(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+
+    // 获取JS传入的参数, info 是回调上下文，args将存储JS对象的句柄（Handle）
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    size_t byteLength = 0; // 数据的长度
+    if (!GetArrayBufferLength(env, args[0], &byteLength)) return nullptr;
+
+    return CreateResultObject(env, g_defaultBinding.analyzer.Process(byteLength));
+}
+
+/**
+ * 接口2：处理数值长度 (上传用)
+ * analyzeLength(byteLength: number)
+ */
+static napi_value AnalyzeLength(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    double len = 0;
+    // 获取 Number 值
+    napi_status status = napi_get_value_double(env, args[0], &len);
+    if (status != napi_ok) return nullptr;
+
+    return CreateResultObject(env, g_defaultBinding.analyzer.Process(ToByteLength(len)));
+}
+
+// 波形通道正被测量引擎占用时抛出错误并返回 false (JS 线程上的分析器只在推送时短暂持有，这里看不到)
+static bool CheckWaveformIdle(napi_env env, RenderManager *waveform) {
+    if (waveform != nullptr && waveform->Producer() != nullptr) {
+        napi_throw_error(env, nullptr, "Waveform channel is in use by a running engine");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * TrafficAnalyzer 构造函数
+ * new TrafficAnalyzer(waveform?: boolean | string)
+ * waveform 为 true 时样本推送到默认波形通道，为字符串时推送到该 XComponent id 对应的通道；
+ * 通道上有引擎正在测量时抛出错误 (一个通道同一时刻只有一个生产者)
+ */
+static napi_value AnalyzerConstructor(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    RenderManager *waveform = nullptr;
+    if (argc >= 1 && !GetWaveformChannel(env, args[0], &waveform)) return nullptr;
+    if (!CheckWaveformIdle(env, waveform)) return nullptr;
+
+    auto *binding = new AnalyzerBinding(waveform);
+    napi_status status = napi_wrap(
+        env, thisArg, binding,
+        [](napi_env env, void *data, void *hint) {
+            auto *binding = static_cast<AnalyzerBinding *>(data);
+            binding->ReleaseStatsBuffer(env);
+            binding->StopTrace();
+            delete binding;
+        },
+        nullptr, nullptr);
+    if (status != napi_ok) {
+        delete binding;
+        napi_throw_error(env, nullptr, "Failed to wrap TrafficAnalyzer");
+        return nullptr;
+    }
+    return thisArg;
+}
+
+// TrafficAnalyzer.prototype.analyzeTraffic(buffer: ArrayBuffer)
+static napi_value AnalyzerAnalyzeTraffic(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    size_t byteLength = 0;
+    if (!GetArrayBufferLength(env, args[0], &byteLength)) return nullptr;
+
+    return CreateResultObject(env, binding->analyzer.Process(byteLength));
+}
+
+// TrafficAnalyzer.prototype.analyzeLength(byteLength: number)，NaN 与非正数按 0 处理 (与 analyzeLengthInto 一致)
+static napi_value AnalyzerAnalyzeLength(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    double len = 0;
+    if (napi_get_value_double(env, args[0], &len) != napi_ok) return nullptr;
+
+    return CreateResultObject(env, binding->analyzer.Process(ToByteLength(len)));
+}
+
+// 解析 (byteLengths, timestampsMs?, count?) 参数并逐段送入分析器，参数错误时抛出异常并返回 false
+static bool ProcessBatchArgs(napi_env env, TrafficAnalyzer &analyzer, size_t argc, napi_value *args,
+                             TrafficStats *stats) {
+    NumericArrayView lengths;
+    if (argc < 1 || !GetNumericArray(env, args[0], "Argument 0 must be a numeric TypedArray", &lengths)) {
+        return false;
+    }
+    size_t count = lengths.length;
+
+    NumericArrayView timestamps;
+    bool hasTimestamps = false;
+    if (argc >= 2) {
+        napi_valuetype tsType = napi_undefined;
+        napi_typeof(env, args[1], &tsType);
+        if (tsType != napi_undefined && tsType != napi_null) {
+            if (!GetNumericArray(env, args[1], "Argument 1 must be a numeric TypedArray", &timestamps)) {
+                return false;
+            }
+            hasTimestamps = true;
+            count = std::min(count, timestamps.length);
+        }
+    }
+
+    if (argc >= 3) {
+        double requested = 0;
+        if (napi_get_value_double(env, args[2], &requested) == napi_ok) {
+            if (!(requested >= 0 && requested <= MAX_JS_SAFE_INTEGER)) {
+                napi_throw_range_error(env, nullptr, "count must be a finite non-negative number");
+                return false;
+            }
+            count = std::min(count, static_cast<size_t>(requested));
+        }
+    }
+
+    if (count == 0) {
+        *stats = analyzer.Current();
+        return true;
+    }
+
+    if (hasTimestamps) {
+        // 先整批检查时间戳，出错时一段也不处理；上限保证换算成微秒不溢出 int64_t
+        for (size_t i = 0; i < count; i++) {
+            double timestampMs = timestamps.At(i);
+            if (!(timestampMs >= 0 && timestampMs <= MAX_JS_SAFE_INTEGER)) {
+                napi_throw_range_error(env, nullptr, "timestampsMs must be finite non-negative numbers");
+                return false;
+            }
+        }
+        for (size_t i = 0; i < count; i++) {
+            int64_t timestampUs = static_cast<int64_t>(timestamps.At(i) * 1000.0);
+            *stats = analyzer.ProcessAt(ToByteLength(lengths.At(i)), timestampUs);
+        }
+    } else {
+        // 没有时间戳：整批视为同一时刻到达，合并为一次处理
+        double total = 0;
+        for (size_t i = 0; i < count; i++) {
+            total += static_cast<double>(ToByteLength(lengths.At(i)));
+        }
+        *stats = analyzer.Process(ToByteLength(total));
+    }
+    return true;
+}
+
+/**
+ * TrafficAnalyzer.prototype.analyzeTrafficBatch(byteLengths, timestampsMs?, count?)
+ * 一次 NAPI 调用处理多段流量，只返回处理完最后一段后的统计
+ * - byteLengths: 每段的字节数
+ * - timestampsMs: 每段的到达时间 (毫秒，单调时间基)，省略时全部视为当前时刻到达
+ * - count: 只处理前 count 个元素，便于 JS 复用预分配的数组
+ */
+static napi_value AnalyzerAnalyzeTrafficBatch(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    TrafficStats stats;
+    if (!ProcessBatchArgs(env, binding->analyzer, argc, args, &stats)) return nullptr;
+    return CreateResultObject(env, stats);
+}
+
+/**
+ * TrafficAnalyzer.prototype.bindStatsBuffer(buffer: Float64Array | null)
+ * 注册共享统计缓冲区，之后 *Into 接口把统计原地写入，不再为每次调用创建 JS 对象
+ * 传 null 解除绑定
+ */
+static napi_value AnalyzerBindStatsBuffer(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    binding->ReleaseStatsBuffer(env);
+
+    napi_valuetype type = napi_undefined;
+    if (argc >= 1) {
+        napi_typeof(env, args[0], &type);
+    }
+    if (type == napi_undefined || type == napi_null) {
+        return nullptr;
+    }
+
+    bool isTypedArray = false;
+    napi_is_typedarray(env, args[0], &isTypedArray);
+    napi_typedarray_type arrayType = napi_int8_array;
+    size_t length = 0;
+    void *data = nullptr;
+    napi_value arrayBuffer = nullptr;
+    size_t byteOffset = 0;
+    if (!isTypedArray ||
+        napi_get_typedarray_info(env, args[0], &arrayType, &length, &data, &arrayBuffer, &byteOffset) != napi_ok ||
+        arrayType != napi_float64_array) {
+        napi_throw_type_error(env, nullptr, "Argument 0 must be a Float64Array");
+        return nullptr;
+    }
+    if (length < SLOT_COUNT) {
+        napi_throw_range_error(env, nullptr, "Stats buffer must hold at least 6 elements");
+        return nullptr;
+    }
+
+    if (napi_create_reference(env, args[0], 1, &binding->statsBufferRef) != napi_ok) {
+        napi_throw_error(env, nullptr, "Failed to retain stats buffer");
+        return nullptr;
+    }
+    binding->statsSlots = static_cast<double *>(data);
+
+    // 如果已经有统计，先写入一次，保证缓冲区与分析器状态一致
+    TrafficStats current = binding->analyzer.Current();
+    if (current.valid) {
+        binding->WriteStats(current);
+    }
+    return nullptr;
+}
+
+// 把统计写入共享缓冲区并返回序号 (首包之前返回 0，缓冲区内容不变)
+static napi_value WriteStatsAndGetSeq(napi_env env, AnalyzerBinding *binding, const TrafficStats &stats) {
+    if (stats.valid) {
+        binding->WriteStats(stats);
+    }
+    napi_value seq = nullptr;
+    napi_create_uint32(env, binding->statsSeq, &seq);
+    return seq;
+}
+
+// 取出绑定了共享缓冲区的 AnalyzerBinding，未绑定时抛出异常
+static AnalyzerBinding *UnwrapBoundBinding(napi_env env, napi_value thisArg) {
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding != nullptr && binding->statsSlots == nullptr) {
+        napi_throw_error(env, nullptr, "Call bindStatsBuffer() before using *Into methods");
+        return nullptr;
+    }
+    return binding;
+}
+
+// TrafficAnalyzer.prototype.analyzeLengthInto(byteLength: number): number
+static napi_value AnalyzerAnalyzeLengthInto(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBoundBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    double len = 0;
+    if (napi_get_value_double(env, args[0], &len) != napi_ok) return nullptr;
+
+    return WriteStatsAndGetSeq(env, binding, binding->analyzer.Process(ToByteLength(len)));
+}
+
+// TrafficAnalyzer.prototype.analyzeTrafficBatchInto(byteLengths, timestampsMs?, count?): number
+static napi_value AnalyzerAnalyzeTrafficBatchInto(napi_env env, napi_callback_info info) {
+    size_t argc = 3;
+    napi_value args[3] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBoundBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    TrafficStats stats;
+    if (!ProcessBatchArgs(env, binding->analyzer, argc, args, &stats)) return nullptr;
+    return WriteStatsAndGetSeq(env, binding, stats);
+}
+
+/**
+ * TrafficAnalyzer.prototype.startTrace(path: string): boolean
+ * 开始把送入分析器的 (时间戳, 字节数) 序列记录到轨迹文件 (覆盖已有文件)，用于离线回放
+ */
+static napi_value AnalyzerStartTrace(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    size_t pathLength = 0;
+    if (argc < 1 || napi_get_value_string_utf8(env, args[0], nullptr, 0, &pathLength) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "Argument 0 must be a file path string");
+        return nullptr;
+    }
+    std::string path(pathLength, '\0');
+    napi_get_value_string_utf8(env, args[0], &path[0], pathLength + 1, &pathLength);
+
+    binding->StopTrace();
+    auto writer = std::make_unique<TraceWriter>();
+    bool opened = writer->Open(path);
+    if (opened) {
+        binding->traceWriter = std::move(writer);
+        binding->analyzer.SetTraceWriter(binding->traceWriter.get());
+        OH_LOG_INFO("Traffic trace started: %{public}s", path.c_str());
+    } else {
+        OH_LOG_ERROR("Failed to open traffic trace: %{public}s", path.c_str());
+    }
+
+    napi_value result = nullptr;
+    napi_get_boolean(env, opened, &result);
+    return result;
+}
+
+/**
+ * TrafficAnalyzer.prototype.stopTrace(): number
+ * 停止记录并关闭轨迹文件，返回记录条数
+ */
+static napi_value AnalyzerStopTrace(napi_env env, napi_callback_info info) {
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    double records = binding->traceWriter ? static_cast<double>(binding->traceWriter->RecordCount()) : 0;
+    binding->StopTrace();
+
+    napi_value result = nullptr;
+    napi_create_double(env, records, &result);
+    return result;
+}
+
+/**
+ * TrafficAnalyzer.prototype.useCoarseClock(enable: boolean)
+ * 逐包路径 (analyzeTraffic / analyzeLength / 无时间戳的批量接口) 改用 CLOCK_MONOTONIC_COARSE 取时间，
+ * 降低每次调用的读时钟开销；与默认时钟同基，可随时切换
+ */
+static napi_value AnalyzerUseCoarseClock(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    bool enable = true;
+    if (argc >= 1) {
+        napi_get_value_bool(env, args[0], &enable);
+    }
+    binding->analyzer.SetClock(enable ? ClockSource::CoarseMonotonic() : ClockSource::Steady());
+    return nullptr;
+}
+
+// TrafficAnalyzer.prototype.reset()
+static napi_value AnalyzerReset(napi_env env, napi_callback_info info) {
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, nullptr, nullptr, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    binding->Reset();
+    return nullptr;
+}
+
+/**
+ * TrafficAnalyzer.prototype.bindWaveform(channel: boolean | string | null)
+ * 把之后的样本改为推送到另一个波形通道 (null / false 停止推送)，不清空任何一侧已有的波形；
+ * 目标通道上有引擎正在测量时抛出错误
+ */
+static napi_value AnalyzerBindWaveform(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    AnalyzerBinding *binding = UnwrapBinding(env, thisArg);
+    if (binding == nullptr) return nullptr;
+
+    RenderManager *waveform = nullptr;
+    if (argc >= 1 && !GetWaveformChannel(env, args[0], &waveform)) return nullptr;
+    if (!CheckWaveformIdle(env, waveform)) return nullptr;
+    binding->BindWaveform(waveform);
+    return nullptr;
+}
+
+// 读取对象上的可选数值属性，属性不存在或不是 number 时保持 *value 不变
+static void GetOptionalNumberProperty(napi_env env, napi_value object, const char *name, double *value) {
+    bool hasProperty = false;
+    napi_has_named_property(env, object, name, &hasProperty);
+    if (!hasProperty) return;
+    napi_value property = nullptr;
+    napi_valuetype type = napi_undefined;
+    napi_get_named_property(env, object, name, &property);
+    napi_typeof(env, property, &type);
+    if (type == napi_number) {
+        napi_get_value_double(env, property, value);
+    }
+}
+
+static constexpr double MAX_STROKE_WIDTH = 256.0; // 描边宽度上限 (像素)
+
+// 颜色须为 [0, 0xFFFFFFFF] 内的整数，NaN 与小数都不接受
+static bool IsColorValue(double value) {
+    return value >= 0 && value <= 4294967295.0 && std::floor(value) == value;
+}
+
+/**
+ * setWaveformStyle(style, channel?)：修改原生波形图的配色与描边，未提供的字段保持当前值
+ * 颜色为 0xAARRGGBB 数值；channel 为 XComponent id，省略时修改默认通道
+ */
+static napi_value SetWaveformStyle(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    napi_valuetype type = napi_undefined;
+    if (argc >= 1) napi_typeof(env, args[0], &type);
+    if (type != napi_object) {
+        napi_throw_type_error(env, nullptr, "Argument 0 must be a style object");
+        return nullptr;
+    }
+
+    RenderManager *waveform = nullptr;
+    if (!GetOptionalWaveformChannel(env, argc, args, 1, &waveform)) return nullptr;
+
+    WaveformStyle currentStyle = waveform->GetWaveformStyle();
+    double backgroundColor = currentStyle.backgroundColor;
+    double lineColor = currentStyle.lineColor;
+    double fillTopColor = currentStyle.fillTopColor;
+    double fillBottomColor = currentStyle.fillBottomColor;
+    double strokeWidth = currentStyle.strokeWidth;
+    GetOptionalNumberProperty(env, args[0], "backgroundColor", &backgroundColor);
+    GetOptionalNumberProperty(env, args[0], "lineColor", &lineColor);
+    GetOptionalNumberProperty(env, args[0], "fillTopColor", &fillTopColor);
+    GetOptionalNumberProperty(env, args[0], "fillBottomColor", &fillBottomColor);
+    GetOptionalNumberProperty(env, args[0], "strokeWidth", &strokeWidth);
+    if (!(strokeWidth > 0 && strokeWidth <= MAX_STROKE_WIDTH)) {
+        napi_throw_range_error(env, nullptr, "strokeWidth must be a finite number in (0, 256]");
+        return nullptr;
+    }
+    if (!IsColorValue(backgroundColor) || !IsColorValue(lineColor) || !IsColorValue(fillTopColor) ||
+        !IsColorValue(fillBottomColor)) {
+        napi_throw_range_error(env, nullptr, "Colors must be integers between 0 and 0xFFFFFFFF");
+        return nullptr;
+    }
+
+    currentStyle.backgroundColor = static_cast<uint32_t>(backgroundColor);
+    currentStyle.lineColor = static_cast<uint32_t>(lineColor);
+    currentStyle.fillTopColor = static_cast<uint32_t>(fillTopColor);
+    currentStyle.fillBottomColor = static_cast<uint32_t>(fillBottomColor);
+    currentStyle.strokeWidth = static_cast<float>(strokeWidth);
+    waveform->SetWaveformStyle(currentStyle);
+    return nullptr;
+}
+
+/**
+ * setHistoryDepth(depth, channel?)：修改原生波形图保留的样本数 (会清空已有波形)
+ * 超过像素宽度的部分按列做 min/max 抽取，绘制开销只与宽度相关；channel 省略时修改默认通道
+ * 测量进行中也可以调用：新深度由推送样本的线程在下一个样本时生效
+ */
+static napi_value SetHistoryDepth(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    int64_t depth = 0;
+    if (argc < 1 || napi_get_value_int64(env, args[0], &depth) != napi_ok) {
+        napi_throw_type_error(env, nullptr, "Argument 0 must be a number");
+        return nullptr;
+    }
+    RenderManager *waveform = nullptr;
+    if (!GetOptionalWaveformChannel(env, argc, args, 1, &waveform)) return nullptr;
+    if (depth < 2 || !waveform->SetHistoryDepth(static_cast<size_t>(depth))) {
+        napi_throw_range_error(env, nullptr, "depth out of range");
+        return nullptr;
+    }
+    return nullptr;
+}
+
+// 一个阶段的耗时统计 (微秒) 打包为 JS 对象
+static napi_value CreateStageTimingObject(napi_env env, const StageTiming &timing) {
+    napi_value object = nullptr;
+    napi_create_object(env, &object);
+    SetNumberProperty(env, object, "count", static_cast<double>(timing.count));
+    SetNumberProperty(env, object, "totalUs", static_cast<double>(timing.totalUs));
+    SetNumberProperty(env, object, "avgUs", timing.AverageUs());
+    SetNumberProperty(env, object, "maxUs", static_cast<double>(timing.maxUs));
+    SetNumberProperty(env, object, "lastUs", static_cast<double>(timing.lastUs));
+    return object;
+}
+
+// 帧耗时直方图打包为 { boundsUs, counts }，counts 比 boundsUs 多一个无上限的末档
+static napi_value CreateHistogramObject(napi_env env, const FrameTimeHistogram &histogram) {
+    napi_value object = nullptr;
+    napi_value bounds = nullptr;
+    napi_value counts = nullptr;
+    napi_create_object(env, &object);
+    napi_create_array_with_length(env, FrameTimeHistogram::BUCKET_COUNT - 1, &bounds);
+    napi_create_array_with_length(env, FrameTimeHistogram::BUCKET_COUNT, &counts);
+    for (size_t i = 0; i < FrameTimeHistogram::BUCKET_COUNT; i++) {
+        napi_value value = nullptr;
+        if (i < FrameTimeHistogram::BUCKET_COUNT - 1) {
+            napi_create_double(env, static_cast<double>(FrameTimeHistogram::BUCKET_UPPER_US[i]), &value);
+            napi_set_element(env, bounds, static_cast<uint32_t>(i), value);
+        }
+        napi_create_double(env, static_cast<double>(histogram.counts[i]), &value);
+        napi_set_element(env, counts, static_cast<uint32_t>(i), value);
+    }
+    napi_set_named_property(env, object, "boundsUs", bounds);
+    napi_set_named_property(env, object, "counts", counts);
+    return object;
+}
+
+/**
+ * getRenderMetrics(channel?)：原生波形渲染管线的计数与计时 (自 Surface 首次创建起累计)
+ * channel 为 XComponent id，省略时读取默认通道
+ */
+static napi_value GetRenderMetrics(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
+
+    RenderManager *waveform = nullptr;
+    if (!GetOptionalWaveformChannel(env, argc, args, 0, &waveform)) return nullptr;
+    RenderMetrics metrics = waveform->GetRenderMetrics();
+
+    napi_value result = nullptr;
+    napi_create_object(env, &result);
+    SetNumberProperty(env, result, "framesPresented", static_cast<double>(metrics.framesPresented));
+    SetNumberProperty(env, result, "framesSkipped", static_cast<double>(metrics.framesSkipped));
+    SetNumberProperty(env, result, "framesFailed", static_cast<double>(metrics.framesFailed));
+    SetNumberProperty(env, result, "incrementalFrames", static_cast<double>(metrics.incrementalFrames));
+    SetNumberProperty(env, result, "frameRequests", static_cast<double>(metrics.frameRequests));
+    SetNumberProperty(env, result, "coalescedRequests", static_cast<double>(metrics.coalescedRequests));
+
+    napi_value stages = nullptr;
+    napi_create_object(env, &stages);
+    for (int stage = 0; stage < RENDER_STAGE_COUNT; stage++) {
+        napi_set_named_property(env, stages, RenderStageName(static_cast<RenderStage>(stage)),
+                                CreateStageTimingObject(env, metrics.stages[stage]));
+    }
+    napi_set_named_property(env, result, "stages", stages);
+    napi_set_named_property(env, result, "frame", CreateStageTimingObject(env, metrics.frame));
+    napi_set_named_property(env, result, "frameTimes", CreateHistogramObject(env, metrics.frameTimes));
+    return result;
+}
+
+// 读取对象上的可选字符串属性，属性不存在或不是 string 时保持 *value 不变
+static void GetOptionalStringProperty(napi_env env, napi_value object, const char *name, std::string *value) {
+    bool hasProperty = false;
+    napi_has_named_property(env, object, name, &hasProperty);
+    if (!hasProperty) return;
+    napi_value property = nullptr;
+    napi_valuetype type = napi_undefined;
+    napi_get_named_property(env, object, name, &property);
+    napi_typeof(env, property, &type);
+    if (type != napi_string) return;
+    size_t length = 0;
+    napi_get_value_string_utf8(env, property, nullptr, 0, &length);
+    std::string text(length, '\0');
+    napi_get_value_string_utf8(env, property, &text[0], length + 1, &length);
+    *value = text;
+}
+
+// 读取对象上的可选布尔属性，属性不存在或不是 boolean 时保持 *value 不变
+static void GetOptionalBoolProperty(napi_env env, napi_value object, const char *name, bool *value) {
+    bool hasProperty = false;
+    napi_has_named_property(env, object, name, &hasProperty);
+    if (!hasProperty) return;
+    napi_value property = nullptr;
+    napi_valuetype type = napi_undefined;
+    napi_get_named_property(env, object, name, &property);
+    napi_typeof(env, property, &type);
+    if (type == napi_boolean) {
+        napi_get_value_bool(env, property, value);
+    }
+}
+
+/**
+ * JS 侧 DownloadEngine / UploadEngine 对象包装的原生数据
+ * 两种引擎的 Start / Stop / 回调形式相同：周期性上报 Report，结束时给出 Result
+ */
+template <typename Engine, typename Report, typename Result>
+struct EngineBinding {
+    // 引擎线程投递给 JS 线程的消息：周期性上报或最终结果
+    struct Message {
+        bool finished = false;
+        Report report;
+        Result result;
+    };
+
+    Engine engine;
+    RenderManager *waveform = nullptr; // 引擎分析器推送样本的波形通道，可为空
+
+    // 以下只在一次测量期间有效 (start 到 Promise 兑现)：引擎线程经 tsfn 把上报与结果投递回 JS 线程
+    napi_threadsafe_function tsfn = nullptr;
+    napi_deferred deferred = nullptr;
+    napi_ref selfRef = nullptr;     // 测量期间持有 JS 对象，避免引擎还在运行时被回收
+    napi_ref onReportRef = nullptr; // 可选的上报回调
+
+    bool InRun() const { return deferred != nullptr; }
+
+    void EndRun(napi_env env) {
+        if (waveform != nullptr) waveform->ReleaseProducer(this); // 引擎线程已回收，交还通道
+        if (selfRef != nullptr) napi_delete_reference(env, selfRef);
+        if (onReportRef != nullptr) napi_delete_reference(env, onReportRef);
+        selfRef = nullptr;
+        onReportRef = nullptr;
+        deferred = nullptr;
+        tsfn = nullptr; // 引擎线程投递完结果后已释放
+    }
+};
+
+using DownloadEngineBinding = EngineBinding<HttpDownloadEngine, DownloadReport, DownloadResult>;
+using UploadEngineBinding = EngineBinding<HttpUploadEngine, UploadReport, UploadResult>;
+
+static const char *DownloadEndReasonName(DownloadEndReason reason) {
+    switch (reason) {
+        case DOWNLOAD_COMPLETED: return "completed";
+        case DOWNLOAD_DURATION: return "duration";
+        case DOWNLOAD_BYTES: return "bytes";
+        case DOWNLOAD_CONVERGED: return "converged";
+        case DOWNLOAD_STOPPED: return "stopped";
+        default: return "failed";
+    }
+}
+
+static const char *UploadEndReasonName(UploadEndReason reason) {
+    switch (reason) {
+        case UPLOAD_COMPLETED: return "completed";
+        case UPLOAD_EARLY_RESPONSE: return "earlyResponse";
+        case UPLOAD_DURATION: return "duration";
+        case UPLOAD_CONVERGED: return "converged";
+        case UPLOAD_STOPPED: return "stopped";
+        default: return "failed";
+    }
+}
+
+static const char *StreamStateName(StreamState state) {
+    switch (state) {
+        case STREAM_CONNECTING: return "connecting";
+        case STREAM_RECEIVING: return "receiving";
+        case STREAM_COMPLETED: return "completed";
+        default: return "failed";
+    }
+}
+
+// 单条流打包为 { state, httpStatus, bytes, stats, straggler }
+static napi_value CreateStreamReportObject(napi_env env, const StreamReport &stream) {
+    napi_value object = nullptr;
+    napi_value straggler = nullptr;
+    napi_create_object(env, &object);
+    SetStringProperty(env, object, "state", StreamStateName(stream.state));
+    SetNumberProperty(env, object, "httpStatus", stream.httpStatus);
+    SetNumberProperty(env, object, "bytes", static_cast<double>(stream.bytes));
+    napi_set_named_property(env, object, "stats", CreateResultObject(env, stream.stats));
+    napi_get_boolean(env, stream.straggler, &straggler);
+    napi_set_named_property(env, object, "straggler", straggler);
+    return object;
+}
+
+// 下载聚合结果打包为 { stats, bytes, elapsedMs, contentLength, streams, fairness, stragglers }
+static napi_value CreateEngineReportObject(napi_env env, const DownloadReport &report) {
+    napi_value object = nullptr;
+    napi_create_object(env, &object);
+    napi_set_named_property(env, object, "stats", CreateResultObject(env, report.stats));
+    SetNumberProperty(env, object, "bytes", static_cast<double>(report.bytes));
+    SetNumberProperty(env, object, "elapsedMs", static_cast<double>(report.elapsedUs) / 1000.0);
+    SetNumberProperty(env, object, "contentLength", static_cast<double>(report.contentLength));
+    napi_value streams = nullptr;
+    napi_create_array_with_length(env, report.streams.size(), &streams);
+    for (size_t i = 0; i < report.streams.size(); i++) {
+        napi_set_element(env, streams, static_cast<uint32_t>(i), CreateStreamReportObject(env, report.streams[i]));
+    }
+    napi_set_named_property(env, object, "streams", streams);
+    SetNumberProperty(env, object, "fairness", report.fairness);
+    SetNumberProperty(env, object, "stragglers", report.stragglers);
+    return object;
+}
+
+// 上传聚合结果打包为 { stats, sentBytes, ackedBytes, totalBytes, elapsedMs }
+static napi_value CreateEngineReportObject(napi_env env, const UploadReport &report) {
+    napi_value object = nullptr;
+    napi_create_object(env, &object);
+    napi_set_named_property(env, object, "stats", CreateResultObject(env, report.stats));
+    SetNumberProperty(env, object, "sentBytes", static_cast<double>(report.sentBytes));
+    SetNumberProperty(env, object, "ackedBytes", static_cast<double>(report.ackedBytes));
+    SetNumberProperty(env, object, "totalBytes", static_cast<double>(report.totalBytes));
+    SetNumberProperty(env, object, "elapsedMs", static_cast<double>(report.elapsedUs) / 1000.0);
+    return object;
+}
+
+// 最终结果：结束时的聚合结果 + { reason, httpStatus, error? }
+static napi_value CreateEngineResultObject(napi_env env, const DownloadResult &result) {
+    napi_value object = CreateEngineReportObject(env, result.last);
+    SetStringProperty(env, object, "reason", DownloadEndReasonName(result.reason));
+    SetNumberProperty(env, object, "httpStatus", result.httpStatus);
+    if (result.reason == DOWNLOAD_FAILED) SetStringProperty(env, object, "error", result.error);
+    return object;
+}
+
+// 最终结果：结束时的聚合结果 + { reason, httpStatus, sendfileUsed, error? }
+static napi_value CreateEngineResultObject(napi_env env, const UploadResult &result) {
+    napi_value object = CreateEngineReportObject(env, result.last);
+    napi_value sendfileUsed = nullptr;
+    SetStringProperty(env, object, "reason", UploadEndReasonName(result.reason));
+    SetNumberProperty(env, object, "httpStatus", result.httpStatus);
+    napi_get_boolean(env, result.sendfileUsed, &sendfileUsed);
+    napi_set_named_property(env, object, "sendfileUsed", sendfileUsed);
+    if (result.reason == UPLOAD_FAILED) SetStringProperty(env, object, "error", result.error);
+    return object;
+}
+
+// tsfn 在 JS 线程上的回调：上报交给 onReport，结果兑现 start 返回的 Promise
+template <typename Binding>
+static void DeliverEngineMessage(napi_env env, napi_value jsCallback, void *context, void *data) {
+    std::unique_ptr<typename Binding::Message> message(static_cast<typename Binding::Message *>(data));
+    auto *binding = static_cast<Binding *>(context);
+    if (env == nullptr || message == nullptr) {
+        return; // 环境正在销毁
+    }
+    if (!message->finished) {
+        if (binding->onReportRef == nullptr) return;
+        napi_value callback = nullptr;
+        napi_value undefined = nullptr;
+        napi_get_reference_value(env, binding->onReportRef, &callback);
+        napi_get_undefined(env, &undefined);
+        napi_value argv[1] = {CreateEngineReportObject(env, message->report)};
+        napi_call_function(env, undefined, callback, 1, argv, nullptr);
+        return;
+    }
+    binding->engine.Join(); // 结果是引擎线程的最后一个动作，这里只是回收线程
+    napi_deferred deferred = binding->deferred;
+    binding->EndRun(env);
+    napi_resolve_deferred(env, deferred, CreateEngineResultObject(env, message->result));
+}
+
+// 从 this 上解包出引擎绑定，className 来自 napi_define_class 的 data
+template <typename Binding>
+static Binding *UnwrapEngine(napi_env env, napi_callback_info info, size_t *argc, napi_value *args,
+                             napi_value *thisArg) {
+    void *className = nullptr;
+    napi_get_cb_info(env, info, argc, args, thisArg, &className);
+    Binding *binding = nullptr;
+    if (napi_unwrap(env, *thisArg, reinterpret_cast<void **>(&binding)) != napi_ok || binding == nullptr) {
+        std::string message = std::string(static_cast<const char *>(className)) + " is not initialized";
+        napi_throw_error(env, nullptr, message.c_str());
+        return nullptr;
+    }
+    return binding;
+}
+
+/**
+ * DownloadEngine / UploadEngine 构造函数
+ * new DownloadEngine(waveform?: boolean | string)，波形通道参数与 TrafficAnalyzer 相同
+ */
+template <typename Binding>
+static napi_value EngineConstructor(napi_env env, napi_callback_info info) {
+    size_t argc = 1;
+    napi_value args[1] = {nullptr};
+    napi_value thisArg = nullptr;
+    napi_get_cb_info(env, info, &argc, args, &thisArg, nullptr);
+
+    RenderManager *waveform = nullptr;
+    if (argc >= 1 && !GetWaveformChannel(env, args[0], &waveform)) return nullptr;
+
+    auto *binding = new Binding();
+    binding->waveform = waveform;
+    if (waveform != nullptr) {
+        // 测量期间引擎持有通道的生产者身份 (见 StartEngine)，引擎线程是唯一的生产者
+        binding->engine.Analyzer().SetSampleListener(
+            [waveform](double kbps, int64_t timeUs) { waveform->PushData(kbps, timeUs); });
+    }
+    napi_status status = napi_wrap(
+        env, thisArg, binding,
+        [](napi_env env, void *data, void *hint) {
+            // 测量期间 selfRef 保持对象存活，走到这里时引擎已经结束 (或整个环境正在退出)
+            auto *binding = static_cast<Binding *>(data);
+            binding->engine.Stop();
+            binding->engine.Join();
+            if (binding->waveform != nullptr) binding->waveform->ReleaseProducer(binding);
+            delete binding;
+        },
+        nullptr, nullptr);
+    if (status != napi_ok) {
+        delete binding;
+        napi_throw_error(env, nullptr, "Failed to wrap native engine");
+        return nullptr;
+    }
+    return thisArg;
+}
+
+// 引擎数值参数的上限：超出时抛出 RangeError，同时保证换算成微秒 / int / uint64_t 时不会溢出
+static constexpr double MAX_ENGINE_DURATION_MS = 24.0 * 3600 * 1000;   // 一天
+static constexpr double MAX_ENGINE_CONNECT_TIMEOUT_MS = 10.0 * 60 * 1000; // 十分钟
+static constexpr double MAX_ENGINE_REPORT_INTERVAL_MS = 60.0 * 1000;    // 一分钟
+static constexpr double MAX_ENGINE_BYTES = MAX_JS_SAFE_INTEGER;          // 字节数上限
+
+// 读取两种引擎共有的参数 (url 必填且须为 http://，其余可选)，并检查 onReport 参数；失败时已抛出异常
+template <typename Options>
+static bool GetEngineOptions(napi_env env, size_t argc, napi_value *args, Options *options) {
+    napi_valuetype type = napi_undefined;
+    if (argc >= 1) napi_typeof(env, args[0], &type);
+    if (type != napi_object) {
+        napi_throw_type_error(env, nullptr, "Argument 0 must be an options object");
+        return false;
+    }
+    HttpUrl url;
+    GetOptionalStringProperty(env, args[0], "url", &options->url);
+    if (!ParseHttpUrl(options->url, &url)) {
+        napi_throw_type_error(env, nullptr, "options.url must be an http:// URL");
+        return false;
+    }
+    double durationMs = static_cast<double>(options->durationUs) / 1000.0;
+    double connectTimeoutMs = options->connectTimeoutMs;
+    double reportIntervalMs = static_cast<double>(options->reportIntervalUs) / 1000.0;
+    GetOptionalNumberProperty(env, args[0], "durationMs", &durationMs);
+    GetOptionalNumberProperty(env, args[0], "connectTimeoutMs", &connectTimeoutMs);
+    GetOptionalNumberProperty(env, args[0], "reportIntervalMs", &reportIntervalMs);
+    GetOptionalStringProperty(env, args[0], "tracePath", &options->tracePath);
+    // 比较写成 !(x <= max) 的形式，NaN 也会被拒绝
+    if (!std::isfinite(durationMs) || !(durationMs <= MAX_ENGINE_DURATION_MS)) {
+        napi_throw_range_error(env, nullptr, "durationMs must be finite and at most 24 hours (<= 0 for no limit)");
+        return false;
+    }
+    if (!(connectTimeoutMs >= 1 && connectTimeoutMs <= MAX_ENGINE_CONNECT_TIMEOUT_MS)) {
+        napi_throw_range_error(env, nullptr, "connectTimeoutMs must be between 1 and 600000");
+        return false;
+    }
+    if (!(reportIntervalMs >= 1 && reportIntervalMs <= MAX_ENGINE_REPORT_INTERVAL_MS)) {
+        napi_throw_range_error(env, nullptr, "reportIntervalMs must be between 1 and 60000");
+        return false;
+    }
+    // 收敛提前结束：stableTolerance 为置信区间半宽与均值之比的上限
+    ConvergenceConfig &convergence = options->convergence;
+    double minDurationMs = static_cast<double>(convergence.minDurationUs) / 1000.0;
+    GetOptionalBoolProperty(env, args[0], "stopWhenStable", &options->stopWhenStable);
+    GetOptionalNumberProperty(env, args[0], "minDurationMs", &minDurationMs);
+    GetOptionalNumberProperty(env, args[0], "stableTolerance", &convergence.maxConfidenceRatio);
+    if (!(minDurationMs >= 0 && minDurationMs <= MAX_ENGINE_DURATION_MS) ||
+        !(convergence.maxConfidenceRatio > 0 && std::isfinite(convergence.maxConfidenceRatio))) {
+        napi_throw_range_error(env, nullptr, "minDurationMs must be >= 0 and stableTolerance positive");
+        return false;
+    }
+    convergence.minDurationUs = static_cast<int64_t>(minDurationMs * 1000.0);
+    options->durationUs = static_cast<int64_t>(std::max(durationMs, 0.0) * 1000.0);
+    options->connectTimeoutMs = static_cast<int>(connectTimeoutMs);
+    options->reportIntervalUs = static_cast<int64_t>(reportIntervalMs * 1000.0);
+
+    napi_valuetype callbackType = napi_undefined;
+    if (argc >= 2) napi_typeof(env, args[1], &callbackType);
+    if (callbackType != napi_undefined && callbackType != napi_null && callbackType != napi_function) {
+        napi_throw_type_error(env, nullptr, "Argument 1 must be a function");
+        return false;
+    }
+    return true;
+}
+
+// 参数就绪后启动引擎：占用波形通道，创建 Promise 与 tsfn，测量期间持有 this 与 onReport
+// 通道的生产者身份在 EndRun (Promise 兑现或启动失败) 时交还
+template <typename Binding, typename Options>
+static napi_value StartEngine(napi_env env, Binding *binding, napi_value thisArg, const Options &options,
+                              napi_value onReport, const char *resourceName) {
+    if (binding->waveform != nullptr && !binding->waveform->ClaimProducer(binding)) {
+        napi_throw_error(env, nullptr, "Waveform channel is in use by another engine");
+        return nullptr;
+    }
+    napi_value promise = nullptr;
+    napi_value resource = nullptr;
+    napi_create_string_utf8(env, resourceName, NAPI_AUTO_LENGTH, &resource);
+    if (napi_create_promise(env, &binding->deferred, &promise) != napi_ok ||
+        napi_create_threadsafe_function(env, nullptr, nullptr, resource, 0, 1, nullptr, nullptr, binding,
+                                        DeliverEngineMessage<Binding>, &binding->tsfn) != napi_ok) {
+        binding->EndRun(env);
+        napi_throw_error(env, nullptr, "Failed to create engine callbacks");
+        return nullptr;
+    }
+    napi_create_reference(env, thisArg, 1, &binding->selfRef);
+    napi_valuetype callbackType = napi_undefined;
+    if (onReport != nullptr) napi_typeof(env, onReport, &callbackType);
+    if (callbackType == napi_function) {
+        napi_create_reference(env, onReport, 1, &binding->onReportRef);
+    }
+
+    if (binding->waveform != nullptr) binding->waveform->ClearData(); // 新测量从空波形开始
+
+    // 上报按非阻塞方式投递 (队列不限长，JS 线程繁忙时也不会卡住收发)；结果投递后释放 tsfn
+    using Message = typename Binding::Message;
+    napi_threadsafe_function tsfn = binding->tsfn;
+    bool started = binding->engine.Start(
+        options,
+        [tsfn](const decltype(Message::report) &report) {
+            auto *message = new Message();
+            message->report = report;
+            if (napi_call_threadsafe_function(tsfn, message, napi_tsfn_nonblocking) != napi_ok) delete message;
+        },
+        [tsfn](const decltype(Message::result) &result) {
+            auto *message = new Message();
+            message->finished = true;
+            message->result = result;
+            if (napi_call_threadsafe_function(tsfn, message, napi_tsfn_nonblocking) != napi_ok) delete message;
+            napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+        });
+    if (!started) {
+        napi_release_threadsafe_function(tsfn, napi_tsfn_release);
+        binding->EndRun(env);
+        napi_throw_error(env, nullptr, "Failed to start native engine");
+        return nullptr;
+    }
+    return promise;
+}
+
+// DownloadEngine.prototype.stop() / UploadEngine.prototype.stop()：请求结束当前测量，Promise 随后以 'stopped' 兑现
+template <typename Binding>
+static napi_value EngineStop(napi_env env, napi_callback_info info) {
+    napi_value thisArg = nullptr;
+    Binding *binding = UnwrapEngine<Binding>(env, info, nullptr, nullptr, &thisArg);
+    if (binding == nullptr) return nullptr;
+    binding->engine.Stop();
+    return nullptr;
+}
+
+/**
+ * DownloadEngine.prototype.start(options, onReport?): Promise<DownloadResult>
+ * 在原生线程上下载 options.url 并测速，数据在原生层读入后直接丢弃；
+ * 每 reportIntervalMs 在 JS 线程上调用一次 onReport(report)，结束 (含失败与 stop) 时兑现 Promise
+ */
+static napi_value DownloadEngineStart(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_value thisArg = nullptr;
+    DownloadEngineBinding *binding = UnwrapEngine<DownloadEngineBinding>(env, info, &argc, args, &thisArg);
+    if (binding == nullptr) return nullptr;
+    if (binding->InRun()) {
+        napi_throw_error(env, nullptr, "DownloadEngine is already running");
+        return nullptr;
+    }
+
+    DownloadOptions options;
+    if (!GetEngineOptions(env, argc, args, &options)) return nullptr;
+    double streams = options.streams;
+    double maxBytes = 0;
+    GetOptionalNumberProperty(env, args[0], "streams", &streams);
+    GetOptionalNumberProperty(env, args[0], "maxBytes", &maxBytes);
+    if (!(streams >= 1 && streams <= MAX_DOWNLOAD_STREAMS)) {
+        napi_throw_range_error(env, nullptr, "streams must be between 1 and 16");
+        return nullptr;
+    }
+    if (!(maxBytes <= MAX_ENGINE_BYTES)) {
+        napi_throw_range_error(env, nullptr, "maxBytes must be at most 2^53");
+        return nullptr;
+    }
+    options.streams = static_cast<int>(streams);
+    options.maxBytes = maxBytes > 0 ? static_cast<uint64_t>(maxBytes) : 0;
+    return StartEngine(env, binding, thisArg, options, argc >= 2 ? args[1] : nullptr, "NetGuardianDownload");
+}
+
+/**
+ * UploadEngine.prototype.start(options, onReport?): Promise<UploadResult>
+ * 在原生线程上向 options.url POST totalBytes 字节的正文并测速，正文由固定大小的模板反复发送；
+ * 速度按对端已确认的字节计算，上报与结束方式同 DownloadEngine
+ */
+static napi_value UploadEngineStart(napi_env env, napi_callback_info info) {
+    size_t argc = 2;
+    napi_value args[2] = {nullptr};
+    napi_value thisArg = nullptr;
+    UploadEngineBinding *binding = UnwrapEngine<UploadEngineBinding>(env, info, &argc, args, &thisArg);
+    if (binding == nullptr) return nullptr;
+    if (binding->InRun()) {
+        napi_throw_error(env, nullptr, "UploadEngine is already running");
+        return nullptr;
+    }
+
+    UploadOptions options;
+    if (!GetEngineOptions(env, argc, args, &options)) return nullptr;
+    double totalBytes = static_cast<double>(options.totalBytes);
+    double patternSize = static_cast<double>(options.patternSize);
+    std::string sendMode = "writev";
+    GetOptionalNumberProperty(env, args[0], "totalBytes", &totalBytes);
+    GetOptionalNumberProperty(env, args[0], "patternSize", &patternSize);
+    GetOptionalStringProperty(env, args[0], "sendMode", &sendMode);
+    if (!(totalBytes >= 0 && totalBytes <= MAX_ENGINE_BYTES)) {
+        napi_throw_range_error(env, nullptr, "totalBytes must be between 0 and 2^53");
+        return nullptr;
+    }
+    if (!(patternSize >= 1 && patternSize <= 16 * 1024 * 1024)) {
+        napi_throw_range_error(env, nullptr, "patternSize must be between 1 and 16 MiB");
+        return nullptr;
+    }
+    if (sendMode != "writev" && sendMode != "sendfile") {
+        napi_throw_type_error(env, nullptr, "sendMode must be 'writev' or 'sendfile'");
+        return nullptr;
+    }
+    options.totalBytes = static_cast<uint64_t>(totalBytes);
+    options.patternSize = static_cast<size_t>(patternSize);
+    options.sendMode = sendMode == "sendfile" ? UPLOAD_SEND_SENDFILE : UPLOAD_SEND_WRITEV;
+    return StartEngine(env, binding, thisArg, options, argc >= 2 ? args[1] : nullptr, "NetGuardianUpload");
+}
+
+// 注册 TrafficAnalyzer 类
+static void DefineAnalyzerClass(napi_env env, napi_value exports) {
+    napi_property_descriptor methods[] = {
+        { "analyzeTraffic", nullptr, AnalyzerAnalyzeTraffic, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "analyzeLength", nullptr, AnalyzerAnalyzeLength, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "analyzeTrafficBatch", nullptr, AnalyzerAnalyzeTrafficBatch, nullptr, nullptr, nullptr, napi_default,
+          nullptr },
+        { "bindStatsBuffer", nullptr, AnalyzerBindStatsBuffer, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "analyzeLengthInto", nullptr, AnalyzerAnalyzeLengthInto, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "analyzeTrafficBatchInto", nullptr, AnalyzerAnalyzeTrafficBatchInto, nullptr, nullptr, nullptr,
+          napi_default, nullptr },
+        { "useCoarseClock", nullptr, AnalyzerUseCoarseClock, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "startTrace", nullptr, AnalyzerStartTrace, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "stopTrace", nullptr, AnalyzerStopTrace, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "bindWaveform", nullptr, AnalyzerBindWaveform, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "reset", nullptr, AnalyzerReset, nullptr, nullptr, nullptr, napi_default, nullptr },
+    };
+
+    napi_value analyzerClass = nullptr;
+    napi_status status = napi_define_class(env, "TrafficAnalyzer", NAPI_AUTO_LENGTH, AnalyzerConstructor, nullptr,
+                                           sizeof(methods) / sizeof(methods[0]), methods, &analyzerClass);
+    if (status != napi_ok) {
+        OH_LOG_ERROR("Failed to define TrafficAnalyzer class: %{public}d", status);
+        return;
+    }
+    napi_set_named_property(env, exports, "TrafficAnalyzer", analyzerClass);
+}
+
+// 注册 DownloadEngine / UploadEngine 类 (类名同时作为方法回调的 data，用于报错信息)
+static void DefineEngineClass(napi_env env, napi_value exports, const char *name, napi_callback constructor,
+                              napi_callback start, napi_callback stop) {
+    void *data = const_cast<char *>(name);
+    napi_property_descriptor methods[] = {
+        { "start", nullptr, start, nullptr, nullptr, nullptr, napi_default, data },
+        { "stop", nullptr, stop, nullptr, nullptr, nullptr, napi_default, data },
+    };
+
+    napi_value engineClass = nullptr;
+    napi_status status = napi_define_class(env, name, NAPI_AUTO_LENGTH, constructor, data,
+                                           sizeof(methods) / sizeof(methods[0]), methods, &engineClass);
+    if (status != napi_ok) {
+        OH_LOG_ERROR("Failed to define %{public}s class: %{public}d", name, status);
+        return;
+    }
+    napi_set_named_property(env, exports, name, engineClass);
+}
+
+// 模块初始化注册
+EXTERN_C_START
+static napi_value Init(napi_env env, napi_value exports){
+    napi_property_descriptor desc[] = {
+        { "analyzeTraffic", nullptr, AnalyzeTraffic, nullptr, nullptr, nullptr, napi_default, nullptr},
+        { "analyzeLength", nullptr, AnalyzeLength, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "resetState", nullptr, ResetState, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setWaveformStyle", nullptr, SetWaveformStyle, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "setHistoryDepth", nullptr, SetHistoryDepth, nullptr, nullptr, nullptr, napi_default, nullptr },
+        { "getRenderMetrics", nullptr, GetRenderMetrics, nullptr, nullptr, nullptr, napi_default, nullptr },
+//        { "registerXComponent", nullptr, RegisterXComponent, nullptr, nullptr, nullptr, napi_default, nullptr }
+    };
+    napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
+    DefineAnalyzerClass(env, exports);
+    DefineEngineClass(env, exports, "DownloadEngine", EngineConstructor<DownloadEngineBinding>, DownloadEngineStart,
+                      EngineStop<DownloadEngineBinding>);
+    DefineEngineClass(env, exports, "UploadEngine", EngineConstructor<UploadEngineBinding>, UploadEngineStart,
+                      EngineStop<UploadEngineBinding>);
+
+    // 当 ArkTS 设置了 libraryname 时，系统会把 NativeXComponent 挂载在 exports 上
+    napi_value exportInstance = nullptr;
+    napi_status status = napi_get_named_property(env, exports, OH_NATIVE_XCOMPONENT_OBJ, &exportInstance);
+
+    if(status == napi_ok) {
+        OH_NativeXComponent* nativeXComponent = nullptr;
+        // 解包出指针
+        status = napi_unwrap(env, exportInstance, reinterpret_cast<void**>(&nativeXComponent));
+
+        if(status == napi_ok && nativeXComponent != nullptr) {
+            // 每个 XComponent 都会以自己的 exports 调用一次 Init，按组件 id 挂到对应的实例上
+            char id[OH_XCOMPONENT_ID_LEN_MAX + 1] = {};
+            uint64_t idSize = OH_XCOMPONENT_ID_LEN_MAX + 1;
+            if (OH_NativeXComponent_GetXComponentId(nativeXComponent, id, &idSize) ==
+                OH_NATIVEXCOMPONENT_RESULT_SUCCESS) {
+                OH_LOG_INFO("Successfully retrieved OH_NativeXComponent: %{public}s", id);
+                // 立即注册回调
+                RenderManager::GetInstance(id)->RegisterCallback(nativeXComponent);
+            } else {
+                OH_LOG_ERROR("Failed to get XComponent id");
+            }
+        } else {
+            OH_LOG_ERROR("Failed to unwrap OH_NativeXComponent");
+        }
+    }
+    return exports;
+}
+EXTERN_C_END
+
+// 模块定义
+static napi_module demoModule = {
+    .nm_version = 1,
+    .nm_flags = 0,
+    .nm_filename = nullptr,
+    .nm_register_func = Init,
+    .nm_modname = "net_guardian",
+    .nm_priv = ((void*)0),
+    .reserved = {0},
+};
+
+// 注册入口
+extern "C" __attribute__((constructor)) void RegisterNetGuardianModule(void) {
+    napi_module_register(&demoModule);
+}
@@ -0,0 +1,184 @@
+// OHNativeWindow 渲染目标：RequestBuffer / FlushBuffer / AbortBuffer、acquire fence 等待与按 fd 缓存的缓冲区映射
+#include "native_window_surface.h"
+#include "sync_fence.h"
+#include <hilog/log.h>
+#include <native_buffer/native_buffer.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#undef LOG_TAG
+#define LOG_TAG "NativeRender"
+#define LOG_DOMAIN 0x001
+#define OH_LOG_INFO(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_INFO, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
+#define OH_LOG_ERROR(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_ERROR, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
+
+// RequestBuffer 在超时内没有空闲缓冲区时的返回值 (NATIVE_ERROR_NO_BUFFER / GSERROR_NO_BUFFER)
+static const int32_t REQUEST_NO_BUFFER = 40601000;
+
+NativeWindowSurface::NativeWindowSurface(OHNativeWindow *window) : window_(window) {
+    uint64_t usage = NATIVEBUFFER_USAGE_CPU_READ | NATIVEBUFFER_USAGE_CPU_WRITE;
+    int32_t ret = OH_NativeWindow_NativeWindowHandleOpt(window_, SET_USAGE, usage);
+    if (ret != 0) {
+        OH_LOG_ERROR("Set Usage failed: %{public}d", ret);
+    }
+    OH_NativeWindow_NativeWindowHandleOpt(window_, SET_FORMAT, NATIVEBUFFER_PIXEL_FMT_RGBA_8888);
+    // 队列满时 RequestBuffer 最多等一帧，不会把渲染线程无限期挂住
+    OH_NativeWindow_NativeWindowHandleOpt(window_, SET_TIMEOUT, REQUEST_TIMEOUT_MS);
+
+    // 三缓冲：一块在屏幕上、一块排队等合成、一块给我们画；队列更浅时跳帧会明显变多
+    int32_t queueSize = 0;
+    if (OH_NativeWindow_NativeWindowHandleOpt(window_, GET_BUFFERQUEUE_SIZE, &queueSize) == 0) {
+        OH_LOG_INFO("Buffer queue size: %{public}d", queueSize);
+        if (queueSize > 0 && queueSize < 3) {
+            OH_LOG_ERROR("Buffer queue shallower than triple buffering: %{public}d", queueSize);
+        }
+    }
+}
+
+NativeWindowSurface::~NativeWindowSurface() {
+    ReleasePendingBuffer();
+    ReleaseMappings();
+}
+
+void NativeWindowSurface::ReleasePendingBuffer() {
+    if (pendingBuffer_ != nullptr) {
+        OH_NativeWindow_NativeWindowAbortBuffer(window_, pendingBuffer_);
+        pendingBuffer_ = nullptr;
+    }
+    if (pendingFence_ >= 0) {
+        close(pendingFence_);
+        pendingFence_ = -1;
+    }
+}
+
+void NativeWindowSurface::Resize(uint64_t width, uint64_t height) {
+    // 暂存的缓冲区按旧尺寸分配，先还给队列
+    ReleasePendingBuffer();
+    width_ = width;
+    height_ = height;
+    OH_NativeWindow_NativeWindowHandleOpt(window_, SET_BUFFER_GEOMETRY, static_cast<int32_t>(width),
+                                          static_cast<int32_t>(height));
+    // 尺寸变化后缓冲区会重新分配，旧的 fd 映射不能再用
+    ReleaseMappings();
+}
+
+NativeWindowSurface::BufferMapping *NativeWindowSurface::AcquireMapping(BufferHandle *handle) {
+    if (handle == nullptr || handle->stride < handle->width * 4) {
+        return nullptr;
+    }
+
+    for (auto it = mappings_.begin(); it != mappings_.end(); ++it) {
+        if (it->fd != handle->fd) continue;
+        // 同一个 fd 但几何信息或系统映射地址变了，说明缓冲区已被重新分配，丢弃旧映射
+        bool sameBuffer = it->width == handle->width && it->height == handle->height && it->stride == handle->stride &&
+            it->bufferSize == handle->size && (handle->virAddr == nullptr || handle->virAddr == it->pixels);
+        if (sameBuffer) return &*it;
+        if (it->mappedSize > 0) munmap(it->pixels, it->mappedSize);
+        mappings_.erase(it);
+        epoch_++;
+        break;
+    }
+
+    // 缓存超过上限时认为缓冲队列已整体轮换，全部释放后重建
+    if (mappings_.size() >= MAX_BUFFER_MAPPINGS) {
+        ReleaseMappings();
+    }
+
+    BufferMapping mapping;
+    mapping.fd = handle->fd;
+    mapping.width = handle->width;
+    mapping.height = handle->height;
+    mapping.stride = handle->stride;
+    mapping.bufferSize = handle->size;
+    mapping.pixels = handle->virAddr;
+    if (mapping.pixels == nullptr) {
+        // 系统没有映射，自行 mmap 一次并缓存，之后的帧不再重复映射
+        void *mapped = mmap(nullptr, handle->size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd, 0);
+        if (mapped == MAP_FAILED) {
+            OH_LOG_ERROR("mmap failed!");
+            return nullptr;
+        }
+        mapping.pixels = mapped;
+        mapping.mappedSize = handle->size;
+    }
+    mappings_.push_back(mapping);
+    return &mappings_.back();
+}
+
+void NativeWindowSurface::ReleaseMappings() {
+    for (auto &mapping : mappings_) {
+        if (mapping.mappedSize > 0) munmap(mapping.pixels, mapping.mappedSize);
+    }
+    mappings_.clear();
+    epoch_++;
+}
+
+RenderSurface::AcquireResult NativeWindowSurface::AcquireFrame(SurfaceFrame *frame) {
+    // 上一帧因 Fence 未触发而暂存的缓冲区优先：它还在我们手里，重新出队只会拿到另一块
+    OHNativeWindowBuffer *buffer = pendingBuffer_;
+    int fenceFd = pendingFence_;
+    pendingBuffer_ = nullptr;
+    pendingFence_ = -1;
+    if (buffer == nullptr) {
+        // 请求一块空闲的 Graphic Buffer，队列已满时最多等待 REQUEST_TIMEOUT_MS
+        int32_t ret = OH_NativeWindow_NativeWindowRequestBuffer(window_, &buffer, &fenceFd);
+        if (ret == REQUEST_NO_BUFFER) {
+            return ACQUIRE_NOT_READY;
+        }
+        if (ret != 0 || buffer == nullptr) {
+            OH_LOG_ERROR("RequestBuffer failed: %{public}d", ret);
+            return ACQUIRE_FAILED;
+        }
+    }
+
+    // 如果有 Fence (fd 可以是 0)，必须等合成器 / GPU 用完这块 Buffer 才能写
+    FenceWaitResult waited = WaitFence(fenceFd, FENCE_WAIT_MS);
+    if (waited == FENCE_TIMEOUT) {
+        // 跳帧：不放弃缓冲区 (放弃后再出队可能拿到不带 Fence 的同一块)，留到下一帧继续等
+        pendingBuffer_ = buffer;
+        pendingFence_ = fenceFd;
+        return ACQUIRE_NOT_READY;
+    }
+    if (fenceFd >= 0) {
+        close(fenceFd);
+    }
+    if (waited == FENCE_ERROR) {
+        OH_LOG_ERROR("Wait acquire fence failed");
+        OH_NativeWindow_NativeWindowAbortBuffer(window_, buffer);
+        return ACQUIRE_FAILED;
+    }
+
+    BufferHandle *handle = OH_NativeWindow_GetBufferHandleFromNative(buffer);
+    BufferMapping *mapping = AcquireMapping(handle);
+    if (mapping == nullptr) {
+        OH_NativeWindow_NativeWindowAbortBuffer(window_, buffer);
+        return ACQUIRE_FAILED;
+    }
+    frame->pixels = mapping->pixels;
+    frame->stride = mapping->stride;
+    frame->width = static_cast<uint64_t>(mapping->width);
+    frame->height = static_cast<uint64_t>(mapping->height);
+    frame->bufferId = mapping->fd;
+    frame->epoch = epoch_;
+    frame->native = buffer;
+    return ACQUIRE_OK;
+}
+
+void NativeWindowSurface::PresentFrame(const SurfaceFrame &frame, const SurfaceDamage *damage) {
+    // 提交 Buffer (Flush), 将画好的内容交给屏幕合成器
+    Region::Rect rect = {0, 0, 0, 0};
+    Region region = {nullptr, 0};
+    if (damage != nullptr) {
+        rect.x = damage->x;
+        rect.y = damage->y;
+        rect.w = static_cast<uint32_t>(damage->w);
+        rect.h = static_cast<uint32_t>(damage->h);
+        region.rects = &rect;
+        region.rectNumber = 1;
+    }
+    OH_NativeWindow_NativeWindowFlushBuffer(window_, static_cast<OHNativeWindowBuffer *>(frame.native), -1, region);
+}
+
+void NativeWindowSurface::DiscardFrame(const SurfaceFrame &frame) {
+    OH_NativeWindow_NativeWindowAbortBuffer(window_, static_cast<OHNativeWindowBuffer *>(frame.native));
+}
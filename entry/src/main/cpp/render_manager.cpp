@@ -1,11 +1,10 @@
 #include "render_manager.h"
+#include "clock_source.h"
 #include <cstdint>
 #include <hilog/log.h>
 #include <algorithm>
-#include <string.h>
-#include <native_buffer/native_buffer.h>
-#include <sys/mman.h>
-#include <unistd.h>
+#include <chrono>
+#include <map>
 
 #undef LOG_TAG
 #define LOG_TAG "NativeRender"
@@ -13,85 +12,219 @@
 #define OH_LOG_INFO(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_INFO, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
 #define OH_LOG_ERROR(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_ERROR, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
 
-static RenderManager g_instance;
+// 按 XComponent id 索引的实例表。用函数内静态变量保证在其他翻译单元的静态对象 (如默认分析器) 之前完成构造
+struct RenderRegistry {
+    std::mutex mutex;
+    std::map<std::string, std::unique_ptr<RenderManager>> instances;
+};
+
+static RenderRegistry &GetRegistry() {
+    static RenderRegistry registry;
+    return registry;
+}
+
+RenderManager::RenderManager(std::string id) : id_(std::move(id)) {}
 
 RenderManager *RenderManager::GetInstance() {
-    return &g_instance;
+    return GetInstance(DEFAULT_ID);
+}
+
+RenderManager *RenderManager::GetInstance(const std::string &id) {
+    RenderRegistry &registry = GetRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    std::unique_ptr<RenderManager> &instance = registry.instances[id];
+    if (!instance) {
+        instance.reset(new RenderManager(id));
+    }
+    return instance.get();
+}
+
+RenderManager *RenderManager::FromComponent(OH_NativeXComponent *component) {
+    char id[OH_XCOMPONENT_ID_LEN_MAX + 1] = {};
+    uint64_t idSize = OH_XCOMPONENT_ID_LEN_MAX + 1;
+    if (OH_NativeXComponent_GetXComponentId(component, id, &idSize) != OH_NATIVEXCOMPONENT_RESULT_SUCCESS) {
+        OH_LOG_ERROR("Failed to get XComponent id");
+        return nullptr;
+    }
+    return GetInstance(id);
+}
+
+RenderManager::~RenderManager() {
+    StopRenderThread();
+}
+
+void RenderManager::PushData(double speedKbps, int64_t sampleTimeUs) {
+    feed_.Push(speedKbps, sampleTimeUs, ClockSource::Steady()->NowUs());
+    RequestFrame();
+}
+
+void RenderManager::ClearData() {
+    feed_.Clear();
+    RequestFrame();
+}
+
+void RenderManager::RequestFrame() {
+    frameRequests_.fetch_add(1, std::memory_order_relaxed);
+    // 已有挂起的请求时直接返回：这一帧还没画，新样本会被它一并带上
+    if (framePending_.exchange(true, std::memory_order_acq_rel)) {
+        coalescedRequests_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // 短暂持有 wakeMutex_ 再通知，避免渲染线程检查条件与进入等待之间的唤醒丢失
+    { std::lock_guard<std::mutex> lock(wakeMutex_); }
+    frameCv_.notify_one();
 }
 
-void RenderManager::SetId(std::string id) {
-    id_ = id;
+void RenderManager::StartRenderThread() {
+    if (renderThread_.joinable()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopRender_ = false;
+    }
+    renderThread_ = std::thread(&RenderManager::RenderLoop, this);
 }
 
-void RenderManager::PushData(double speedKbps) {
-    // 加锁保护
+void RenderManager::StopRenderThread() {
     {
-        std::lock_guard<std::mutex> lock(dataMutex_);
-        speedHistory_.push_back(speedKbps);
-        if (speedHistory_.size() > MAX_HISTORY_SIZE) {
-            speedHistory_.pop_front();
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopRender_ = true;
+    }
+    frameCv_.notify_one();
+    if (renderThread_.joinable()) {
+        renderThread_.join();
+    }
+}
+
+void RenderManager::RenderLoop() {
+    auto nextFrame = std::chrono::steady_clock::now();
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex_);
+            frameCv_.wait(lock, [this] { return stopRender_ || framePending_.load(std::memory_order_acquire); });
+            if (stopRender_) {
+                break;
+            }
+        }
+        
+        // 帧率上限：距上一帧不足一个帧间隔时先等待，期间到达的样本都合并进这一帧
+        std::this_thread::sleep_until(nextFrame);
+        
+        // 先清除请求再绘制，绘制过程中到达的新样本会重新挂起请求，触发下一帧
+        framePending_.store(false, std::memory_order_release);
+        bool again = false;
+        {
+            std::lock_guard<std::mutex> lock(surfaceMutex_);
+            again = DrawFrame();
+        }
+        if (again) {
+            // 曲线还在随时间滚动，或本帧因没有可写的缓冲区而跳过 (不阻塞等待)：下一个帧间隔继续
+            framePending_.store(true, std::memory_order_release);
         }
+        
+        auto now = std::chrono::steady_clock::now();
+        nextFrame = std::max(now, nextFrame) + std::chrono::microseconds(FRAME_INTERVAL_US);
     }
-    
-    bool expected = false;
-    if (isRendering_.compare_exchange_strong(expected, true)) {
-        DrawFrame();
+}
+
+RenderMetrics RenderManager::GetRenderMetrics() {
+    RenderMetrics metrics;
+    {
+        std::lock_guard<std::mutex> lock(surfaceMutex_);
+        metrics = renderer_.Metrics();
     }
-//    OH_LOG_INFO("Pipeline received: %{public}.2f kbps, Buffer size: %{public}zu", speedKbps, speedHistory_.size());
+    metrics.frameRequests = frameRequests_.load(std::memory_order_relaxed);
+    metrics.coalescedRequests = coalescedRequests_.load(std::memory_order_relaxed);
+    return metrics;
 }
 
-void RenderManager::ClearData() {
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    speedHistory_.clear();
+WaveformStyle RenderManager::GetWaveformStyle() {
+    std::lock_guard<std::mutex> lock(surfaceMutex_);
+    return renderer_.Style();
+}
+
+void RenderManager::SetWaveformStyle(const WaveformStyle &style) {
+    {
+        std::lock_guard<std::mutex> lock(surfaceMutex_);
+        renderer_.SetStyle(style);
+    }
+    RequestFrame();
 }
 
 // 获取数据 (消费者)
-std::vector<double> RenderManager::GetDataSnapshot() {
-    std::lock_guard<std::mutex> lock(dataMutex_);
-    return {speedHistory_.begin(), speedHistory_.end()};
+size_t RenderManager::GetDataSnapshot(WaveformSample *out, uint64_t *endSeq) {
+    auto historyLock = feed_.LockHistory();
+    return feed_.History().Snapshot(out, endSeq);
+}
+
+bool RenderManager::SetHistoryDepth(size_t depth) {
+    if (!feed_.RequestHistoryDepth(depth)) {
+        return false;
+    }
+    // 通道空闲时由调用线程临时充当生产者直接换上新历史
+    if (feed_.ClaimProducer(this)) {
+        feed_.ApplyHistoryDepth();
+        feed_.ReleaseProducer(this);
+    }
+    RequestFrame();
+    return true;
 }
 
 // Surface 创建回调, 当 UI 层的 XComponent 布局完成并分配好显存后，系统调用此函数
 void RenderManager::OnSurfaceCreated(OH_NativeXComponent *component, void *window) {
-    OH_LOG_INFO("OnSurFaceCreated: Surface ready.");
-    auto instance = RenderManager::GetInstance();
-    instance->nativeWindow_ = static_cast<OHNativeWindow*>(window); // 获取 NativeWindow 实例, window 参数实际上就是 OHNativeWindow*
+    auto instance = RenderManager::FromComponent(component);
+    if (instance == nullptr) return;
+    OH_LOG_INFO("OnSurFaceCreated: Surface ready (%{public}s).", instance->id_.c_str());
     
     // 获取初始宽高
     uint64_t width = 0;
     uint64_t height = 0;
     int32_t ret = OH_NativeXComponent_GetXComponentSize(component, window, &width, &height);
     if (ret == OH_NATIVEXCOMPONENT_RESULT_SUCCESS) {
-        instance->width_ = width;
-        instance->height_ = height;
         OH_LOG_INFO("Surface Size: %{public}lu x %{public}lu", width, height);
     }
-    uint64_t usage = NATIVEBUFFER_USAGE_CPU_READ | NATIVEBUFFER_USAGE_CPU_WRITE;
-    ret = OH_NativeWindow_NativeWindowHandleOpt(instance->nativeWindow_, SET_USAGE, usage);
-    if (ret != 0) {
-        OH_LOG_ERROR("Set Usage failed: %{public}d", ret);
+    // window 参数实际上就是 OHNativeWindow*
+    auto surface = std::make_unique<NativeWindowSurface>(static_cast<OHNativeWindow*>(window));
+    surface->Resize(width, height);
+    {
+        std::lock_guard<std::mutex> lock(instance->surfaceMutex_);
+        instance->surface_ = std::move(surface);
     }
-    OH_NativeWindow_NativeWindowHandleOpt(instance->nativeWindow_, SET_BUFFER_GEOMETRY, instance->width_, instance->height_);
-    OH_NativeWindow_NativeWindowHandleOpt(instance->nativeWindow_, SET_FORMAT, NATIVEBUFFER_PIXEL_FMT_RGBA_8888);
+    
+    instance->StartRenderThread();
+    instance->RequestFrame();
 }
 
 void RenderManager::OnSurfaceChanged(OH_NativeXComponent *component, void *window) {
     OH_LOG_INFO("OnSurfaceChanged");
     // 当屏幕旋转或组件大小变化时触发，需要更新画布尺寸
-    auto instance = RenderManager::GetInstance();
+    auto instance = RenderManager::FromComponent(component);
+    if (instance == nullptr) return;
     // 更新宽高
     uint64_t width = 0;
     uint64_t height = 0;
     OH_NativeXComponent_GetXComponentSize(component, window, &width, &height);
-    instance->width_ = width;
-    instance->height_ = height;
+    {
+        std::lock_guard<std::mutex> lock(instance->surfaceMutex_);
+        if (instance->surface_ != nullptr) {
+            instance->surface_->Resize(width, height);
+        }
+    }
     // 重新触发一次绘制，适配新尺寸
-    instance->DrawFrame();
+    instance->RequestFrame();
 }
 
 void RenderManager::OnSurfaceDestroyed(OH_NativeXComponent *component, void *window) {
     OH_LOG_INFO("OnSurfaceDestroyed");
-    RenderManager::GetInstance()->nativeWindow_ = nullptr;
+    auto instance = RenderManager::FromComponent(component);
+    if (instance == nullptr) return;
+    // 先停掉渲染线程，保证 Surface 销毁后不会再有帧访问它
+    instance->StopRenderThread();
+    std::lock_guard<std::mutex> lock(instance->surfaceMutex_);
+    // 先释放包装在窗口缓冲区上的画布，再释放缓冲区映射
+    instance->renderer_.ReleaseResources();
+    instance->surface_.reset();
 }
 
 void RenderManager::OnDispatchTouchEvent(OH_NativeXComponent *component, void *window) {
@@ -110,181 +243,43 @@ void RenderManager::RegisterCallback(OH_NativeXComponent *nativeXComponent) {
     
     // 这里的 RegisterCallback 是 NDK 提供的 API
     OH_NativeXComponent_RegisterCallback(nativeXComponent, &callback_);
-    OH_LOG_INFO("RenderManager Callback Registered");
-    
+    OH_LOG_INFO("RenderManager Callback Registered: %{public}s", id_.c_str());
 }
 
-void RenderManager::DrawFrame() {
-    if (nativeWindow_ == nullptr) {
-        isRendering_ = false; // 释放锁
-        return;
-    }
-    
-    // 请求 Buffer (生产者-消费者模型中的“生产”)
-    OHNativeWindowBuffer* buffer = nullptr;
-    int fenceFd = -1;
-    // 请求一块空闲的 Graphic Buffer，可能会阻塞等待 VSync
-    auto ret = OH_NativeWindow_NativeWindowRequestBuffer(nativeWindow_, &buffer, &fenceFd);
-    if(ret != 0 || buffer == nullptr) {
-        OH_LOG_ERROR("RequestBuffer failed: %{public}d", ret);
-        isRendering_ = false; // 释放锁
-        return;
+bool RenderManager::DrawFrame() {
+    if (surface_ == nullptr) {
+        return false;
     }
-    
-    // 如果有 Fence，必须等待 GPU/Display 用完这块 Buffer 才能写
-    if (fenceFd > 0) {
-        close(fenceFd); 
+    // 持历史锁绘制：生产者只尝试加锁，拿不到时推迟替换，不会被这里阻塞
+    auto historyLock = feed_.LockHistory();
+    if (feed_.HistoryGeneration() != drawnGeneration_) {
+        drawnGeneration_ = feed_.HistoryGeneration();
+        renderer_.InvalidateContent();
     }
-    
-    // 获取 Buffer 信息并绑定 Bitmap
-    BufferHandle* handle = OH_NativeWindow_GetBufferHandleFromNative(buffer);
-    void* windowPixels = handle->virAddr; // Buffer 的虚拟内存地址
-    bool needsUnmap = false; // 标记是否需要手动解除映射
-    
-    if(windowPixels == nullptr) {
-        // 系统没有映射，这里需要处理 mmap
-        windowPixels = mmap(nullptr, handle->size, PROT_READ | PROT_WRITE, MAP_SHARED, handle->fd, 0);
-        if (windowPixels == MAP_FAILED) {
-            OH_LOG_ERROR("mmap failed!");
-            OH_NativeWindow_NativeWindowAbortBuffer(nativeWindow_, buffer);
-            isRendering_ = false;
-            return;
+    int64_t windowUs = static_cast<int64_t>(feed_.HistoryDepth() - 1) * SAMPLE_INTERVAL_US;
+    WaveformRenderer::FrameResult result =
+        renderer_.RenderFrame(surface_.get(), feed_.History(), windowUs, ClockSource::Steady()->NowUs());
+    if (result == WaveformRenderer::FRAME_SKIPPED) {
+        // 合成器长时间不归还缓冲区时只按间隔记一次日志，避免每帧刷屏
+        skippedFrames_++;
+        if (skippedFrames_ % SKIP_LOG_INTERVAL == 0) {
+            OH_LOG_INFO("No writable buffer for %{public}u frames", skippedFrames_);
         }
-        needsUnmap = true;
+        return true;
     }
-    
-    // 创建 Bitmap 绑定这块内存
-    OH_Drawing_Bitmap* bitmap = OH_Drawing_BitmapCreate();
-    OH_Drawing_BitmapFormat format = { COLOR_FORMAT_RGBA_8888, ALPHA_FORMAT_PREMUL};
-    OH_Drawing_BitmapBuild(bitmap, width_, height_, &format);
-    
-    // 创建 Canvas 绑定 Bitmap
-    OH_Drawing_Canvas* canvas = OH_Drawing_CanvasCreate();
-    OH_Drawing_CanvasBind(canvas, bitmap);
-    
-    // --- 绘图逻辑 ---
-    
-    // 清空画布 (白色背景)
-    OH_Drawing_CanvasClear(canvas, OH_Drawing_ColorSetArgb(0XFF, 0XFF, 0XFF, 0XFF));
-    
-    // 准备数据
-    auto data = GetDataSnapshot();
-    if(data.size() > 1) {
-        // 计算 Y 轴最大值 (动态缩放)
-        double maxVal = *std::max_element(data.begin(), data.end());
-        if(maxVal < 100.0) maxVal = 100.0; // 最小刻度
-        maxVal *= 1.2; // 留 20% 顶部余量
-        
-        // 创建路径
-        OH_Drawing_Path* path = OH_Drawing_PathCreate();
-        
-        // 移动到左下角起点 (闭合区域用于填充)
-        OH_Drawing_PathMoveTo(path, 0, height_);
-        
-        float stepX = static_cast<float>(width_) / (MAX_HISTORY_SIZE - 1);
-        float lastX = 0.0f; 
-        
-        OH_Drawing_Path* fillPath = OH_Drawing_PathCreate();
-        OH_Drawing_PathMoveTo(fillPath, 0, height_);
-        
-        float currentX = 0;
-        
-        // 构建波形路径
-        for(size_t i = 0; i < data.size(); i++) {
-            float x = i * stepX;
-            // Y轴翻转：Canvas (0,0) 在左上角，数值越大越靠下
-            // Val = 0 -> y = height; Val = max -> y = 0
-            float y = static_cast<float >(height_ - (data[i] / maxVal) * height_);
-            OH_Drawing_PathLineTo(fillPath, x, y);
-            lastX = x;
-        }
-        
-        // 闭合路径到右下角
-        OH_Drawing_PathLineTo(fillPath, lastX, height_);
-        // 回到起点 (0, height_) 闭合
-        OH_Drawing_PathLineTo(fillPath, 0, height_);
-        OH_Drawing_PathClose(fillPath);
-        
-        // 绘制填充 (Brush + Shader)
-        OH_Drawing_Brush* brush = OH_Drawing_BrushCreate();
-        
-        // 创建线性渐变 (从上到下)
-        OH_Drawing_Point* startPt = OH_Drawing_PointCreate(0, 0);
-        OH_Drawing_Point* endPt = OH_Drawing_PointCreate(0, height_);
-        
-        // 颜色：半透明蓝 -> 全透明蓝
-        uint32_t colors[] = { 0x66007DFF, 0x00007DFF }; 
-        float pos[] = { 0.0f, 1.0f};
-        OH_Drawing_ShaderEffect* shader = OH_Drawing_ShaderEffectCreateLinearGradient(startPt, endPt, colors, pos, 2, OH_Drawing_TileMode::CLAMP);
-        
-        OH_Drawing_BrushSetShaderEffect(brush, shader);
-        OH_Drawing_CanvasAttachBrush(canvas, brush);
-        OH_Drawing_CanvasAttachPen(canvas, nullptr);
-        OH_Drawing_CanvasDrawPath(canvas, fillPath);
-        
-        OH_Drawing_Path* strokePath = OH_Drawing_PathCreate();
-        for (size_t i = 0; i < data.size(); ++i) {
-            float x = i * stepX;
-            float y = static_cast<float>(height_ - (data[i] / maxVal) * height_);
-            if (i == 0) OH_Drawing_PathMoveTo(strokePath, x, y);
-            else OH_Drawing_PathLineTo(strokePath, x, y);
-        }
-        
-        // 绘制描边 (Pen)
-        OH_Drawing_Pen* pen = OH_Drawing_PenCreate();
-        OH_Drawing_PenSetColor(pen, 0xFF007DFF);
-        OH_Drawing_PenSetWidth(pen, 4.0f);
-        OH_Drawing_PenSetJoin(pen, LINE_ROUND_JOIN);
-        OH_Drawing_PenSetCap(pen, LINE_ROUND_CAP);
-        OH_Drawing_PenSetAntiAlias(pen, true); // 抗锯齿开启
-        
-        OH_Drawing_CanvasAttachPen(canvas, pen);
-        OH_Drawing_CanvasAttachBrush(canvas, nullptr);
-        OH_Drawing_CanvasDrawPath(canvas, strokePath);
-        
-        // 资源清理
-        OH_Drawing_PenDestroy(pen);
-        OH_Drawing_BrushDestroy(brush);
-        OH_Drawing_ShaderEffectDestroy(shader);
-        OH_Drawing_PointDestroy(startPt);
-        OH_Drawing_PointDestroy(endPt);
-        OH_Drawing_PathDestroy(fillPath);
-        OH_Drawing_PathDestroy(strokePath);
+    skippedFrames_ = 0;
+    switch (result) {
+        case WaveformRenderer::FRAME_NO_RESOURCES:
+            OH_LOG_ERROR("Create drawing resources failed");
+            break;
+        case WaveformRenderer::FRAME_ACQUIRE_FAILED:
+            OH_LOG_ERROR("Acquire buffer failed, frame dropped");
+            break;
+        case WaveformRenderer::FRAME_DRAW_FAILED:
+            OH_LOG_ERROR("Draw waveform failed, frame dropped");
+            break;
+        default:
+            break;
     }
-    
-    // 获取 Bitmap 绘制好的像素地址 (源地址)
-    void* bitmapPixels = OH_Drawing_BitmapGetPixels(bitmap);
-    
-    // 获取目标 Window 的 stride (步长/跨度)
-    int32_t bufferStride = handle->stride; // 目标 stride
-    int32_t bitmapStride = width_ * 4; // 源 stride (RGBA 4字节)
-    
-    if(bitmapPixels != nullptr && windowPixels != nullptr) {
-        if(bufferStride == bitmapStride) {
-            // 如果 stride 一致，直接整块拷贝
-            memcpy(windowPixels, bitmapPixels, width_ * height_ * 4);
-        }else {
-            // 如果 stride 不一致，必须逐行拷贝, 否则画面会歪斜或花屏
-            for(int i = 0; i < height_; i++){
-                uint8_t* srcRow = static_cast<uint8_t*>(bitmapPixels) + i * bitmapStride;
-                uint8_t* dstRow = static_cast<uint8_t*>(windowPixels) + i * bufferStride;
-                memcpy(dstRow, srcRow, width_ * 4); // 只拷贝有效数据
-            }
-        }
-    }
-    
-    // 清理画布相关资源
-    OH_Drawing_CanvasDestroy(canvas);
-    OH_Drawing_BitmapDestroy(bitmap);
-    
-    // 解除映射
-    if (needsUnmap) {
-        munmap(windowPixels, handle->size);
-    }
-    
-    // 提交 Buffer (Flush), 将画好的内容交给屏幕合成器
-    Region region = {nullptr, 0};
-    OH_NativeWindow_NativeWindowFlushBuffer(nativeWindow_, buffer, -1, region);
-    
-    isRendering_ = false;
-}
\ No newline at end of file
+    return renderer_.Animating();
+}
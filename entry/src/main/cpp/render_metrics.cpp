@@ -0,0 +1,57 @@
+// 渲染管线计数与计时：阶段耗时累计与帧耗时直方图
+#include "render_metrics.h"
+#include <algorithm>
+
+// 1ms / 2ms / 4ms / 8ms，一帧 (60fps / 30fps / 15fps)，之后为掉帧严重的长帧
+const int64_t FrameTimeHistogram::BUCKET_UPPER_US[BUCKET_COUNT - 1] = {1000, 2000, 4000, 8000, 16667, 33333, 66667};
+
+const char* RenderStageName(RenderStage stage) {
+    switch (stage) {
+        case RENDER_STAGE_PREPARE:
+            return "prepare";
+        case RENDER_STAGE_ACQUIRE:
+            return "acquire";
+        case RENDER_STAGE_DRAW:
+            return "draw";
+        case RENDER_STAGE_COPY:
+            return "copy";
+        case RENDER_STAGE_PRESENT:
+            return "present";
+        default:
+            return "unknown";
+    }
+}
+
+void StageTiming::Record(int64_t us) {
+    count++;
+    totalUs += us;
+    maxUs = std::max(maxUs, us);
+    lastUs = us;
+}
+
+void FrameTimeHistogram::Record(int64_t us) {
+    size_t bucket = std::upper_bound(BUCKET_UPPER_US, BUCKET_UPPER_US + BUCKET_COUNT - 1, us) - BUCKET_UPPER_US;
+    counts[bucket]++;
+}
+
+uint64_t FrameTimeHistogram::Total() const {
+    uint64_t total = 0;
+    for (uint64_t count : counts) total += count;
+    return total;
+}
+
+int64_t FrameTimeHistogram::PercentileUpperUs(double p) const {
+    uint64_t total = Total();
+    if (total == 0) {
+        return 0;
+    }
+    double target = std::min(std::max(p, 0.0), 1.0) * static_cast<double>(total);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT - 1; i++) {
+        seen += counts[i];
+        if (static_cast<double>(seen) >= target && seen > 0) {
+            return BUCKET_UPPER_US[i];
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,31 @@
+// sync fence 等待：poll 可读即触发，带超时，EINTR 时按剩余时间重试
+#include "sync_fence.h"
+#include <cerrno>
+#include <chrono>
+#include <poll.h>
+
+FenceWaitResult WaitFence(int fenceFd, int timeoutMs) {
+    if (fenceFd < 0) {
+        return FENCE_SIGNALED;
+    }
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs > 0 ? timeoutMs : 0);
+    int remainingMs = timeoutMs > 0 ? timeoutMs : 0;
+    while (true) {
+        struct pollfd pfd = {fenceFd, POLLIN, 0};
+        int ret = poll(&pfd, 1, remainingMs);
+        if (ret > 0) {
+            if (pfd.revents & POLLIN) {
+                return FENCE_SIGNALED;
+            }
+            return FENCE_ERROR; // POLLERR / POLLHUP / POLLNVAL
+        }
+        if (ret == 0) {
+            return FENCE_TIMEOUT;
+        }
+        if (errno != EINTR) {
+            return FENCE_ERROR;
+        }
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+        remainingMs = left.count() > 0 ? static_cast<int>(left.count()) : 0;
+    }
+}
@@ -0,0 +1,60 @@
+// TCP 指标的合并与链路状况判断 (纯计算，采样在 http_socket.cpp)
+#include "tcp_metrics.h"
+#include <algorithm>
+
+static constexpr uint64_t MIN_SEGMENTS_FOR_LOSS = 100;   // 发出的段少于此数时重传率没有意义
+static constexpr double LOSSY_RETRANSMIT_RATIO = 0.02;  // 重传率达到 2% 视为丢包明显
+static constexpr double CONGESTED_RTT_INFLATION = 2.0;  // RTT 达到最小 RTT 的 2 倍 ...
+static constexpr double MIN_QUEUE_DELAY_US = 5000;      // ... 且排队时延至少 5ms (回环等极低 RTT 不算)
+
+void MergeTcpMetrics(TcpMetrics *total, const TcpMetrics &connection) {
+    if (!connection.valid) {
+        return;
+    }
+    // 均值按连接数增量更新
+    int n = total->connections + 1;
+    auto mean = [n](double current, double value) { return current + (value - current) / n; };
+    total->rttUs = mean(total->rttUs, connection.rttUs);
+    total->rttVarUs = mean(total->rttVarUs, connection.rttVarUs);
+    // 还没有接收方向估计的连接 (如刚建立、尚未收到数据) 不拉低均值
+    if (connection.rcvRttUs > 0) {
+        int rcvCount = total->rcvRttConnections + 1;
+        total->rcvRttUs += (connection.rcvRttUs - total->rcvRttUs) / rcvCount;
+        total->rcvRttConnections = rcvCount;
+    }
+    if (connection.minRttUs > 0) {
+        total->minRttUs = total->minRttUs > 0 ? std::min(total->minRttUs, connection.minRttUs) : connection.minRttUs;
+    }
+    total->retransmits += connection.retransmits;
+    total->segmentsOut += connection.segmentsOut;
+    total->cwnd += connection.cwnd;
+    total->mss = std::max(total->mss, connection.mss);
+    total->pacingKbps += connection.pacingKbps;
+    total->connections = n;
+    total->valid = true;
+}
+
+double RetransmitRatio(const TcpMetrics &metrics) {
+    if (metrics.segmentsOut == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(metrics.retransmits) / static_cast<double>(metrics.segmentsOut);
+}
+
+LinkCondition ClassifyLink(const TcpMetrics &metrics) {
+    if (!metrics.valid) {
+        return LINK_UNKNOWN;
+    }
+    // 下载时发送方向的 RTT 停留在发请求时的值，取两个方向中较大的估计
+    double rtt = std::max(metrics.rttUs, metrics.rcvRttUs);
+    bool congested = metrics.minRttUs > 0 && rtt >= metrics.minRttUs * CONGESTED_RTT_INFLATION &&
+                     rtt - metrics.minRttUs >= MIN_QUEUE_DELAY_US;
+    bool enoughSegments = metrics.segmentsOut >= MIN_SEGMENTS_FOR_LOSS;
+    if (congested) {
+        return LINK_CONGESTED; // 有排队时的重传也是拥塞造成的
+    }
+    if (enoughSegments && RetransmitRatio(metrics) >= LOSSY_RETRANSMIT_RATIO) {
+        return LINK_LOSSY;
+    }
+    return enoughSegments || metrics.minRttUs > 0 ? LINK_GOOD : LINK_UNKNOWN;
+}
@@ -0,0 +1,132 @@
+#include "convergence_detector.h"
+#include "test_utils.h"
+#include "traffic_analyzer.h"
+
+static const int64_t SAMPLE_US = 100000; // 分析器每 100ms 出一个瞬时速度样本
+
+// 按 100ms 间隔送入 count 个样本，rate(i) 给出第 i 个样本的速度；返回最后一次 Update 的结果
+template <typename Rate>
+static bool Feed(ConvergenceDetector *detector, int first, int count, Rate rate) {
+    bool stable = false;
+    for (int i = first; i < first + count; i++) {
+        stable = detector->Update(rate(i), (i + 1) * SAMPLE_US);
+    }
+    return stable;
+}
+
+// 恒速：窗口填满且达到最短时长后立即稳定，之前一直不稳定
+static void TestSteadyRateBecomesStable() {
+    ConvergenceDetector detector;
+    auto steady = [](int) { return 8000.0; };
+    EXPECT_TRUE(!Feed(&detector, 0, 19, steady)); // 最短时长 2 秒 = 20 个样本
+    EXPECT_TRUE(Feed(&detector, 19, 1, steady));
+    EXPECT_TRUE(detector.Stable());
+    EXPECT_NEAR(detector.MeanKbps(), 8000.0, 1e-9);
+    EXPECT_NEAR(detector.ConfidenceKbps(), 0.0, 1e-9);
+}
+
+// 轻微噪声 (±2%) 仍然判为稳定，置信区间半宽与噪声幅度同量级
+static void TestSmallNoiseIsStable() {
+    ConvergenceDetector detector;
+    bool stable = Feed(&detector, 0, 40, [](int i) { return i % 2 == 0 ? 9800.0 : 10200.0; });
+    EXPECT_TRUE(stable);
+    EXPECT_NEAR(detector.MeanKbps(), 10000.0, 1e-6);
+    EXPECT_TRUE(detector.ConfidenceKbps() > 0 && detector.ConfidenceKbps() < 200.0);
+}
+
+// 抖动大的链路 (±50%) 无论测多久都不稳定
+static void TestNoisyRateNeverStable() {
+    ConvergenceDetector detector;
+    bool everStable = false;
+    for (int i = 0; i < 200; i++) {
+        everStable = detector.Update(i % 2 == 0 ? 5000.0 : 15000.0, (i + 1) * SAMPLE_US) || everStable;
+    }
+    EXPECT_TRUE(!everStable);
+}
+
+// 默认条件下 ±11% 的交替速度：置信区间 (约 4.8%) 与漂移 (0) 都满足，只有抖动超限而不稳定；
+// 放宽抖动上限后同样的数据判为稳定
+static void TestJitterAloneBlocksStability() {
+    auto alternating = [](int i) { return i % 2 == 0 ? 8880.0 : 11120.0; };
+    ConvergenceDetector detector;
+    EXPECT_TRUE(!Feed(&detector, 0, 60, alternating));
+    EXPECT_TRUE(detector.ConfidenceKbps() / detector.MeanKbps() <= detector.Config().maxConfidenceRatio);
+
+    ConvergenceConfig config;
+    config.maxJitterRatio = 0.2;
+    detector.Configure(config);
+    EXPECT_TRUE(Feed(&detector, 0, 60, alternating));
+}
+
+// 持续爬升 (如慢启动)：窗口均值一直在移动，不判为稳定
+static void TestRampIsNotStable() {
+    ConvergenceDetector detector;
+    bool stable = Feed(&detector, 0, 60, [](int i) { return 1000.0 + 100.0 * i; });
+    EXPECT_TRUE(!stable);
+}
+
+// 状态不锁存：稳定后链路突变会回到不稳定，重新平稳后再次稳定
+static void TestStabilityIsNotLatched() {
+    ConvergenceDetector detector;
+    EXPECT_TRUE(Feed(&detector, 0, 30, [](int) { return 8000.0; }));
+    EXPECT_TRUE(!Feed(&detector, 30, 1, [](int) { return 2000.0; }));
+    EXPECT_TRUE(!Feed(&detector, 31, 10, [](int) { return 2000.0; }));
+    EXPECT_TRUE(Feed(&detector, 41, 30, [](int) { return 2000.0; }));
+}
+
+static void TestResetAndConfigure() {
+    ConvergenceConfig config;
+    config.windowSamples = 5;
+    config.driftSamples = 2;
+    config.minDurationUs = 0;
+    ConvergenceDetector detector(config);
+    EXPECT_TRUE(!Feed(&detector, 0, 4, [](int) { return 100.0; }));
+    EXPECT_TRUE(Feed(&detector, 4, 1, [](int) { return 100.0; }));
+
+    detector.Reset();
+    EXPECT_TRUE(!detector.Stable());
+    EXPECT_TRUE(!Feed(&detector, 0, 4, [](int) { return 100.0; })); // 窗口重新填充
+
+    config.minDurationUs = 10 * SAMPLE_US;
+    detector.Configure(config);
+    EXPECT_TRUE(!Feed(&detector, 0, 9, [](int) { return 100.0; }));
+    EXPECT_TRUE(Feed(&detector, 9, 1, [](int) { return 100.0; }));
+
+    // 速度为 0 (断流) 不算稳定
+    detector.Reset();
+    EXPECT_TRUE(!Feed(&detector, 0, 20, [](int) { return 0.0; }));
+}
+
+// 分析器把每个瞬时速度样本送入检测器，统计结果带出稳定标志与置信区间
+static void TestAnalyzerReportsStability() {
+    TrafficAnalyzer analyzer;
+    ConvergenceConfig config;
+    config.minDurationUs = 1000000;
+    analyzer.SetConvergenceConfig(config);
+    analyzer.ProcessAt(0, 0);
+    TrafficStats stats;
+    for (int i = 1; i <= 15; i++) {
+        stats = analyzer.ProcessAt(102400, i * SAMPLE_US);
+    }
+    EXPECT_TRUE(!stats.stable); // 窗口 (20 个样本) 未满
+    for (int i = 16; i <= 25; i++) {
+        stats = analyzer.ProcessAt(102400, i * SAMPLE_US);
+    }
+    EXPECT_TRUE(stats.stable && analyzer.Stable());
+    EXPECT_NEAR(stats.confidenceKbps, 0.0, 1e-6);
+
+    analyzer.Reset();
+    EXPECT_TRUE(!analyzer.Stable());
+}
+
+int main() {
+    RUN_TEST(TestSteadyRateBecomesStable);
+    RUN_TEST(TestSmallNoiseIsStable);
+    RUN_TEST(TestNoisyRateNeverStable);
+    RUN_TEST(TestJitterAloneBlocksStability);
+    RUN_TEST(TestRampIsNotStable);
+    RUN_TEST(TestStabilityIsNotLatched);
+    RUN_TEST(TestResetAndConfigure);
+    RUN_TEST(TestAnalyzerReportsStability);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,326 @@
+#include "http_download.h"
+#include "loopback_http_server.h"
+#include "test_utils.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+static int64_t ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 同步跑一次测量，返回结果并统计上报次数
+static DownloadResult RunDownload(HttpDownloadEngine *engine, const DownloadOptions &options, int *reports = nullptr) {
+    std::atomic<int> reportCount{0};
+    EXPECT_TRUE(engine->Start(options, [&reportCount](const DownloadReport &) { reportCount++; }, nullptr));
+    engine->Join();
+    if (reports != nullptr) *reports = reportCount.load();
+    return engine->Result();
+}
+
+static void TestParseHttpUrl() {
+    HttpUrl url;
+    EXPECT_TRUE(ParseHttpUrl("http://speedtest.tele2.net/100MB.zip?nocache=1", &url));
+    EXPECT_TRUE(url.host == "speedtest.tele2.net" && url.port == 80 && url.path == "/100MB.zip?nocache=1");
+    EXPECT_TRUE(ParseHttpUrl("HTTP://127.0.0.1:8080", &url));
+    EXPECT_TRUE(url.host == "127.0.0.1" && url.port == 8080 && url.path == "/");
+    EXPECT_TRUE(ParseHttpUrl("http://[::1]:9000/a#frag", &url));
+    EXPECT_TRUE(url.host == "::1" && url.port == 9000 && url.path == "/a");
+    EXPECT_TRUE(ParseHttpUrl("http://host?q=1", &url));
+    EXPECT_TRUE(url.path == "/?q=1");
+
+    EXPECT_TRUE(!ParseHttpUrl("https://host/", &url));
+    EXPECT_TRUE(!ParseHttpUrl("http://", &url));
+    EXPECT_TRUE(!ParseHttpUrl("http://:80/", &url));
+    EXPECT_TRUE(!ParseHttpUrl("http://host:0/", &url));
+    EXPECT_TRUE(!ParseHttpUrl("http://host:65536/", &url));
+    EXPECT_TRUE(!ParseHttpUrl("http://host:8a/", &url));
+    EXPECT_TRUE(!ParseHttpUrl("http://user@host/", &url));
+}
+
+// 带 Content-Length 的完整下载：正文字节全部计入分析器，请求头符合预期
+static void TestDownloadCompletes() {
+    LoopbackResponse response;
+    response.bodyBytes = 8 << 20;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url("/download?nocache=1");
+    DownloadResult result = RunDownload(&engine, options);
+
+    EXPECT_TRUE(result.reason == DOWNLOAD_COMPLETED);
+    EXPECT_TRUE(result.httpStatus == 200);
+    EXPECT_TRUE(result.last.bytes == response.bodyBytes);
+    EXPECT_TRUE(result.last.contentLength == static_cast<int64_t>(response.bodyBytes));
+    EXPECT_NEAR(engine.Analyzer().Current().totalBytes, static_cast<double>(response.bodyBytes), 0.0);
+    std::string request = server.LastRequest();
+    EXPECT_TRUE(request.find("GET /download?nocache=1 HTTP/1.1\r\n") == 0);
+    EXPECT_TRUE(request.find("Host: 127.0.0.1:" + std::to_string(server.Port()) + "\r\n") != std::string::npos);
+    EXPECT_TRUE(request.find("Accept-Encoding: identity\r\n") != std::string::npos);
+}
+
+// 没有 Content-Length：服务端断开即结束
+static void TestDownloadUntilClose() {
+    LoopbackResponse response;
+    response.bodyBytes = 3 << 20;
+    response.sendContentLength = false;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url();
+    DownloadResult result = RunDownload(&engine, options);
+    EXPECT_TRUE(result.reason == DOWNLOAD_COMPLETED);
+    EXPECT_TRUE(result.last.bytes == response.bodyBytes);
+    EXPECT_TRUE(result.last.contentLength == -1);
+}
+
+// 限速的无尽响应：按时长结束，期间周期性上报，分析器产生速度样本
+static void TestDurationLimitAndReports() {
+    LoopbackResponse response;
+    response.endless = true;
+    response.chunkBytes = 16 * 1024;
+    response.chunkDelayUs = 2000;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    std::atomic<int> samples{0};
+    engine.Analyzer().SetSampleListener([&samples](double, int64_t) { samples++; });
+
+    DownloadOptions options;
+    options.url = server.Url();
+    options.durationUs = 400000;
+    options.reportIntervalUs = 50000;
+    int reports = 0;
+    auto start = std::chrono::steady_clock::now();
+    DownloadResult result = RunDownload(&engine, options, &reports);
+    int64_t elapsedMs = ElapsedMs(start);
+
+    EXPECT_TRUE(result.reason == DOWNLOAD_DURATION);
+    EXPECT_TRUE(elapsedMs >= 400 && elapsedMs < 2000);
+    EXPECT_TRUE(result.last.elapsedUs >= 400000);
+    EXPECT_TRUE(result.last.bytes > 0);
+    EXPECT_TRUE(result.last.stats.valid && result.last.stats.avgKbps > 0);
+    EXPECT_TRUE(reports >= 4);
+    EXPECT_TRUE(samples.load() >= 2);
+}
+
+static void TestMaxBytes() {
+    LoopbackResponse response;
+    response.endless = true;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url();
+    options.maxBytes = 2 << 20;
+    DownloadResult result = RunDownload(&engine, options);
+    EXPECT_TRUE(result.reason == DOWNLOAD_BYTES);
+    EXPECT_TRUE(result.last.bytes >= options.maxBytes);
+}
+
+// Stop 从其他线程唤醒引擎，立即结束；同一实例可以再次开始
+static void TestStopAndRestart() {
+    LoopbackResponse response;
+    response.endless = true;
+    response.chunkDelayUs = 5000;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url();
+    options.durationUs = 0;
+    options.reportIntervalUs = 10000000; // 只有 Stop 能唤醒
+
+    std::atomic<bool> finished{false};
+    EXPECT_TRUE(engine.Start(options, nullptr, [&finished](const DownloadResult &) { finished = true; }));
+    EXPECT_TRUE(!engine.Start(options, nullptr, nullptr)); // 正在运行
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    auto stopAt = std::chrono::steady_clock::now();
+    engine.Stop();
+    engine.Join();
+    EXPECT_TRUE(ElapsedMs(stopAt) < 500);
+    EXPECT_TRUE(finished.load());
+    EXPECT_TRUE(!engine.Running());
+    EXPECT_TRUE(engine.Result().reason == DOWNLOAD_STOPPED);
+    EXPECT_TRUE(engine.Result().last.bytes > 0);
+
+    options.durationUs = 100000;
+    DownloadResult second = RunDownload(&engine, options);
+    EXPECT_TRUE(second.reason == DOWNLOAD_DURATION);
+    EXPECT_TRUE(server.Connections() == 2);
+}
+
+// 公平性指数与掉队判断只看已有速度样本的流
+static void TestAssessStreams() {
+    DownloadReport report;
+    report.streams.resize(4);
+    const double rates[] = {1000, 1000, 1000, 200};
+    for (size_t i = 0; i < 4; i++) {
+        report.streams[i].stats.valid = true;
+        report.streams[i].stats.avgKbps = rates[i];
+    }
+    AssessStreams(&report);
+    EXPECT_NEAR(report.fairness, 3200.0 * 3200.0 / (4 * (3 * 1e6 + 4e4)), 1e-9);
+    EXPECT_TRUE(report.stragglers == 1 && report.streams[3].straggler && !report.streams[0].straggler);
+
+    report.streams[3].stats.valid = false; // 还没有样本：不参与
+    AssessStreams(&report);
+    EXPECT_NEAR(report.fairness, 1.0, 1e-9);
+    EXPECT_TRUE(report.stragglers == 0 && !report.streams[3].straggler);
+
+    report.streams.resize(1);
+    AssessStreams(&report);
+    EXPECT_NEAR(report.fairness, 1.0, 0.0);
+}
+
+// 多条流并行：每条连接各收一份完整正文，合计送入聚合分析器
+static void TestParallelStreams() {
+    LoopbackResponse response;
+    response.bodyBytes = 2 << 20;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url();
+    options.streams = 4;
+    DownloadResult result = RunDownload(&engine, options);
+
+    EXPECT_TRUE(result.reason == DOWNLOAD_COMPLETED);
+    EXPECT_TRUE(server.Connections() == 4);
+    EXPECT_TRUE(result.last.streams.size() == 4);
+    EXPECT_TRUE(result.last.bytes == 4 * response.bodyBytes);
+    EXPECT_TRUE(result.last.contentLength == static_cast<int64_t>(4 * response.bodyBytes));
+    EXPECT_NEAR(engine.Analyzer().Current().totalBytes, static_cast<double>(4 * response.bodyBytes), 0.0);
+    // 各流关闭前留下的 TCP 指标，聚合结果合并了全部 4 条连接
+    const TcpMetrics &tcp = result.last.stats.tcp;
+    EXPECT_TRUE(tcp.valid && tcp.connections == 4);
+    EXPECT_TRUE(tcp.rttUs > 0 && tcp.cwnd > 0 && tcp.mss > 0);
+    for (const StreamReport &stream : result.last.streams) {
+        EXPECT_TRUE(stream.state == STREAM_COMPLETED && stream.httpStatus == 200);
+        EXPECT_TRUE(stream.bytes == response.bodyBytes);
+        EXPECT_TRUE(stream.stats.tcp.valid && stream.stats.tcp.connections == 1);
+    }
+}
+
+// 一条连接被限速：该流被标记为掉队，公平性指数明显小于 1
+static void TestStragglerStream() {
+    LoopbackResponse response;
+    response.endless = true;
+    response.chunkBytes = 16 * 1024;
+    response.chunkDelayUs = 1000;
+    response.throttledConnections = 1;
+    response.throttledDelayUs = 20000;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url();
+    options.streams = 3;
+    options.durationUs = 800000;
+    DownloadResult result = RunDownload(&engine, options);
+
+    EXPECT_TRUE(result.reason == DOWNLOAD_DURATION);
+    EXPECT_TRUE(result.last.stragglers == 1);
+    EXPECT_TRUE(result.last.fairness < 0.9);
+    const StreamReport *slowest = &result.last.streams[0];
+    for (const StreamReport &stream : result.last.streams) {
+        EXPECT_TRUE(stream.state == STREAM_RECEIVING && stream.stats.valid);
+        if (stream.bytes < slowest->bytes) slowest = &stream;
+    }
+    EXPECT_TRUE(slowest->straggler);
+}
+
+// 稳定的速率很快收敛并提前结束；容差极小时跑满时长
+static void TestConvergence() {
+    LoopbackResponse response;
+    response.endless = true;
+    response.chunkBytes = 16 * 1024;
+    response.chunkDelayUs = 1000;
+    LoopbackHttpServer server(response);
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = server.Url();
+    options.streams = 2;
+    options.durationUs = 5000000;
+    options.reportIntervalUs = 50000;
+    options.stopWhenStable = true;
+    options.convergence.windowSamples = 5;
+    options.convergence.minDurationUs = 500000;
+    options.convergence.maxJitterRatio = 0.5;
+    options.convergence.maxConfidenceRatio = 0.2;
+    options.convergence.maxDriftRatio = 0.2;
+    DownloadResult result = RunDownload(&engine, options);
+    EXPECT_TRUE(result.reason == DOWNLOAD_CONVERGED);
+    EXPECT_TRUE(result.last.stats.stable);
+    EXPECT_TRUE(result.last.elapsedUs >= options.convergence.minDurationUs && result.last.elapsedUs < 3000000);
+
+    options.durationUs = 600000;
+    options.convergence.maxConfidenceRatio = 1e-9;
+    result = RunDownload(&engine, options);
+    EXPECT_TRUE(result.reason == DOWNLOAD_DURATION);
+}
+
+static void TestFailures() {
+    HttpDownloadEngine engine;
+    DownloadOptions options;
+    options.url = "ftp://127.0.0.1/";
+    DownloadResult result = RunDownload(&engine, options);
+    EXPECT_TRUE(result.reason == DOWNLOAD_FAILED && !result.error.empty());
+
+    // HTTP 错误状态
+    {
+        LoopbackResponse response;
+        response.status = 404;
+        LoopbackHttpServer server(response);
+        options.url = server.Url();
+        result = RunDownload(&engine, options);
+        EXPECT_TRUE(result.reason == DOWNLOAD_FAILED);
+        EXPECT_TRUE(result.httpStatus == 404);
+        EXPECT_TRUE(result.last.bytes == 0);
+    }
+
+    // 正文没发完就断开
+    {
+        LoopbackResponse response;
+        response.bodyBytes = 1 << 20;
+        response.closeAfterBytes = 100 * 1024;
+        LoopbackHttpServer server(response);
+        options.url = server.Url();
+        result = RunDownload(&engine, options);
+        EXPECT_TRUE(result.reason == DOWNLOAD_FAILED);
+        EXPECT_TRUE(result.last.bytes == response.closeAfterBytes);
+    }
+
+    // 迟迟不返回响应头
+    {
+        LoopbackResponse response;
+        response.headerDelayMs = 3000;
+        LoopbackHttpServer server(response);
+        options.url = server.Url();
+        options.connectTimeoutMs = 200;
+        auto start = std::chrono::steady_clock::now();
+        result = RunDownload(&engine, options);
+        EXPECT_TRUE(result.reason == DOWNLOAD_FAILED && result.httpStatus == 0);
+        EXPECT_TRUE(ElapsedMs(start) < 1000);
+    }
+
+    // 端口上没有监听
+    uint16_t closedPort = 0;
+    {
+        LoopbackHttpServer server{LoopbackResponse()};
+        closedPort = server.Port();
+    }
+    options.url = "http://127.0.0.1:" + std::to_string(closedPort) + "/";
+    result = RunDownload(&engine, options);
+    EXPECT_TRUE(result.reason == DOWNLOAD_FAILED && result.error.find("connect") != std::string::npos);
+}
+
+int main() {
+    RUN_TEST(TestParseHttpUrl);
+    RUN_TEST(TestDownloadCompletes);
+    RUN_TEST(TestDownloadUntilClose);
+    RUN_TEST(TestDurationLimitAndReports);
+    RUN_TEST(TestMaxBytes);
+    RUN_TEST(TestStopAndRestart);
+    RUN_TEST(TestAssessStreams);
+    RUN_TEST(TestParallelStreams);
+    RUN_TEST(TestStragglerStream);
+    RUN_TEST(TestConvergence);
+    RUN_TEST(TestFailures);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,180 @@
+#include "http_upload.h"
+#include "loopback_http_server.h"
+#include "test_utils.h"
+#include <chrono>
+#include <thread>
+
+// 同步跑一次测量并返回结果
+static UploadResult RunUpload(HttpUploadEngine *engine, const UploadOptions &options) {
+    EXPECT_TRUE(engine->Start(options, nullptr, nullptr));
+    engine->Join();
+    return engine->Result();
+}
+
+// 正文全部发出、被确认并收到 2xx：两种发送方式的字节数都与服务端读到的一致
+static void TestUploadCompletes() {
+    const UploadSendMode modes[] = {UPLOAD_SEND_WRITEV, UPLOAD_SEND_SENDFILE};
+    for (UploadSendMode mode : modes) {
+        LoopbackResponse response;
+        response.bodyBytes = 0;
+        LoopbackHttpServer server(response);
+        HttpUploadEngine engine;
+        UploadOptions options;
+        options.url = server.Url("/upload.php?nocache=1");
+        options.totalBytes = (8 << 20) + 123; // 不是模板大小的整数倍
+        options.sendMode = mode;
+        UploadResult result = RunUpload(&engine, options);
+
+        EXPECT_TRUE(result.reason == UPLOAD_COMPLETED);
+        EXPECT_TRUE(result.httpStatus == 200);
+        EXPECT_TRUE(result.sendfileUsed == (mode == UPLOAD_SEND_SENDFILE));
+        EXPECT_TRUE(result.last.sentBytes == options.totalBytes);
+        EXPECT_TRUE(result.last.ackedBytes == options.totalBytes);
+        EXPECT_TRUE(server.RequestBodyBytes() == options.totalBytes);
+        EXPECT_NEAR(engine.Analyzer().Current().totalBytes, static_cast<double>(options.totalBytes), 0.0);
+        std::string request = server.LastRequest();
+        EXPECT_TRUE(request.find("POST /upload.php?nocache=1 HTTP/1.1\r\n") == 0);
+        EXPECT_TRUE(request.find("Content-Length: " + std::to_string(options.totalBytes) + "\r\n") !=
+                    std::string::npos);
+
+        // 上传连接的发送方向指标：回环上有 RTT、拥塞窗口与发出的段，没有重传
+        const TcpMetrics &tcp = result.last.stats.tcp;
+        EXPECT_TRUE(tcp.valid && tcp.connections == 1);
+        EXPECT_TRUE(tcp.rttUs > 0 && tcp.cwnd > 0 && tcp.mss > 0);
+        EXPECT_TRUE(tcp.segmentsOut > options.totalBytes / (64 * 1024));
+        EXPECT_TRUE(tcp.retransmits == 0);
+        EXPECT_TRUE(ClassifyLink(tcp) == LINK_GOOD);
+    }
+}
+
+// 慢速接收端：分析器只计入已确认的字节，发送队列中积压的数据不算速度
+static void TestAckedBytesLagSentBytes() {
+    LoopbackResponse response;
+    response.readChunkBytes = 16 * 1024;
+    response.readDelayUs = 2000;
+    response.receiveBufferBytes = 64 * 1024;
+    LoopbackHttpServer server(response);
+    HttpUploadEngine engine;
+    UploadOptions options;
+    options.url = server.Url("/upload");
+    options.durationUs = 500000;
+    options.reportIntervalUs = 50000;
+    int reports = 0;
+    int tcpReports = 0; // 带 TCP 指标的上报 (每次上报前采样)
+    EXPECT_TRUE(engine.Start(options, [&reports, &tcpReports](const UploadReport &report) {
+        EXPECT_TRUE(report.ackedBytes <= report.sentBytes);
+        reports++;
+        if (report.stats.tcp.valid) tcpReports++;
+    }, nullptr));
+    engine.Join();
+    const UploadResult &result = engine.Result();
+
+    EXPECT_TRUE(result.reason == UPLOAD_DURATION);
+    EXPECT_TRUE(reports >= 5);
+    EXPECT_TRUE(tcpReports >= 4);
+    EXPECT_TRUE(result.last.ackedBytes > 0);
+    EXPECT_TRUE(result.last.sentBytes > result.last.ackedBytes); // 窗口已满，还有数据排在发送队列里
+    EXPECT_TRUE(result.last.ackedBytes < 6 << 20);               // 受接收端 ~8 MB/s 的读取速度限制
+    EXPECT_NEAR(engine.Analyzer().Current().totalBytes, static_cast<double>(result.last.ackedBytes), 0.0);
+    EXPECT_TRUE(result.last.stats.valid && result.last.stats.avgKbps > 0);
+}
+
+// 接收端匀速读取：速度收敛后提前以 UPLOAD_CONVERGED 结束
+static void TestUploadConverges() {
+    LoopbackResponse response;
+    response.readChunkBytes = 16 * 1024;
+    response.readDelayUs = 1000;
+    response.receiveBufferBytes = 64 * 1024;
+    LoopbackHttpServer server(response);
+    HttpUploadEngine engine;
+    UploadOptions options;
+    options.url = server.Url("/upload");
+    options.durationUs = 5000000;
+    options.stopWhenStable = true;
+    options.convergence.windowSamples = 5;
+    options.convergence.minDurationUs = 500000;
+    options.convergence.maxJitterRatio = 0.5;
+    options.convergence.maxConfidenceRatio = 0.2;
+    options.convergence.maxDriftRatio = 0.2;
+    UploadResult result = RunUpload(&engine, options);
+    EXPECT_TRUE(result.reason == UPLOAD_CONVERGED);
+    EXPECT_TRUE(result.last.stats.stable);
+    EXPECT_TRUE(result.last.elapsedUs >= options.convergence.minDurationUs && result.last.elapsedUs < 3000000);
+}
+
+// 服务端读到一部分正文就回了 2xx：以 UPLOAD_EARLY_RESPONSE 结束，结果里的字节数小于正文总长度
+static void TestEarlyResponse() {
+    LoopbackResponse response;
+    response.bodyBytes = 0;
+    response.respondAfterBodyBytes = 1 << 20;
+    response.readDelayUs = 1000;
+    LoopbackHttpServer server(response);
+    HttpUploadEngine engine;
+    UploadOptions options;
+    options.url = server.Url("/upload");
+    options.totalBytes = 64 << 20;
+    UploadResult result = RunUpload(&engine, options);
+    EXPECT_TRUE(result.reason == UPLOAD_EARLY_RESPONSE);
+    EXPECT_TRUE(result.httpStatus == 200);
+    EXPECT_TRUE(result.last.totalBytes == options.totalBytes);
+    EXPECT_TRUE(result.last.ackedBytes >= 1 << 20);
+    EXPECT_TRUE(result.last.ackedBytes <= result.last.sentBytes && result.last.sentBytes < options.totalBytes);
+}
+
+static void TestUploadStop() {
+    LoopbackResponse response;
+    response.readDelayUs = 5000;
+    LoopbackHttpServer server(response);
+    HttpUploadEngine engine;
+    UploadOptions options;
+    options.url = server.Url("/upload");
+    options.durationUs = 0;
+    EXPECT_TRUE(engine.Start(options, nullptr, nullptr));
+    EXPECT_TRUE(!engine.Start(options, nullptr, nullptr)); // 正在运行
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    engine.Stop();
+    engine.Join();
+    EXPECT_TRUE(engine.Result().reason == UPLOAD_STOPPED);
+    EXPECT_TRUE(engine.Result().last.sentBytes > 0);
+}
+
+static void TestUploadFailures() {
+    HttpUploadEngine engine;
+    UploadOptions options;
+    options.url = "https://127.0.0.1/";
+    UploadResult result = RunUpload(&engine, options);
+    EXPECT_TRUE(result.reason == UPLOAD_FAILED && !result.error.empty());
+
+    // 服务端读完正文后拒绝
+    {
+        LoopbackResponse response;
+        response.status = 413;
+        response.bodyBytes = 0;
+        LoopbackHttpServer server(response);
+        options.url = server.Url("/upload");
+        options.totalBytes = 1 << 20;
+        result = RunUpload(&engine, options);
+        EXPECT_TRUE(result.reason == UPLOAD_FAILED);
+        EXPECT_TRUE(result.httpStatus == 413);
+    }
+
+    // 端口上没有监听
+    uint16_t closedPort = 0;
+    {
+        LoopbackHttpServer server{LoopbackResponse()};
+        closedPort = server.Port();
+    }
+    options.url = "http://127.0.0.1:" + std::to_string(closedPort) + "/upload";
+    result = RunUpload(&engine, options);
+    EXPECT_TRUE(result.reason == UPLOAD_FAILED && result.error.find("connect") != std::string::npos);
+}
+
+int main() {
+    RUN_TEST(TestUploadCompletes);
+    RUN_TEST(TestAckedBytesLagSentBytes);
+    RUN_TEST(TestUploadConverges);
+    RUN_TEST(TestEarlyResponse);
+    RUN_TEST(TestUploadStop);
+    RUN_TEST(TestUploadFailures);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
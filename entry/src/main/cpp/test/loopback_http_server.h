@@ -0,0 +1,197 @@
+#ifndef NET_GUARDIAN_LOOPBACK_HTTP_SERVER_H
+#define NET_GUARDIAN_LOOPBACK_HTTP_SERVER_H
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <netinet/in.h>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// 替身服务器对每个请求的响应方式
+struct LoopbackResponse {
+    int status = 200;
+    uint64_t bodyBytes = 1 << 20;
+    bool sendContentLength = true;
+    bool endless = false;          // 持续发送直到客户端断开 (不带 Content-Length)
+    size_t chunkBytes = 64 * 1024; // 每次 send 的大小
+    int chunkDelayUs = 0;          // 每块之后的间隔 (限速)
+    int throttledConnections = 0;  // 最先接入的这么多个连接改用 throttledDelayUs 限速 (模拟掉队的流)
+    int throttledDelayUs = 0;
+    uint64_t closeAfterBytes = 0;  // 非 0 时发送这么多正文后提前断开 (模拟中途断线)
+    int headerDelayMs = 0;         // 延迟发送响应头 (模拟慢服务器)
+    // 请求带 Content-Length 时先读完请求正文再响应 (上传测试)
+    size_t readChunkBytes = 64 * 1024; // 每次 recv 的大小
+    int readDelayUs = 0;               // 每次 recv 之后的间隔 (模拟慢上行)
+    int receiveBufferBytes = 0;        // 非 0 时设置 SO_RCVBUF (缩小接收窗口，让发送方的在途数据受限)
+    uint64_t respondAfterBodyBytes = 0; // 非 0 时读到这么多请求正文就先响应，之后继续读 (模拟提前回应的服务器)
+};
+
+/**
+ * 测试用的回环 HTTP 替身服务器：监听 127.0.0.1 的临时端口，每个连接一个线程，按 LoopbackResponse 返回响应
+ * 请求带正文时 (上传) 先按配置的速度读完正文再响应
+ * 析构时关闭监听并等待所有连接线程结束
+ */
+class LoopbackHttpServer {
+public:
+    explicit LoopbackHttpServer(const LoopbackResponse &response) : response_(response) {
+        listenFd_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int reuse = 1;
+        setsockopt(listenFd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (response.receiveBufferBytes > 0) {
+            // 在 listen 之前设置，接受的连接继承该值 (窗口扩大因子在握手时确定)
+            setsockopt(listenFd_, SOL_SOCKET, SO_RCVBUF, &response.receiveBufferBytes, sizeof(int));
+        }
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        bind(listenFd_, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+        listen(listenFd_, 64);
+        socklen_t length = sizeof(address);
+        getsockname(listenFd_, reinterpret_cast<sockaddr *>(&address), &length);
+        port_ = ntohs(address.sin_port);
+        acceptThread_ = std::thread(&LoopbackHttpServer::AcceptLoop, this);
+    }
+
+    ~LoopbackHttpServer() {
+        stop_ = true;
+        acceptThread_.join();
+        close(listenFd_);
+        for (std::thread &worker : workers_) worker.join();
+    }
+
+    uint16_t Port() const { return port_; }
+    std::string Url(const std::string &path = "/download") const {
+        return "http://127.0.0.1:" + std::to_string(port_) + path;
+    }
+    int Connections() const { return connections_.load(); }
+    uint64_t RequestBodyBytes() const { return requestBodyBytes_.load(); } // 所有连接读到的请求正文字节
+    std::string LastRequest() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lastRequest_;
+    }
+
+private:
+    void AcceptLoop() {
+        while (!stop_) {
+            pollfd pfd = {listenFd_, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) continue;
+            int fd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (fd < 0) continue;
+            int index = connections_++;
+            workers_.emplace_back(&LoopbackHttpServer::Serve, this, fd, index);
+        }
+    }
+
+    // 读完请求头 (与请求正文)，按配置发送响应；客户端断开或服务器析构时结束
+    void Serve(int fd, int index) {
+        timeval timeout = {0, 50000}; // 阻塞的 send 定期返回，检查 stop_
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        std::string request;
+        char buffer[4096];
+        while (!stop_ && request.find("\r\n\r\n") == std::string::npos) {
+            pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) continue;
+            ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+            if (n <= 0) break;
+            request.append(buffer, static_cast<size_t>(n));
+        }
+        size_t headerEnd = request.find("\r\n\r\n");
+        uint64_t bodyLength = headerEnd == std::string::npos ? 0 : RequestContentLength(request.substr(0, headerEnd));
+        uint64_t bodyRead = headerEnd == std::string::npos ? 0 : request.size() - (headerEnd + 4);
+        requestBodyBytes_ += bodyRead;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            lastRequest_ = request.substr(0, headerEnd == std::string::npos ? request.size() : headerEnd + 4);
+        }
+        uint64_t respondAt = bodyLength;
+        if (response_.respondAfterBodyBytes > 0) respondAt = std::min(bodyLength, response_.respondAfterBodyBytes);
+        bodyRead = ReadBody(fd, bodyRead, respondAt);
+        for (int waited = 0; waited < response_.headerDelayMs && !stop_; waited += 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+
+        std::string header = "HTTP/1.1 " + std::to_string(response_.status) + " Test\r\nConnection: close\r\n";
+        if (response_.sendContentLength && !response_.endless) {
+            header += "Content-Length: " + std::to_string(response_.bodyBytes) + "\r\n";
+        }
+        header += "\r\n";
+        bool ok = SendAll(fd, header.data(), header.size());
+
+        std::vector<char> chunk(response_.chunkBytes, 'x');
+        int chunkDelayUs = index < response_.throttledConnections ? response_.throttledDelayUs : response_.chunkDelayUs;
+        uint64_t sent = 0;
+        uint64_t limit = response_.endless ? UINT64_MAX : response_.bodyBytes;
+        if (response_.closeAfterBytes > 0) limit = std::min(limit, response_.closeAfterBytes);
+        while (ok && !stop_ && sent < limit) {
+            size_t length = static_cast<size_t>(std::min<uint64_t>(chunk.size(), limit - sent));
+            ok = SendAll(fd, chunk.data(), length);
+            sent += length;
+            if (chunkDelayUs > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(chunkDelayUs));
+            }
+        }
+        if (response_.respondAfterBodyBytes > 0) {
+            ReadBody(fd, bodyRead, bodyLength); // 提前响应之后照常接收，直到客户端停止发送并断开
+        }
+        close(fd);
+    }
+
+    // 按配置的速度读取请求正文，直到累计读到 until 字节或连接断开，返回累计读到的字节数
+    uint64_t ReadBody(int fd, uint64_t bodyRead, uint64_t until) {
+        std::vector<char> readBuffer(response_.readChunkBytes);
+        while (!stop_ && bodyRead < until) {
+            pollfd pfd = {fd, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) continue;
+            ssize_t n = recv(fd, readBuffer.data(), readBuffer.size(), 0);
+            if (n <= 0) break;
+            bodyRead += static_cast<uint64_t>(n);
+            requestBodyBytes_ += static_cast<uint64_t>(n);
+            if (response_.readDelayUs > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(response_.readDelayUs));
+            }
+        }
+        return bodyRead;
+    }
+
+    static uint64_t RequestContentLength(const std::string &header) {
+        size_t pos = header.find("Content-Length: ");
+        return pos == std::string::npos ? 0 : std::stoull(header.substr(pos + 16));
+    }
+
+    bool SendAll(int fd, const char *data, size_t length) {
+        while (length > 0 && !stop_) {
+            ssize_t n = send(fd, data, length, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) continue;
+                return false;
+            }
+            data += n;
+            length -= static_cast<size_t>(n);
+        }
+        return length == 0;
+    }
+
+    LoopbackResponse response_;
+    int listenFd_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<int> connections_{0};
+    std::atomic<uint64_t> requestBodyBytes_{0};
+    std::thread acceptThread_;
+    std::vector<std::thread> workers_; // 只在 acceptThread_ 上追加，析构时 acceptThread_ 已结束
+    std::mutex mutex_;
+    std::string lastRequest_;
+};
+
+#endif
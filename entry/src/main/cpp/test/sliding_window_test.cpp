@@ -0,0 +1,91 @@
+#include "sliding_window.h"
+#include "test_utils.h"
+#include <deque>
+#include <numeric>
+#include <random>
+
+// 原先 traffic_analyzer.cpp 中的两遍扫描实现，作为数值对照
+static double ReferenceJitter(const std::deque<double> &window) {
+    if (window.size() < 2) return 0.0;
+    double mean = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+    double sumSqDiff = 0.0;
+    for (double val : window) {
+        double diff = val - mean;
+        sumSqDiff += diff * diff;
+    }
+    return std::sqrt(sumSqDiff / window.size());
+}
+
+static double ReferenceMean(const std::deque<double> &window) {
+    if (window.empty()) return 0.0;
+    return std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+}
+
+// 逐个样本与两遍扫描结果比对 (相对误差)
+static void CompareAgainstReference(size_t capacity, size_t samples, double base, double spread, unsigned seed) {
+    SlidingWindowStats stats(capacity);
+    std::deque<double> reference;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> dist(-spread, spread);
+
+    for (size_t i = 0; i < samples; i++) {
+        double value = base + dist(rng);
+        stats.Push(value);
+        reference.push_back(value);
+        if (reference.size() > capacity) reference.pop_front();
+
+        double expectedJitter = ReferenceJitter(reference);
+        double expectedMean = ReferenceMean(reference);
+        EXPECT_NEAR(stats.StdDev(), expectedJitter, 1e-9 * (expectedJitter + spread) + 1e-12);
+        EXPECT_NEAR(stats.Mean(), expectedMean, 1e-12 * (std::fabs(expectedMean) + spread) + 1e-12);
+        EXPECT_NEAR(stats.Back(), value, 0.0);
+    }
+    EXPECT_TRUE(stats.Size() == std::min(capacity, samples));
+}
+
+static void TestMatchesTwoPassFormula() {
+    CompareAgainstReference(100, 5000, 5000.0, 4000.0, 1);
+}
+
+// 高速链路：均值远大于波动 (1 Gbps 量级)，最容易出现加减抵消误差
+static void TestLargeMeanSmallSpread() {
+    CompareAgainstReference(100, 20000, 1.0e6, 5.0, 2);
+}
+
+static void TestSmallWindows() {
+    CompareAgainstReference(1, 50, 100.0, 50.0, 3);
+    CompareAgainstReference(2, 50, 100.0, 50.0, 4);
+    CompareAgainstReference(16, 500, 100.0, 50.0, 5);
+}
+
+// 速率突变 (下载 -> 断流) 后，窗口滑过旧样本应回到精确的 0 抖动
+static void TestStepChange() {
+    SlidingWindowStats stats(10);
+    for (int i = 0; i < 10; i++) stats.Push(1.0e7);
+    for (int i = 0; i < 10; i++) stats.Push(0.0);
+    EXPECT_NEAR(stats.StdDev(), 0.0, 1e-6);
+    EXPECT_NEAR(stats.Mean(), 0.0, 1e-6);
+}
+
+static void TestClear() {
+    SlidingWindowStats stats(4);
+    stats.Push(1.0);
+    stats.Push(3.0);
+    EXPECT_NEAR(stats.StdDev(), 1.0, 1e-12);
+    stats.Clear();
+    EXPECT_TRUE(stats.Empty());
+    EXPECT_NEAR(stats.StdDev(), 0.0, 0.0);
+    EXPECT_NEAR(stats.Back(), 0.0, 0.0);
+    stats.Push(7.0);
+    EXPECT_NEAR(stats.Mean(), 7.0, 0.0);
+    EXPECT_NEAR(stats.StdDev(), 0.0, 0.0);
+}
+
+int main() {
+    RUN_TEST(TestMatchesTwoPassFormula);
+    RUN_TEST(TestLargeMeanSmallSpread);
+    RUN_TEST(TestSmallWindows);
+    RUN_TEST(TestStepChange);
+    RUN_TEST(TestClear);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
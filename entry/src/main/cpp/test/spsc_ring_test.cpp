@@ -0,0 +1,145 @@
+#include "sample_history.h"
+#include "spsc_ring.h"
+#include "test_utils.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static void TestCapacityRoundsUp() {
+    SpscRing<int64_t> ring(5);
+    EXPECT_TRUE(ring.Capacity() == 8);
+}
+
+static void TestReadLatestKeepsOrder() {
+    SpscRing<int64_t> ring(8);
+    int64_t out[8] = {0};
+    EXPECT_TRUE(ring.ReadLatest(out, 8) == 0);
+
+    for (int64_t i = 1; i <= 3; i++) ring.Push(i);
+    EXPECT_TRUE(ring.ReadLatest(out, 8) == 3);
+    EXPECT_TRUE(out[0] == 1 && out[2] == 3);
+
+    // 绕回后只保留最近的元素
+    for (int64_t i = 4; i <= 20; i++) ring.Push(i);
+    EXPECT_TRUE(ring.ReadLatest(out, 5) == 5);
+    EXPECT_TRUE(out[0] == 16 && out[4] == 20);
+    uint64_t endSeq = 0;
+    EXPECT_TRUE(ring.ReadLatest(out, 100, &endSeq) == 7); // 最旧的槽位是下一次写入的位置，不读出
+    EXPECT_TRUE(out[0] == 14 && out[6] == 20);
+    EXPECT_TRUE(endSeq == 20); // 序号从 0 开始，最后一个元素 (值 20) 的序号为 19
+}
+
+static void TestClear() {
+    SampleHistory history(4);
+    WaveformSample out[4];
+    history.Push(1000, 1.0);
+    history.Push(2000, 2.0);
+    EXPECT_TRUE(history.ClearSeq() == 0);
+    history.Clear();
+    EXPECT_TRUE(history.Snapshot(out) == 0);
+    EXPECT_TRUE(history.ClearSeq() == 2);
+    history.Push(3000, 3.0);
+    EXPECT_TRUE(history.Snapshot(out) == 1);
+    EXPECT_NEAR(out[0].value, 3.0, 0.0);
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[0], 3000) == 3000);
+    EXPECT_TRUE(history.TotalPushed() == 3);
+}
+
+// 时间戳只保留 32 位 tick，以当前时刻为参照还原 (包括 tick 回绕之后)
+static void TestSampleTimestamps() {
+    SampleHistory history(4);
+    WaveformSample out[4];
+    const int64_t base = (int64_t(1) << 32) * SampleHistory::TICK_US - 250; // 第二个点跨过 tick 回绕
+    history.Push(base, 1.0);
+    history.Push(base + 1000, 2.0);
+    EXPECT_TRUE(history.Snapshot(out) == 2);
+    int64_t now = base + 5000000;
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[0], now) == base - base % SampleHistory::TICK_US);
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[1], now) == (base + 1000) - (base + 1000) % SampleHistory::TICK_US);
+    // 晚于参照时刻的点还原为未来的时间，而不是回绕成很久以前
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[1], base) > base);
+}
+
+// 生产者高速写入递增序列，消费者每次读到的窗口都必须是连续递增的 (没有撕裂或乱序)
+static void TestConcurrentWindowsAreConsistent() {
+    const size_t window = 15;
+    SampleHistory history(window);
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        int64_t tick = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            tick++;
+            history.Push(tick * SampleHistory::TICK_US, static_cast<double>(tick % 1000));
+        }
+    });
+
+    std::vector<WaveformSample> out(window);
+    size_t reads = 0;
+    size_t torn = 0;
+    uint32_t lastNewest = 0;
+    bool monotonic = true;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < deadline) {
+        size_t count = history.Snapshot(out.data());
+        for (size_t i = 0; i < count; i++) {
+            // 时间戳与数值来自同一次写入 (8 字节整体原子读写)
+            if (out[i].value != static_cast<float>(out[i].tick % 1000)) torn++;
+            if (i > 0 && out[i].tick != out[i - 1].tick + 1) torn++;
+        }
+        if (count > 0) {
+            if (out[count - 1].tick < lastNewest) monotonic = false;
+            lastNewest = out[count - 1].tick;
+        }
+        reads++;
+    }
+    stop = true;
+    producer.join();
+
+    EXPECT_TRUE(reads > 0);
+    EXPECT_TRUE(torn == 0);
+    EXPECT_TRUE(monotonic);
+}
+
+// 小容量下读取整个容量：生产者频繁绕回，返回的窗口必须是连续的序号且与 endSeq 对应
+// (包括生产者已写槽位、尚未推进写指针的那一次写入)
+static void TestConcurrentFullCapacityReads() {
+    SpscRing<int64_t> ring(4);
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        int64_t seq = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            ring.Push(seq++); // 元素的值就是它的序号
+        }
+    });
+
+    int64_t out[4] = {0};
+    size_t reads = 0;
+    size_t nonEmpty = 0;
+    size_t broken = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < deadline) {
+        uint64_t endSeq = 0;
+        size_t count = ring.ReadLatest(out, 4, &endSeq);
+        for (size_t i = 0; i < count; i++) {
+            if (out[i] != static_cast<int64_t>(endSeq - count + i)) broken++;
+        }
+        if (count > 0) nonEmpty++;
+        reads++;
+    }
+    stop = true;
+    producer.join();
+
+    EXPECT_TRUE(reads > 0 && nonEmpty > 0);
+    EXPECT_TRUE(broken == 0);
+}
+
+int main() {
+    RUN_TEST(TestCapacityRoundsUp);
+    RUN_TEST(TestReadLatestKeepsOrder);
+    RUN_TEST(TestClear);
+    RUN_TEST(TestSampleTimestamps);
+    RUN_TEST(TestConcurrentWindowsAreConsistent);
+    RUN_TEST(TestConcurrentFullCapacityReads);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include "sync_fence.h"
+#include "test_utils.h"
+#include <chrono>
+#include <unistd.h>
+
+// 用管道的读端模拟 sync fence：写入一个字节即"触发" (变为可读)
+
+static void TestNoFenceIsSignaled() {
+    EXPECT_TRUE(WaitFence(-1, 0) == FENCE_SIGNALED);
+    EXPECT_TRUE(WaitFence(-1, 100) == FENCE_SIGNALED);
+}
+
+// 未触发时按超时返回，不会无限期阻塞
+static void TestPendingFenceTimesOut() {
+    int fds[2];
+    EXPECT_TRUE(pipe(fds) == 0);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(WaitFence(fds[0], 20) == FENCE_TIMEOUT);
+    auto elapsedMs =
+        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_TRUE(elapsedMs >= 15 && elapsedMs < 1000);
+    EXPECT_TRUE(WaitFence(fds[0], 0) == FENCE_TIMEOUT); // 只检查不等待
+    close(fds[0]);
+    close(fds[1]);
+}
+
+static void TestSignaledFence() {
+    int fds[2];
+    EXPECT_TRUE(pipe(fds) == 0);
+    char byte = 1;
+    EXPECT_TRUE(write(fds[1], &byte, 1) == 1);
+    EXPECT_TRUE(WaitFence(fds[0], 0) == FENCE_SIGNALED);
+    EXPECT_TRUE(WaitFence(fds[0], 1000) == FENCE_SIGNALED);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// fd 0 也是合法的 Fence (旧代码只处理 fenceFd > 0)
+static void TestFenceOnFdZero() {
+    int fds[2];
+    EXPECT_TRUE(pipe(fds) == 0);
+    int savedStdin = dup(0);
+    EXPECT_TRUE(dup2(fds[0], 0) == 0);
+    EXPECT_TRUE(WaitFence(0, 0) == FENCE_TIMEOUT);
+    char byte = 1;
+    EXPECT_TRUE(write(fds[1], &byte, 1) == 1);
+    EXPECT_TRUE(WaitFence(0, 0) == FENCE_SIGNALED);
+    dup2(savedStdin, 0);
+    close(savedStdin);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// 已关闭的 fd 不是有效的 Fence
+static void TestInvalidFence() {
+    int fds[2];
+    EXPECT_TRUE(pipe(fds) == 0);
+    int stale = fds[0];
+    close(fds[0]);
+    close(fds[1]);
+    EXPECT_TRUE(WaitFence(stale, 10) == FENCE_ERROR);
+}
+
+int main() {
+    RUN_TEST(TestNoFenceIsSignaled);
+    RUN_TEST(TestPendingFenceTimesOut);
+    RUN_TEST(TestSignaledFence);
+    RUN_TEST(TestFenceOnFdZero);
+    RUN_TEST(TestInvalidFence);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+#include "tcp_metrics.h"
+#include "test_utils.h"
+
+static TcpMetrics Connection(double rttUs, double minRttUs, uint64_t retransmits, uint64_t segmentsOut) {
+    TcpMetrics metrics;
+    metrics.valid = true;
+    metrics.connections = 1;
+    metrics.rttUs = rttUs;
+    metrics.rttVarUs = rttUs / 4;
+    metrics.minRttUs = minRttUs;
+    metrics.retransmits = retransmits;
+    metrics.segmentsOut = segmentsOut;
+    metrics.cwnd = 10;
+    metrics.mss = 1448;
+    metrics.pacingKbps = 1000;
+    return metrics;
+}
+
+// 多连接合并：RTT 取均值、最小 RTT 取最小、计数求和、MSS 取最大，无效的连接被忽略
+static void TestMerge() {
+    TcpMetrics total;
+    MergeTcpMetrics(&total, Connection(10000, 8000, 1, 100));
+    TcpMetrics second = Connection(30000, 6000, 3, 300);
+    second.mss = 1460;
+    MergeTcpMetrics(&total, second);
+    MergeTcpMetrics(&total, TcpMetrics());
+
+    EXPECT_TRUE(total.valid && total.connections == 2);
+    EXPECT_NEAR(total.rttUs, 20000.0, 1e-9);
+    EXPECT_NEAR(total.rttVarUs, 5000.0, 1e-9);
+    EXPECT_NEAR(total.minRttUs, 6000.0, 0.0);
+    EXPECT_TRUE(total.retransmits == 4 && total.segmentsOut == 400);
+    EXPECT_TRUE(total.cwnd == 20 && total.mss == 1460);
+    EXPECT_NEAR(total.pacingKbps, 2000.0, 1e-9);
+    EXPECT_NEAR(RetransmitRatio(total), 0.01, 1e-12);
+
+    // 内核不提供最小 RTT 的连接不影响合并结果
+    MergeTcpMetrics(&total, Connection(20000, 0, 0, 0));
+    EXPECT_NEAR(total.minRttUs, 6000.0, 0.0);
+    EXPECT_TRUE(total.connections == 3);
+
+    // 接收方向 RTT 只对有估计的连接取均值，0 (尚无估计) 不参与
+    EXPECT_NEAR(total.rcvRttUs, 0.0, 0.0);
+    EXPECT_TRUE(total.rcvRttConnections == 0);
+    TcpMetrics receiving = Connection(20000, 20000, 0, 10);
+    receiving.rcvRttUs = 40000;
+    MergeTcpMetrics(&total, receiving);
+    receiving.rcvRttUs = 20000;
+    MergeTcpMetrics(&total, receiving);
+    MergeTcpMetrics(&total, Connection(20000, 20000, 0, 10));
+    EXPECT_NEAR(total.rcvRttUs, 30000.0, 1e-9);
+    EXPECT_TRUE(total.rcvRttConnections == 2 && total.connections == 6);
+}
+
+static void TestClassifyLink() {
+    EXPECT_TRUE(ClassifyLink(TcpMetrics()) == LINK_UNKNOWN);
+    EXPECT_TRUE(ClassifyLink(Connection(0, 0, 0, 10)) == LINK_UNKNOWN); // 段太少且没有 RTT 基线
+    EXPECT_TRUE(ClassifyLink(Connection(21000, 20000, 0, 5000)) == LINK_GOOD);
+    // 重传 5% 而 RTT 接近最小值：随机丢包
+    EXPECT_TRUE(ClassifyLink(Connection(21000, 20000, 250, 5000)) == LINK_LOSSY);
+    // RTT 翻了三倍：排队，同时有重传也算拥塞
+    EXPECT_TRUE(ClassifyLink(Connection(60000, 20000, 0, 5000)) == LINK_CONGESTED);
+    EXPECT_TRUE(ClassifyLink(Connection(60000, 20000, 250, 5000)) == LINK_CONGESTED);
+    // 回环级别的 RTT 即使倍数大，排队时延不到 5ms 也不算拥塞
+    EXPECT_TRUE(ClassifyLink(Connection(200, 20, 0, 5000)) == LINK_GOOD);
+    // 发出的段太少时不按重传率判断丢包
+    EXPECT_TRUE(ClassifyLink(Connection(21000, 20000, 5, 50)) == LINK_GOOD);
+
+    // 下载：发送方向 RTT 停在发请求时的值，接收方向的 RTT 上涨同样判为拥塞
+    TcpMetrics download = Connection(20000, 20000, 0, 20);
+    download.rcvRttUs = 80000;
+    EXPECT_TRUE(ClassifyLink(download) == LINK_CONGESTED);
+}
+
+int main() {
+    RUN_TEST(TestMerge);
+    RUN_TEST(TestClassifyLink);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
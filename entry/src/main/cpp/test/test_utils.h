@@ -0,0 +1,39 @@
+#ifndef NET_GUARDIAN_TEST_UTILS_H
+#define NET_GUARDIAN_TEST_UTILS_H
+
+#include <cmath>
+#include <cstdio>
+
+// 宿主机单元测试使用的极简断言，失败时打印位置并计数，main 返回失败数
+inline int &TestFailureCount() {
+    static int failures = 0;
+    return failures;
+}
+
+#define EXPECT_TRUE(cond)                                                                                              \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            std::fprintf(stderr, "%s:%d: EXPECT_TRUE(%s) failed\n", __FILE__, __LINE__, #cond);                        \
+            TestFailureCount()++;                                                                                      \
+        }                                                                                                              \
+    } while (0)
+
+#define EXPECT_NEAR(actual, expected, tolerance)                                                                       \
+    do {                                                                                                               \
+        double a_ = (actual);                                                                                          \
+        double e_ = (expected);                                                                                        \
+        if (!(std::fabs(a_ - e_) <= (tolerance))) {                                                                    \
+            std::fprintf(stderr, "%s:%d: EXPECT_NEAR(%s, %s) failed: %.12g vs %.12g\n", __FILE__, __LINE__, #actual,   \
+                         #expected, a_, e_);                                                                           \
+            TestFailureCount()++;                                                                                      \
+        }                                                                                                              \
+    } while (0)
+
+#define RUN_TEST(fn)                                                                                                   \
+    do {                                                                                                               \
+        int before_ = TestFailureCount();                                                                              \
+        fn();                                                                                                          \
+        std::printf("[%s] %s\n", TestFailureCount() == before_ ? "PASS" : "FAIL", #fn);                                \
+    } while (0)
+
+#endif
@@ -0,0 +1,147 @@
+#include "test_utils.h"
+#include "traffic_analyzer.h"
+#include <vector>
+
+// 1 MB/s 恒速：每 100ms 到达 102400 字节，对应 8000 kbps
+static const double BYTES_PER_100MS = 102400.0;
+static const double STEADY_KBPS = 8000.0;
+
+static void TestFirstPacketHasNoStats() {
+    TrafficAnalyzer analyzer;
+    EXPECT_TRUE(!analyzer.Current().valid);
+    TrafficStats stats = analyzer.ProcessAt(1000, 0);
+    EXPECT_TRUE(!stats.valid);
+    EXPECT_NEAR(analyzer.Current().totalBytes, 1000.0, 0.0);
+}
+
+static void TestSteadyRate() {
+    TrafficAnalyzer analyzer;
+    analyzer.ProcessAt(0, 0);
+    TrafficStats stats;
+    for (int i = 1; i <= 50; i++) {
+        stats = analyzer.ProcessAt(static_cast<size_t>(BYTES_PER_100MS), i * 100000LL);
+    }
+    EXPECT_TRUE(stats.valid);
+    EXPECT_NEAR(stats.instantKbps, STEADY_KBPS, 1e-6);
+    EXPECT_NEAR(stats.maxKbps, STEADY_KBPS, 1e-6);
+    EXPECT_NEAR(stats.minKbps, STEADY_KBPS, 1e-6);
+    EXPECT_NEAR(stats.avgKbps, STEADY_KBPS, 1e-6);
+    EXPECT_NEAR(stats.jitter, 0.0, 1e-6);
+    EXPECT_NEAR(stats.totalBytes, 50 * BYTES_PER_100MS, 0.0);
+}
+
+// 间隔不足 100ms 的包只累加流量，其余统计保持上一次的值
+static void TestFastPathKeepsLastSample() {
+    TrafficAnalyzer analyzer;
+    analyzer.ProcessAt(0, 0);
+    TrafficStats slow = analyzer.ProcessAt(static_cast<size_t>(BYTES_PER_100MS), 100000);
+    TrafficStats fast = analyzer.ProcessAt(500, 150000);
+    EXPECT_NEAR(fast.instantKbps, slow.instantKbps, 0.0);
+    EXPECT_NEAR(fast.jitter, slow.jitter, 0.0);
+    EXPECT_NEAR(fast.totalBytes, slow.totalBytes + 500, 0.0);
+
+    // 快速路径累积的字节计入下一个样本
+    TrafficStats next = analyzer.ProcessAt(static_cast<size_t>(BYTES_PER_100MS) - 500, 200000);
+    EXPECT_NEAR(next.instantKbps, STEADY_KBPS, 1e-6);
+}
+
+// 前 5 个样本不参与 Min
+static void TestMinIgnoresWarmup() {
+    TrafficAnalyzer analyzer;
+    analyzer.ProcessAt(0, 0);
+    int64_t t = 0;
+    for (int i = 0; i < 5; i++) {
+        t += 100000;
+        analyzer.ProcessAt(1000, t); // 启动阶段的低速样本
+    }
+    TrafficStats stats;
+    for (int i = 0; i < 5; i++) {
+        t += 100000;
+        stats = analyzer.ProcessAt(static_cast<size_t>(BYTES_PER_100MS), t);
+    }
+    EXPECT_NEAR(stats.minKbps, STEADY_KBPS, 1e-6);
+}
+
+static void TestSampleListenerAndReset() {
+    TrafficAnalyzer analyzer;
+    std::vector<double> samples;
+    std::vector<int64_t> sampleTimes;
+    analyzer.SetSampleListener([&samples, &sampleTimes](double kbps, int64_t timeUs) {
+        samples.push_back(kbps);
+        sampleTimes.push_back(timeUs);
+    });
+    analyzer.ProcessAt(0, 0);
+    analyzer.ProcessAt(100, 50000); // 快速路径，不产生样本
+    analyzer.ProcessAt(static_cast<size_t>(BYTES_PER_100MS) - 100, 100000);
+    EXPECT_TRUE(samples.size() == 1);
+    EXPECT_NEAR(samples.empty() ? 0.0 : samples[0], STEADY_KBPS, 1e-6);
+    EXPECT_TRUE(sampleTimes.size() == 1 && sampleTimes[0] == 100000);
+
+    analyzer.Reset();
+    EXPECT_TRUE(!analyzer.Current().valid);
+    TrafficStats stats = analyzer.ProcessAt(10, 5000000);
+    EXPECT_TRUE(!stats.valid);
+    stats = analyzer.ProcessAt(10, 5100000);
+    EXPECT_NEAR(stats.totalBytes, 20.0, 0.0);
+    EXPECT_NEAR(stats.maxKbps, stats.instantKbps, 0.0);
+}
+
+// 两个实例互不影响
+static void TestInstancesAreIndependent() {
+    TrafficAnalyzer download;
+    TrafficAnalyzer upload;
+    download.ProcessAt(0, 0);
+    upload.ProcessAt(0, 0);
+    TrafficStats down = download.ProcessAt(static_cast<size_t>(BYTES_PER_100MS), 100000);
+    TrafficStats up = upload.ProcessAt(static_cast<size_t>(BYTES_PER_100MS / 2), 100000);
+    EXPECT_NEAR(down.instantKbps, STEADY_KBPS, 1e-6);
+    EXPECT_NEAR(up.instantKbps, STEADY_KBPS / 2, 1e-6);
+}
+
+// Process 从注入的时钟取时间，与 ProcessAt 结果一致
+static void TestInjectedClock() {
+    ManualClockSource clock(1000000);
+    TrafficAnalyzer viaClock;
+    TrafficAnalyzer viaTimestamps;
+    viaClock.SetClock(&clock);
+
+    TrafficStats a;
+    TrafficStats b;
+    for (int i = 0; i < 30; i++) {
+        size_t bytes = static_cast<size_t>(BYTES_PER_100MS) * (1 + i % 3);
+        a = viaClock.Process(bytes);
+        b = viaTimestamps.ProcessAt(bytes, clock.NowUs());
+        clock.AdvanceUs(100000);
+    }
+    EXPECT_NEAR(a.instantKbps, b.instantKbps, 0.0);
+    EXPECT_NEAR(a.avgKbps, b.avgKbps, 0.0);
+    EXPECT_NEAR(a.jitter, b.jitter, 0.0);
+
+    viaClock.SetClock(nullptr); // 恢复默认时钟不应崩溃
+    viaClock.Process(1);
+}
+
+static void TestCoarseClockIsMonotonicAndAligned() {
+    ClockSource *coarse = ClockSource::CoarseMonotonic();
+    ClockSource *steady = ClockSource::Steady();
+    int64_t previous = coarse->NowUs();
+    for (int i = 0; i < 1000; i++) {
+        int64_t now = coarse->NowUs();
+        EXPECT_TRUE(now >= previous);
+        previous = now;
+    }
+    // 同一时间基：两者相差不超过一个时钟节拍 (这里放宽到 50ms)
+    EXPECT_NEAR(static_cast<double>(coarse->NowUs()), static_cast<double>(steady->NowUs()), 50000.0);
+}
+
+int main() {
+    RUN_TEST(TestFirstPacketHasNoStats);
+    RUN_TEST(TestSteadyRate);
+    RUN_TEST(TestFastPathKeepsLastSample);
+    RUN_TEST(TestMinIgnoresWarmup);
+    RUN_TEST(TestSampleListenerAndReset);
+    RUN_TEST(TestInstancesAreIndependent);
+    RUN_TEST(TestInjectedClock);
+    RUN_TEST(TestCoarseClockIsMonotonicAndAligned);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
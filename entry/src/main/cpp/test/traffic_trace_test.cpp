@@ -0,0 +1,124 @@
+#include "test_utils.h"
+#include "traffic_analyzer.h"
+#include "traffic_trace.h"
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+static std::string TempTracePath(const char *name) {
+    return std::string("/tmp/") + name + "_" + std::to_string(getpid()) + ".ngtrace";
+}
+
+static void TestVarintRoundTrip() {
+    const uint64_t values[] = {0, 1, 127, 128, 300, 16383, 16384, 1ULL << 35, UINT64_MAX};
+    for (uint64_t value : values) {
+        uint8_t buf[MAX_VARINT_BYTES];
+        size_t n = EncodeVarint(value, buf);
+        uint64_t decoded = 0;
+        EXPECT_TRUE(DecodeVarint(buf, n, &decoded) == n);
+        EXPECT_TRUE(decoded == value);
+        EXPECT_TRUE(DecodeVarint(buf, n - 1, &decoded) == 0); // 截断的数据不能被解码
+    }
+    const int64_t signedValues[] = {0, 1, -1, 1000000, -1000000, INT64_MAX, INT64_MIN};
+    for (int64_t value : signedValues) {
+        EXPECT_TRUE(ZigZagDecode(ZigZagEncode(value)) == value);
+    }
+}
+
+// 写入超过一次扩容大小的记录，再完整读回
+static void TestWriteReadRoundTrip() {
+    std::string path = TempTracePath("roundtrip");
+    std::vector<TraceRecord> expected;
+    int64_t timestampUs = 123456789000LL;
+    for (int i = 0; i < 300000; i++) {
+        timestampUs += (i % 7 == 0) ? -50 : (i % 1000); // 偶尔回退的时间戳也要能编码
+        expected.push_back({timestampUs, static_cast<uint64_t>((i * 2654435761u) % 65536)});
+    }
+
+    {
+        TraceWriter writer;
+        EXPECT_TRUE(writer.Open(path));
+        for (const TraceRecord &record : expected) writer.Append(record.timestampUs, record.byteLength);
+        EXPECT_TRUE(writer.RecordCount() == expected.size());
+    }
+
+    TraceReader reader;
+    EXPECT_TRUE(reader.LoadFile(path));
+    TraceRecord record;
+    size_t count = 0;
+    bool allMatch = true;
+    while (reader.Next(&record)) {
+        if (count >= expected.size() || record.timestampUs != expected[count].timestampUs ||
+            record.byteLength != expected[count].byteLength) {
+            allMatch = false;
+        }
+        count++;
+    }
+    EXPECT_TRUE(allMatch);
+    EXPECT_TRUE(count == expected.size());
+    EXPECT_TRUE(!reader.HasError());
+    std::remove(path.c_str());
+}
+
+// 未正常关闭 (没有截断) 的文件依靠头部的已提交长度读取
+static void TestCommittedLengthBoundsRecords() {
+    std::vector<uint8_t> data(TRACE_HEADER_SIZE + 64, 0);
+    const uint8_t header[] = {'N', 'G', 'T', 'R', 1, 0, 0, 0, 4, 0, 0, 0, 0, 0, 0, 0};
+    std::copy(header, header + sizeof(header), data.begin());
+    const uint8_t records[] = {0x02, 0x05, 0x04, 0x06}; // (+1us, 5B), (+2us, 6B)，之后是预扩容的 0
+    std::copy(records, records + sizeof(records), data.begin() + TRACE_HEADER_SIZE);
+
+    TraceReader reader;
+    EXPECT_TRUE(reader.Load(data.data(), data.size()));
+    TraceRecord record;
+    EXPECT_TRUE(reader.Next(&record) && record.timestampUs == 1 && record.byteLength == 5);
+    EXPECT_TRUE(reader.Next(&record) && record.timestampUs == 3 && record.byteLength == 6);
+    EXPECT_TRUE(!reader.Next(&record));
+    EXPECT_TRUE(!reader.HasError());
+
+    data[0] = 'X';
+    EXPECT_TRUE(!reader.Load(data.data(), data.size()));
+}
+
+// 记录分析器的输入后回放，得到完全相同的统计
+static void TestReplayIsDeterministic() {
+    std::string path = TempTracePath("replay");
+    TrafficAnalyzer live;
+    TraceWriter writer;
+    EXPECT_TRUE(writer.Open(path));
+    live.SetTraceWriter(&writer);
+
+    TrafficStats liveStats;
+    int64_t timestampUs = 5000000;
+    for (int i = 0; i < 20000; i++) {
+        timestampUs += 300 + (i * 37) % 900;
+        liveStats = live.ProcessAt(1000 + (i * 131) % 3000, timestampUs);
+    }
+    live.SetTraceWriter(nullptr);
+    writer.Close();
+
+    TrafficAnalyzer replay;
+    TraceReader reader;
+    EXPECT_TRUE(reader.LoadFile(path));
+    TraceRecord record;
+    TrafficStats replayStats;
+    while (reader.Next(&record)) {
+        replayStats = replay.ProcessAt(static_cast<size_t>(record.byteLength), record.timestampUs);
+    }
+    EXPECT_NEAR(replayStats.instantKbps, liveStats.instantKbps, 0.0);
+    EXPECT_NEAR(replayStats.maxKbps, liveStats.maxKbps, 0.0);
+    EXPECT_NEAR(replayStats.minKbps, liveStats.minKbps, 0.0);
+    EXPECT_NEAR(replayStats.avgKbps, liveStats.avgKbps, 0.0);
+    EXPECT_NEAR(replayStats.jitter, liveStats.jitter, 0.0);
+    EXPECT_NEAR(replayStats.totalBytes, liveStats.totalBytes, 0.0);
+    std::remove(path.c_str());
+}
+
+int main() {
+    RUN_TEST(TestVarintRoundTrip);
+    RUN_TEST(TestWriteReadRoundTrip);
+    RUN_TEST(TestCommittedLengthBoundsRecords);
+    RUN_TEST(TestReplayIsDeterministic);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
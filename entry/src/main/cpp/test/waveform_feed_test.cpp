@@ -0,0 +1,183 @@
+#include "test_utils.h"
+#include "waveform_feed.h"
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+// 深度请求只记录，生产者下一次 Push / Clear 时才换上新历史
+static void TestDepthAppliedByProducer() {
+    WaveformFeed feed;
+    EXPECT_TRUE(!feed.RequestHistoryDepth(1));
+    EXPECT_TRUE(!feed.RequestHistoryDepth(WaveformFeed::MAX_HISTORY_DEPTH + 1));
+    feed.Push(1.0, 0, 0);
+    EXPECT_TRUE(feed.RequestHistoryDepth(40));
+    EXPECT_TRUE(feed.HistoryDepth() == WaveformFeed::DEFAULT_HISTORY_DEPTH);
+    EXPECT_TRUE(feed.HistoryGeneration() == 0);
+
+    feed.Push(2.0, 100000, 100000);
+    EXPECT_TRUE(feed.HistoryDepth() == 40);
+    EXPECT_TRUE(feed.History().Capacity() == 40);
+    EXPECT_TRUE(feed.HistoryGeneration() == 1);
+    std::vector<WaveformSample> out(40);
+    EXPECT_TRUE(feed.History().Snapshot(out.data()) == 1); // 新历史只有替换之后的点
+    EXPECT_NEAR(out[0].value, 2.0, 0.0);
+
+    EXPECT_TRUE(feed.RequestHistoryDepth(20));
+    feed.Clear();
+    EXPECT_TRUE(feed.HistoryDepth() == 20 && feed.HistoryGeneration() == 2);
+    feed.Push(3.0, 200000, 200000); // 深度没有再变，不替换
+    EXPECT_TRUE(feed.HistoryGeneration() == 2);
+}
+
+// 消费者持有历史锁时生产者不等待，推迟到锁释放后的下一次 Push
+static void TestSwapDeferredWhileConsumerReads() {
+    WaveformFeed feed;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool locked = false;
+    bool release = false;
+    std::thread consumer([&]() {
+        auto historyLock = feed.LockHistory();
+        std::unique_lock<std::mutex> lock(mutex);
+        locked = true;
+        cv.notify_all();
+        cv.wait(lock, [&]() { return release; });
+    });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&]() { return locked; });
+    }
+    EXPECT_TRUE(feed.RequestHistoryDepth(30));
+    feed.Push(1.0, 0, 0);
+    EXPECT_TRUE(feed.HistoryDepth() == WaveformFeed::DEFAULT_HISTORY_DEPTH);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        release = true;
+    }
+    cv.notify_all();
+    consumer.join();
+    feed.Push(2.0, 100000, 100000);
+    EXPECT_TRUE(feed.HistoryDepth() == 30);
+}
+
+// 样本时钟与渲染时钟不同源：首个样本锚定到当前时刻，之后保留样本间的真实间隔
+static void TestClockMapping() {
+    WaveformFeed feed;
+    const int64_t now = 50000000;
+    feed.Push(1.0, 1000, now);
+    feed.Push(2.0, 101000, now + 100000);
+    feed.Push(3.0, 150000, now + 100000); // 映射后落在未来：重新锚定到当前时刻，但不早于上一个点
+    std::vector<WaveformSample> out(WaveformFeed::DEFAULT_HISTORY_DEPTH);
+    EXPECT_TRUE(feed.History().Snapshot(out.data()) == 3);
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[0], now) == now);
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[1], now) == now + 100000);
+    EXPECT_TRUE(SampleHistory::SampleTimeUs(out[2], now) == now + 100000);
+}
+
+// 生产者线程持续推送，另一个线程反复修改深度并读取：每次读到的窗口都完整连续，深度切换确实发生
+static void TestResizeWhilePushing() {
+    WaveformFeed feed;
+    std::atomic<bool> stop{false};
+    std::thread producer([&]() {
+        int64_t tick = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            tick++;
+            int64_t timeUs = tick * SampleHistory::TICK_US;
+            feed.Push(static_cast<double>(tick % 1000), timeUs, timeUs);
+        }
+    });
+
+    const size_t depths[] = {4, 64, 15, 33, 2};
+    std::vector<WaveformSample> out(64);
+    size_t reads = 0;
+    size_t broken = 0;
+    uint64_t lastGeneration = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(200);
+    while (std::chrono::steady_clock::now() < deadline) {
+        feed.RequestHistoryDepth(depths[reads % 5]);
+        auto historyLock = feed.LockHistory();
+        size_t count = feed.History().Snapshot(out.data());
+        if (count > feed.History().Capacity() || feed.History().Capacity() != feed.HistoryDepth()) broken++;
+        for (size_t i = 0; i < count; i++) {
+            if (out[i].value != static_cast<float>(out[i].tick % 1000)) broken++;
+            if (i > 0 && out[i].tick != out[i - 1].tick + 1) broken++;
+        }
+        lastGeneration = feed.HistoryGeneration();
+        reads++;
+    }
+    stop = true;
+    producer.join();
+
+    EXPECT_TRUE(reads > 0);
+    EXPECT_TRUE(broken == 0);
+    EXPECT_TRUE(lastGeneration > 0);
+}
+
+// 生产者身份互斥：持有者可以重复获取，非持有者的释放被忽略，释放后其他一方才能获取
+static void TestProducerClaim() {
+    WaveformFeed feed;
+    int engine = 0;
+    int analyzer = 0;
+    EXPECT_TRUE(feed.Producer() == nullptr);
+    EXPECT_TRUE(feed.ClaimProducer(&engine));
+    EXPECT_TRUE(feed.ClaimProducer(&engine));
+    EXPECT_TRUE(!feed.ClaimProducer(&analyzer));
+    feed.ReleaseProducer(&analyzer);
+    EXPECT_TRUE(feed.Producer() == &engine);
+    feed.ReleaseProducer(&engine);
+    EXPECT_TRUE(feed.ClaimProducer(&analyzer));
+    EXPECT_TRUE(feed.Producer() == &analyzer);
+}
+
+// 两个线程争用同一通道，只在持有身份时推送：历史里的样本序号始终连续 (没有交错写坏的槽位)
+static void TestContendedProducers() {
+    WaveformFeed feed(64);
+    std::atomic<int64_t> tick{0};
+    std::atomic<bool> stop{false};
+    auto produce = [&]() {
+        int owner = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            if (!feed.ClaimProducer(&owner)) continue;
+            for (int i = 0; i < 16; i++) {
+                int64_t next = tick.fetch_add(1, std::memory_order_relaxed) + 1;
+                int64_t timeUs = next * SampleHistory::TICK_US;
+                feed.Push(static_cast<double>(next % 1000), timeUs, timeUs);
+            }
+            feed.ReleaseProducer(&owner);
+        }
+    };
+    std::thread first(produce);
+    std::thread second(produce);
+
+    std::vector<WaveformSample> out(64);
+    size_t reads = 0;
+    size_t broken = 0;
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (std::chrono::steady_clock::now() < deadline) {
+        auto historyLock = feed.LockHistory();
+        size_t count = feed.History().Snapshot(out.data());
+        for (size_t i = 0; i < count; i++) {
+            if (out[i].value != static_cast<float>(out[i].tick % 1000)) broken++;
+            if (i > 0 && out[i].tick != out[i - 1].tick + 1) broken++;
+        }
+        reads++;
+    }
+    stop = true;
+    first.join();
+    second.join();
+
+    EXPECT_TRUE(reads > 0);
+    EXPECT_TRUE(broken == 0);
+    EXPECT_TRUE(feed.Producer() == nullptr);
+}
+
+int main() {
+    RUN_TEST(TestDepthAppliedByProducer);
+    RUN_TEST(TestSwapDeferredWhileConsumerReads);
+    RUN_TEST(TestClockMapping);
+    RUN_TEST(TestResizeWhilePushing);
+    RUN_TEST(TestProducerClaim);
+    RUN_TEST(TestContendedProducers);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
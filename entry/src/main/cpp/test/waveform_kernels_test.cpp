@@ -0,0 +1,65 @@
+#include "test_utils.h"
+#include "waveform_kernels.h"
+#include <cstdio>
+#include <vector>
+
+static std::vector<double> MakeSamples(size_t count) {
+    std::vector<double> data(count);
+    for (size_t i = 0; i < count; i++) data[i] = static_cast<double>((i * 7919) % 10007) * 1.5 - 300.0;
+    return data;
+}
+
+// 各种长度 (含不足一个向量、向量尾部) 与标量实现逐元素一致
+static void TestScanMinMaxMatchesScalar() {
+    for (size_t count = 1; count <= 67; count++) {
+        std::vector<double> data = MakeSamples(count);
+        double low = 0;
+        double high = 0;
+        double expectLow = 0;
+        double expectHigh = 0;
+        ScanMinMax(data.data(), count, &low, &high);
+        ScanMinMaxScalar(data.data(), count, &expectLow, &expectHigh);
+        EXPECT_NEAR(low, expectLow, 0.0);
+        EXPECT_NEAR(high, expectHigh, 0.0);
+    }
+}
+
+// 极值落在向量尾部 / 第一个元素
+static void TestScanMinMaxExtremesAtEdges() {
+    std::vector<double> data(9, 5.0);
+    data[0] = -1.0;
+    data[8] = 42.0;
+    double low = 0;
+    double high = 0;
+    ScanMinMax(data.data(), data.size(), &low, &high);
+    EXPECT_NEAR(low, -1.0, 0.0);
+    EXPECT_NEAR(high, 42.0, 0.0);
+}
+
+static void TestValuesToPixelYMatchesScalar() {
+    for (size_t count = 1; count <= 67; count++) {
+        std::vector<double> data = MakeSamples(count);
+        std::vector<float> ys(count);
+        std::vector<float> expect(count);
+        ValuesToPixelY(data.data(), count, 20000.0, 720, ys.data());
+        ValuesToPixelYScalar(data.data(), count, 20000.0, 720, expect.data());
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_NEAR(ys[i], expect[i], 1e-3);
+        }
+    }
+    double values[4] = {0.0, 1000.0, 2000.0, 500.0};
+    float ys[4];
+    ValuesToPixelY(values, 4, 2000.0, 400, ys);
+    EXPECT_NEAR(ys[0], 400.0, 0.0);
+    EXPECT_NEAR(ys[1], 200.0, 0.0);
+    EXPECT_NEAR(ys[2], 0.0, 0.0);
+    EXPECT_NEAR(ys[3], 300.0, 0.0);
+}
+
+int main() {
+    printf("backend: %s\n", WaveformKernelBackend());
+    RUN_TEST(TestScanMinMaxMatchesScalar);
+    RUN_TEST(TestScanMinMaxExtremesAtEdges);
+    RUN_TEST(TestValuesToPixelYMatchesScalar);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
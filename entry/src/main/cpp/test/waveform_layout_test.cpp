@@ -0,0 +1,214 @@
+#include "test_utils.h"
+#include "waveform_layout.h"
+#include <algorithm>
+#include <vector>
+
+static const int32_t WIDTH = 1400;
+static const int32_t HEIGHT = 400;
+static const int64_t WINDOW_US = 1400000; // 每列 1 毫秒，样本间隔 100 毫秒 = 100 列
+static const int64_t SAMPLE_US = 100000;
+static const float MARGIN = 4.0f;
+
+struct Samples {
+    std::vector<int64_t> times;
+    std::vector<double> values;
+    uint64_t endSeq = 0;
+};
+
+// 序号 [first, end) 的样本，每 SAMPLE_US 一个 (值在 1000 附近小幅波动，刻度保持不变)
+static Samples Range(uint64_t first, uint64_t end) {
+    Samples samples;
+    for (uint64_t i = first; i < end; i++) {
+        samples.times.push_back(static_cast<int64_t>(i) * SAMPLE_US);
+        samples.values.push_back(1000.0 + static_cast<double>(i % 7) * 50.0);
+    }
+    samples.endSeq = end;
+    return samples;
+}
+
+static WaveformLayout Layout(const Samples &samples, int64_t nowUs, uint32_t generation = 0,
+                             int64_t windowUs = WINDOW_US) {
+    size_t count = samples.times.size();
+    std::vector<int64_t> columns(count);
+    std::vector<double> lows(count);
+    std::vector<double> highs(count);
+    int64_t nowColumn = WaveformColumn(nowUs, WIDTH, windowUs);
+    size_t points = AggregateColumns(samples.times.data(), samples.values.data(), count, WIDTH, windowUs,
+                                     nowColumn - (WIDTH - 1), columns.data(), lows.data(), highs.data());
+    WaveformLayout layout = ComputeWaveformLayout(columns.data(), lows.data(), highs.data(), points, WIDTH, HEIGHT,
+                                                  windowUs, nowColumn, MARGIN, generation);
+    layout.endSeq = samples.endSeq;
+    return layout;
+}
+
+static void TestNiceScale() {
+    EXPECT_NEAR(NiceWaveformScale(0), 200.0, 0.0);      // 最小刻度 100 * 1.2 -> 200
+    EXPECT_NEAR(NiceWaveformScale(1000), 2000.0, 0.0);  // 1200 -> 2000
+    EXPECT_NEAR(NiceWaveformScale(4000), 5000.0, 0.0);  // 4800 -> 5000
+    EXPECT_NEAR(NiceWaveformScale(9000), 20000.0, 0.0); // 10800 -> 20000
+}
+
+static void TestWaveformColumn() {
+    EXPECT_TRUE(WaveformColumn(0, WIDTH, WINDOW_US) == 0);
+    EXPECT_TRUE(WaveformColumn(999, WIDTH, WINDOW_US) == 0);
+    EXPECT_TRUE(WaveformColumn(1000, WIDTH, WINDOW_US) == 1);
+    EXPECT_TRUE(WaveformColumn(-1, WIDTH, WINDOW_US) == -1); // 向下取整
+    // 列宽不是整数微秒：1080 列铺满 1.4 秒
+    EXPECT_TRUE(WaveformColumn(1400000, 1080, WINDOW_US) == 1080);
+    EXPECT_TRUE(WaveformColumn(1399999, 1080, WINDOW_US) == 1079);
+}
+
+// 同一列的样本合并为 min/max，屏幕左侧外只保留最后一列
+static void TestAggregateColumns() {
+    // 10 列铺满 1000 微秒：每列 100 微秒
+    std::vector<int64_t> times = {50, 60, 120, 150, 199, 310};
+    std::vector<double> values = {5, 1, 7, 2, 4, 9};
+    int64_t columns[6];
+    double lows[6];
+    double highs[6];
+
+    size_t points = AggregateColumns(times.data(), values.data(), times.size(), 10, 1000, 0, columns, lows, highs);
+    EXPECT_TRUE(points == 3);
+    EXPECT_TRUE(columns[0] == 0 && columns[1] == 1 && columns[2] == 3);
+    EXPECT_NEAR(lows[0], 1.0, 0.0);
+    EXPECT_NEAR(highs[0], 5.0, 0.0);
+    EXPECT_NEAR(lows[1], 2.0, 0.0);
+    EXPECT_NEAR(highs[1], 7.0, 0.0);
+    EXPECT_NEAR(lows[2], 9.0, 0.0);
+    EXPECT_NEAR(highs[2], 9.0, 0.0);
+
+    // 屏幕从第 2 列开始：第 0 列丢弃，第 1 列作为左边界外的连接点保留
+    points = AggregateColumns(times.data(), values.data(), times.size(), 10, 1000, 2, columns, lows, highs);
+    EXPECT_TRUE(points == 2);
+    EXPECT_TRUE(columns[0] == 1 && columns[1] == 3);
+    EXPECT_NEAR(highs[0], 7.0, 0.0);
+
+    // 与时间原点无关：负时间同样按向下取整分列
+    std::vector<int64_t> negative = {-150, -120, -50};
+    points = AggregateColumns(negative.data(), values.data(), negative.size(), 10, 1000, -10, columns, lows, highs);
+    EXPECT_TRUE(points == 2);
+    EXPECT_TRUE(columns[0] == -2 && columns[1] == -1);
+    EXPECT_NEAR(lows[0], 1.0, 0.0);
+    EXPECT_NEAR(highs[0], 5.0, 0.0);
+}
+
+static void TestLayoutBand() {
+    Samples samples;
+    samples.times = {0, SAMPLE_US};
+    samples.values = {1000, 1500};
+    WaveformLayout layout = Layout(samples, SAMPLE_US);
+    EXPECT_TRUE(layout.count == 2);
+    EXPECT_TRUE(layout.ColumnX(layout.lastColumn) == WIDTH - 1); // 当前时刻在最右一列
+    EXPECT_TRUE(layout.ColumnX(layout.firstColumn) == WIDTH - 101);
+    EXPECT_TRUE(layout.partialTail);
+    EXPECT_NEAR(layout.scale, 2000.0, 0.0);
+    // 1500 -> y = 100, 1000 -> y = 200，再加描边余量
+    EXPECT_TRUE(layout.top == 96);
+    EXPECT_TRUE(layout.bottom == 204);
+
+    WaveformLayout empty = Layout(Range(0, 1), 0);
+    EXPECT_TRUE(empty.top >= empty.bottom);
+
+    // 所有点都滑出窗口后不再需要滚动
+    EXPECT_TRUE(layout.HasVisiblePoints());
+    EXPECT_TRUE(!Layout(samples, SAMPLE_US + WINDOW_US).HasVisiblePoints());
+}
+
+// 窗口按时间平移：每过 1 毫秒左移 1 列，与是否有新样本无关
+static void TestScrollWhenFull() {
+    WaveformLayout from = Layout(Range(0, 15), 1450000);
+    EXPECT_TRUE(from.originColumn == 51 && from.firstColumn == 0); // 第一个点在左边界外
+    EXPECT_TRUE(!from.partialTail);
+
+    // 一个新样本，时间前进 100 毫秒
+    WaveformLayout to = Layout(Range(0, 16), 1550000);
+    WaveformScrollPlan plan;
+    EXPECT_TRUE(PlanWaveformScroll(from, to, MARGIN, &plan));
+    EXPECT_TRUE(plan.shiftPx == 100);
+    EXPECT_TRUE(plan.stripX == 1400 - 151 - 4); // 从旧帧最后一个点开始
+    EXPECT_TRUE(plan.bandTop == std::min(from.top, to.top));
+    EXPECT_TRUE(plan.bandBottom == std::max(from.bottom, to.bottom)); // 填充从左边界外开始，下方只有填充
+    // 有平移：整行宽度都是脏区域，填充的右边缘在移动，一直延伸到底部
+    EXPECT_TRUE(plan.damageX == 0 && plan.damageW == WIDTH);
+    EXPECT_TRUE(plan.damageY == plan.bandTop && plan.damageY + plan.damageH == HEIGHT);
+
+    // 没有新样本，时间只前进 10 毫秒：曲线整体左移，最右侧露出的空白重画
+    WaveformLayout idle = Layout(Range(0, 15), 1460000);
+    EXPECT_TRUE(PlanWaveformScroll(from, idle, MARGIN, &plan));
+    EXPECT_TRUE(plan.shiftPx == 10);
+    EXPECT_TRUE(plan.stripX == 1400 - 61 - 4);
+
+    // 两帧之间来了 3 个样本
+    WaveformLayout later = Layout(Range(0, 18), 1750000);
+    EXPECT_TRUE(PlanWaveformScroll(from, later, MARGIN, &plan));
+    EXPECT_TRUE(plan.shiftPx == 300);
+    EXPECT_TRUE(plan.stripX == 1400 - 351 - 4);
+}
+
+// 曲线还没铺满窗口时填充的左边缘在屏幕内，随平移移动，条带下方整块都要平移
+static void TestAppendWhileFilling() {
+    WaveformLayout from = Layout(Range(0, 5), 450000);
+    WaveformLayout to = Layout(Range(0, 6), 550000);
+    WaveformScrollPlan plan;
+    EXPECT_TRUE(PlanWaveformScroll(from, to, MARGIN, &plan));
+    EXPECT_TRUE(plan.shiftPx == 100);
+    EXPECT_TRUE(plan.bandBottom == HEIGHT);
+    EXPECT_TRUE(plan.damageY + plan.damageH == HEIGHT);
+
+    // 同一列内追加：不平移，只重画右侧
+    Samples samples = Range(0, 5);
+    samples.times.push_back(450000);
+    samples.values.push_back(1000);
+    samples.endSeq = 6;
+    WaveformLayout same = Layout(samples, 450000);
+    EXPECT_TRUE(PlanWaveformScroll(from, same, MARGIN, &plan));
+    EXPECT_TRUE(plan.shiftPx == 0);
+    EXPECT_TRUE(plan.stripX == static_cast<int32_t>(from.ColumnX(400)) - 4);
+    EXPECT_TRUE(plan.damageX == plan.stripX);
+}
+
+static void TestFullRedrawCases() {
+    WaveformScrollPlan plan;
+    WaveformLayout from = Layout(Range(0, 15), 1450000);
+
+    EXPECT_TRUE(!PlanWaveformScroll(WaveformLayout(), from, MARGIN, &plan)); // 没有旧内容
+    EXPECT_TRUE(!PlanWaveformScroll(from, Layout(Range(0, 30), 2850000), MARGIN, &plan)); // 平移超过一屏
+    EXPECT_TRUE(!PlanWaveformScroll(from, Layout(Range(0, 16), 1550000, 1), MARGIN, &plan)); // 样式变化
+    EXPECT_TRUE(!PlanWaveformScroll(from, Layout(Range(0, 16), 1550000, 0, WINDOW_US * 2), MARGIN,
+                                    &plan)); // 窗口长度变化
+    EXPECT_TRUE(!PlanWaveformScroll(from, Layout(Range(0, 15), 1440000), MARGIN, &plan)); // 时间倒退
+
+    Samples spike = Range(0, 16);
+    spike.values.back() = 9000; // 刻度变化
+    EXPECT_TRUE(!PlanWaveformScroll(from, Layout(spike, 1550000), MARGIN, &plan));
+
+    // 历史被清空后重新开始
+    WaveformLayout cleared = Layout(Range(0, 16), 1550000);
+    cleared.clearSeq = 15;
+    EXPECT_TRUE(!PlanWaveformScroll(from, cleared, MARGIN, &plan));
+
+    // 屏幕内还能看到的点被挤出了历史
+    EXPECT_TRUE(!PlanWaveformScroll(from, Layout(Range(3, 16), 1550000), MARGIN, &plan));
+}
+
+// 最后一个点位于当前时刻所在列时值还会变化，增量条带要从它前一个点开始
+static void TestPartialTailWidensStrip() {
+    WaveformLayout from = Layout(Range(0, 5), 400000);
+    EXPECT_TRUE(from.partialTail);
+    WaveformLayout to = Layout(Range(0, 6), 500000);
+    WaveformScrollPlan plan;
+    EXPECT_TRUE(PlanWaveformScroll(from, to, MARGIN, &plan));
+    EXPECT_TRUE(plan.stripX == static_cast<int32_t>(to.ColumnX(300)) - 4);
+}
+
+int main() {
+    RUN_TEST(TestNiceScale);
+    RUN_TEST(TestWaveformColumn);
+    RUN_TEST(TestAggregateColumns);
+    RUN_TEST(TestLayoutBand);
+    RUN_TEST(TestScrollWhenFull);
+    RUN_TEST(TestAppendWhileFilling);
+    RUN_TEST(TestFullRedrawCases);
+    RUN_TEST(TestPartialTailWidensStrip);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
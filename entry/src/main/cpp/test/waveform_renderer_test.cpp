@@ -0,0 +1,339 @@
+#include "headless_surface.h"
+#include "sample_history.h"
+#include "test_utils.h"
+#include "waveform_renderer.h"
+#include <cstring>
+#include <vector>
+
+static const uint64_t WIDTH = 200;
+static const uint64_t HEIGHT = 80;
+// 左边缘：增量结果保留了滑出窗口的线段，整帧重画则从第一个点的圆头开始，两者只在描边余量内不同
+static const uint64_t EDGE_COLUMNS = 4;
+static const int64_t SAMPLE_US = 100000; // 样本间隔下限，与 RenderManager 一致
+static const int64_t FRAME_US = 16667;
+
+// 刻度基本稳定、偶尔跳变的伪随机样本
+static double NextSample(uint64_t *state) {
+    *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+    uint64_t r = *state >> 33;
+    return (r % 17 == 0) ? 9000.0 + static_cast<double>(r % 3000) : 2000.0 + static_cast<double>(r % 4000);
+}
+
+// 与 RenderManager 相同：depth 个间隔不小于 SAMPLE_US 的样本总能覆盖整个窗口
+static int64_t WindowUs(size_t depth) {
+    return static_cast<int64_t>(depth - 1) * SAMPLE_US;
+}
+
+// 手动推进的时钟与不规则到达的样本 (间隔 100 ~ 250 毫秒)
+struct SampleFeed {
+    explicit SampleFeed(uint64_t seed) : rng(seed) {}
+    // 时钟前进 stepUs，期间到期的样本写入历史
+    void Advance(SampleHistory *history, int64_t stepUs) {
+        nowUs += stepUs;
+        while (nextSampleUs <= nowUs) {
+            history->Push(nextSampleUs, NextSample(&rng));
+            nextSampleUs += SAMPLE_US + static_cast<int64_t>((rng >> 40) % 150000);
+        }
+    }
+    uint64_t rng;
+    int64_t nowUs = 1000000000; // 时间原点任意，与 0 无关
+    int64_t nextSampleUs = 1000000000;
+};
+
+// 两个 Surface 最近一次提交的画面 (跳过左边缘) 不同的像素数
+static size_t CountDifferentPixels(const HeadlessSurface &a, const HeadlessSurface &b) {
+    size_t diff = 0;
+    for (uint64_t y = 0; y < a.Height(); y++) {
+        for (uint64_t x = EDGE_COLUMNS; x < a.Width(); x++) {
+            if (a.PresentedPixel(x, y) != b.PresentedPixel(x, y)) diff++;
+        }
+    }
+    return diff;
+}
+
+// 增量滚动的结果与每帧整帧重画的结果逐像素一致 (没有出帧时屏幕上的上一帧也应与之一致)
+static void RunScrollMatchesFullRedraw(size_t depth, int32_t stride, int64_t frameUs) {
+    SampleHistory history(depth);
+    HeadlessSurface incremental(WIDTH, HEIGHT, 3, stride);
+    HeadlessSurface reference(WIDTH, HEIGHT, 1);
+    WaveformRenderer scrolling;
+    WaveformRenderer redraw;
+
+    SampleFeed feed(7);
+    size_t partialFrames = 0;
+    size_t mismatchedFrames = 0;
+    for (int frame = 0; frame < 400; frame++) {
+        feed.Advance(&history, frameUs);
+        WaveformRenderer::FrameResult result =
+            scrolling.RenderFrame(&incremental, history, WindowUs(depth), feed.nowUs);
+        EXPECT_TRUE(result == WaveformRenderer::FRAME_PRESENTED || result == WaveformRenderer::FRAME_UNCHANGED);
+        redraw.InvalidateContent();
+        EXPECT_TRUE(redraw.RenderFrame(&reference, history, WindowUs(depth), feed.nowUs) ==
+                    WaveformRenderer::FRAME_PRESENTED);
+        partialFrames += (result == WaveformRenderer::FRAME_PRESENTED && incremental.LastDamagePartial()) ? 1 : 0;
+        if (CountDifferentPixels(incremental, reference) != 0) {
+            if (mismatchedFrames == 0) {
+                std::fprintf(stderr, "first mismatch at frame %d (depth %zu)\n", frame, depth);
+            }
+            mismatchedFrames++;
+        }
+    }
+    EXPECT_TRUE(mismatchedFrames == 0);
+    EXPECT_TRUE(partialFrames > 100); // 大部分帧确实走了增量路径
+}
+
+// 帧率出帧：多数帧没有新样本，只随时间平移 (曲线滑出左边界后仍一致)
+static void TestScrollMatchesFullRedraw() {
+    RunScrollMatchesFullRedraw(40, 0, FRAME_US);
+}
+
+// 带行填充的缓冲区 (stride > width * 4)
+static void TestScrollMatchesFullRedrawPaddedStride() {
+    RunScrollMatchesFullRedraw(40, static_cast<int32_t>(WIDTH * 4 + 64), FRAME_US);
+}
+
+// 一列覆盖多个样本时显示 min/max 包络，末列的值随新样本变化，增量结果同样一致
+static void TestDecimatedScrollMatchesFullRedraw() {
+    RunScrollMatchesFullRedraw(1000, 0, SAMPLE_US);
+}
+
+// 提交的脏区域覆盖了与上一次提交相比变化的全部像素
+static void TestDamageCoversChangedPixels() {
+    const size_t depth = 40;
+    SampleHistory history(depth);
+    HeadlessSurface surface(WIDTH, HEIGHT, 3);
+    WaveformRenderer renderer;
+    std::vector<uint32_t> previous;
+    SampleFeed feed(11);
+    size_t uncovered = 0;
+    for (int frame = 0; frame < 300; frame++) {
+        feed.Advance(&history, FRAME_US);
+        renderer.RenderFrame(&surface, history, WindowUs(depth), feed.nowUs);
+        if (surface.LastDamagePartial() && !previous.empty()) {
+            const SurfaceDamage &damage = surface.LastDamage();
+            for (uint64_t y = 0; y < HEIGHT; y++) {
+                for (uint64_t x = 0; x < WIDTH; x++) {
+                    bool inside = static_cast<int64_t>(x) >= damage.x && static_cast<int64_t>(x) < damage.x + damage.w &&
+                        static_cast<int64_t>(y) >= damage.y && static_cast<int64_t>(y) < damage.y + damage.h;
+                    if (!inside && surface.PresentedPixel(x, y) != previous[y * WIDTH + x]) uncovered++;
+                }
+            }
+        }
+        previous.resize(WIDTH * HEIGHT);
+        for (uint64_t y = 0; y < HEIGHT; y++) {
+            for (uint64_t x = 0; x < WIDTH; x++) previous[y * WIDTH + x] = surface.PresentedPixel(x, y);
+        }
+    }
+    EXPECT_TRUE(uncovered == 0);
+}
+
+// 像素与样式一致：背景色、描边色、曲线下方的渐变填充
+static void TestPixelsFollowStyle() {
+    const size_t depth = 15;
+    SampleHistory history(depth);
+    for (size_t i = 0; i < depth; i++) history.Push(static_cast<int64_t>(i) * SAMPLE_US, 500.0);
+    int64_t nowUs = WindowUs(depth);
+    HeadlessSurface surface(WIDTH, HEIGHT);
+    WaveformRenderer renderer;
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs) == WaveformRenderer::FRAME_PRESENTED);
+
+    // 500 -> 刻度 1000，曲线位于半高处
+    WaveformStyle style;
+    EXPECT_TRUE(surface.PresentedPixel(WIDTH / 2, 2) == style.backgroundColor);
+    EXPECT_TRUE(surface.PresentedPixel(WIDTH / 2, HEIGHT / 2) == style.lineColor);
+    uint32_t fill = surface.PresentedPixel(WIDTH / 2, HEIGHT / 2 + 8);
+    EXPECT_TRUE(fill != style.backgroundColor && (fill & 0xFF) > ((fill >> 16) & 0xFF)); // 偏蓝
+
+    // 改样式后整帧重画
+    style.backgroundColor = 0xFF000000;
+    style.lineColor = 0xFFFF0000;
+    renderer.SetStyle(style);
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs) == WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(!surface.LastDamagePartial());
+    EXPECT_TRUE(surface.PresentedPixel(WIDTH / 2, 2) == 0xFF000000);
+    EXPECT_TRUE(surface.PresentedPixel(WIDTH / 2, HEIGHT / 2) == 0xFFFF0000);
+}
+
+// 空历史只画背景；尺寸变化后整帧重画；尺寸为 0 时不出帧
+static void TestEmptyHistoryAndResize() {
+    const size_t depth = 15;
+    SampleHistory history(depth);
+    const int64_t windowUs = WindowUs(depth);
+    HeadlessSurface surface(WIDTH, HEIGHT, 2);
+    WaveformRenderer renderer;
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, windowUs, 0) == WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(surface.PresentedPixel(WIDTH - 1, HEIGHT - 1) == WaveformStyle().backgroundColor);
+    EXPECT_TRUE(!renderer.Animating());
+    // 没有样本、窗口也没动：不再出帧
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, windowUs, 0) == WaveformRenderer::FRAME_UNCHANGED);
+
+    int64_t nowUs = 0;
+    for (int i = 0; i < 20; i++) {
+        nowUs += SAMPLE_US;
+        history.Push(nowUs, 1000.0 + i * 10);
+        renderer.RenderFrame(&surface, history, windowUs, nowUs);
+    }
+    surface.Resize(WIDTH / 2, HEIGHT);
+    nowUs += SAMPLE_US;
+    history.Push(nowUs, 1500.0);
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, windowUs, nowUs) == WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(!surface.LastDamagePartial());
+
+    HeadlessSurface reference(WIDTH / 2, HEIGHT, 1);
+    WaveformRenderer fresh;
+    fresh.RenderFrame(&reference, history, windowUs, nowUs);
+    EXPECT_TRUE(CountDifferentPixels(surface, reference) == 0);
+
+    surface.Resize(0, 0);
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, windowUs, nowUs) == WaveformRenderer::FRAME_EMPTY_SURFACE);
+}
+
+// 释放资源后可以继续出帧 (对应 Surface 销毁后重新创建)
+static void TestReleaseAndReuse() {
+    const size_t depth = 15;
+    SampleHistory history(depth);
+    for (int i = 0; i < 30; i++) history.Push(i * SAMPLE_US, 100.0 * (i % 7));
+    int64_t nowUs = 30 * SAMPLE_US;
+    HeadlessSurface surface(WIDTH, HEIGHT);
+    WaveformRenderer renderer;
+    renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs);
+    renderer.ReleaseResources();
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs) == WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(!surface.LastDamagePartial());
+    EXPECT_TRUE(surface.PresentedCount() == 2);
+}
+
+// 没有可写缓冲区时跳帧：不提交、不放弃缓冲区；之后的增量帧与整帧重画仍然一致
+static void TestSkippedFramesKeepScrollConsistent() {
+    const size_t depth = 40;
+    SampleHistory history(depth);
+    HeadlessSurface surface(WIDTH, HEIGHT, 3);
+    HeadlessSurface reference(WIDTH, HEIGHT, 1);
+    WaveformRenderer scrolling;
+    WaveformRenderer redraw;
+    SampleFeed feed(5);
+    size_t skipped = 0;
+    size_t mismatchedFrames = 0;
+    for (int frame = 0; frame < 200; frame++) {
+        feed.Advance(&history, FRAME_US);
+        if (frame % 10 == 3) surface.StallAcquires(1 + frame % 3);
+        uint64_t presentedBefore = surface.PresentedCount();
+        WaveformRenderer::FrameResult result =
+            scrolling.RenderFrame(&surface, history, WindowUs(depth), feed.nowUs);
+        if (result == WaveformRenderer::FRAME_SKIPPED) {
+            skipped++;
+            EXPECT_TRUE(surface.PresentedCount() == presentedBefore);
+            continue;
+        }
+        EXPECT_TRUE(result == WaveformRenderer::FRAME_PRESENTED || result == WaveformRenderer::FRAME_UNCHANGED);
+        redraw.InvalidateContent();
+        redraw.RenderFrame(&reference, history, WindowUs(depth), feed.nowUs);
+        if (CountDifferentPixels(surface, reference) != 0) mismatchedFrames++;
+    }
+    EXPECT_TRUE(skipped == surface.NotReadyCount());
+    EXPECT_TRUE(skipped > 0);
+    EXPECT_TRUE(surface.DiscardedCount() == 0);
+    EXPECT_TRUE(mismatchedFrames == 0);
+}
+
+// 帧结果计数与阶段计时：每个已提交帧都经过各阶段，跳帧只计入出队阶段，画面不变的帧不计数
+static void TestRenderMetrics() {
+    const size_t depth = 40;
+    SampleHistory history(depth);
+    HeadlessSurface surface(WIDTH, HEIGHT, 3);
+    WaveformRenderer renderer;
+    uint64_t rng = 3;
+    int64_t nowUs = 0;
+    for (int frame = 0; frame < 50; frame++) {
+        nowUs += SAMPLE_US;
+        history.Push(nowUs, NextSample(&rng));
+        if (frame == 20) surface.StallAcquires(2);
+        renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs);
+    }
+    const RenderMetrics &metrics = renderer.Metrics();
+    EXPECT_TRUE(metrics.framesPresented == 48);
+    EXPECT_TRUE(metrics.framesSkipped == 2);
+    EXPECT_TRUE(metrics.framesFailed == 0);
+    EXPECT_TRUE(metrics.incrementalFrames > 0 && metrics.incrementalFrames < metrics.framesPresented);
+    EXPECT_TRUE(metrics.stages[RENDER_STAGE_PREPARE].count == 50);
+    EXPECT_TRUE(metrics.stages[RENDER_STAGE_ACQUIRE].count == 50);
+    EXPECT_TRUE(metrics.stages[RENDER_STAGE_PRESENT].count == 48);
+    EXPECT_TRUE(metrics.stages[RENDER_STAGE_DRAW].count == 48);
+    EXPECT_TRUE(metrics.frame.count == 48 && metrics.frameTimes.Total() == 48);
+    EXPECT_TRUE(metrics.frame.maxUs >= metrics.frame.lastUs && metrics.frame.totalUs >= metrics.frame.maxUs);
+
+    // 画面不变与空 Surface 都不算帧
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs) == WaveformRenderer::FRAME_UNCHANGED);
+    surface.Resize(0, 0);
+    renderer.RenderFrame(&surface, history, WindowUs(depth), nowUs);
+    EXPECT_TRUE(renderer.Metrics().framesPresented == 48 && renderer.Metrics().framesFailed == 0);
+    renderer.ResetMetrics();
+    EXPECT_TRUE(renderer.Metrics().framesPresented == 0 && renderer.Metrics().frameTimes.Total() == 0);
+}
+
+// 横坐标只由样本时间决定：与到达间隔无关，没有新样本时曲线也随时间左移，全部滑出后停止滚动
+static void TestTimeAxisPlacesSamples() {
+    const size_t depth = 15; // 窗口 1.4 秒，每列 7 毫秒
+    SampleHistory history(depth);
+    HeadlessSurface surface(WIDTH, HEIGHT, 2);
+    WaveformRenderer renderer;
+    WaveformStyle style;
+    history.Push(0, 500.0);
+    history.Push(700000, 500.0); // 间隔 700 毫秒 = 100 列
+
+    // 最后一个样本在当前时刻之前 100 列：x = 199 - 100
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), 1400000) ==
+                WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(surface.PresentedPixel(50, HEIGHT / 2) == style.lineColor);
+    EXPECT_TRUE(surface.PresentedPixel(95, HEIGHT / 2) == style.lineColor);
+    EXPECT_TRUE(surface.PresentedPixel(110, HEIGHT / 2) == style.backgroundColor);
+    EXPECT_TRUE(renderer.Animating());
+
+    // 350 毫秒后曲线末端左移 50 列
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), 1750000) ==
+                WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(surface.LastDamagePartial());
+    EXPECT_TRUE(surface.PresentedPixel(45, HEIGHT / 2) == style.lineColor);
+    EXPECT_TRUE(surface.PresentedPixel(60, HEIGHT / 2) == style.backgroundColor);
+
+    // 全部滑出窗口
+    EXPECT_TRUE(renderer.RenderFrame(&surface, history, WindowUs(depth), 2200000) ==
+                WaveformRenderer::FRAME_PRESENTED);
+    EXPECT_TRUE(!renderer.Animating());
+    EXPECT_TRUE(surface.PresentedPixel(EDGE_COLUMNS, HEIGHT / 2) == style.backgroundColor);
+}
+
+// 直方图桶的上界不含在桶内
+static void TestFrameTimeHistogram() {
+    FrameTimeHistogram histogram;
+    EXPECT_TRUE(histogram.PercentileUpperUs(0.5) == 0);
+    histogram.Record(0);
+    histogram.Record(999);
+    histogram.Record(1000);
+    histogram.Record(16666);
+    histogram.Record(16667);
+    histogram.Record(1000000);
+    EXPECT_TRUE(histogram.counts[0] == 2);
+    EXPECT_TRUE(histogram.counts[1] == 1);
+    EXPECT_TRUE(histogram.counts[4] == 1);
+    EXPECT_TRUE(histogram.counts[5] == 1);
+    EXPECT_TRUE(histogram.counts[FrameTimeHistogram::BUCKET_COUNT - 1] == 1);
+    EXPECT_TRUE(histogram.Total() == 6);
+    EXPECT_TRUE(histogram.PercentileUpperUs(0.5) == 2000);
+    EXPECT_TRUE(histogram.PercentileUpperUs(1.0) == -1);
+}
+
+int main() {
+    RUN_TEST(TestScrollMatchesFullRedraw);
+    RUN_TEST(TestScrollMatchesFullRedrawPaddedStride);
+    RUN_TEST(TestDecimatedScrollMatchesFullRedraw);
+    RUN_TEST(TestDamageCoversChangedPixels);
+    RUN_TEST(TestPixelsFollowStyle);
+    RUN_TEST(TestEmptyHistoryAndResize);
+    RUN_TEST(TestReleaseAndReuse);
+    RUN_TEST(TestSkippedFramesKeepScrollConsistent);
+    RUN_TEST(TestRenderMetrics);
+    RUN_TEST(TestTimeAxisPlacesSamples);
+    RUN_TEST(TestFrameTimeHistogram);
+    return TestFailureCount() == 0 ? 0 : 1;
+}
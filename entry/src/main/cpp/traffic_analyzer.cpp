@@ -1,279 +1,114 @@
-#include "napi/native_api.h"
-#include "render_manager.h"
-#include <hilog/log.h>
-#include <vector>
-#include <deque>
-#include <numeric>
-#include <chrono>
-#include <cmath>
-#include <algorithm>
+// 流量分析核心：纯 C++ 实现，不依赖 NAPI / hilog / 渲染，可在宿主机上编译测试
+#include "traffic_analyzer.h"
+#include "traffic_trace.h"
 
-// 定义日志标签
-#undef LOG_TAG
-#define LOG_TAG "NativeTraffic"
-#define LOG_DOMAIN 0x0001
-#define OH_LOG_INFO(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_INFO, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
-#define OH_LOG_ERROR(fmt, ...) ((void)OH_LOG_Print(LOG_APP, LOG_ERROR, LOG_DOMAIN, LOG_TAG, fmt, ##__VA_ARGS__))
-
-static const size_t WINDOW_SIZE = 100; // 窗口大小
-static std::deque<double> g_speedWindow; // 存储最近N次瞬时速度（kbps）
-static double g_totalBytes = 0; // 总流量
-static std::chrono::time_point<std::chrono::steady_clock> g_lastPacketTime; // 上一次收到包的时间
-static bool g_isFirstPacket = true; // 标记是否是第一个包
-static double g_accumulatedBytes = 0; // 临时累积的字节数
-static const long long MIN_CALC_INTERVAL_US = 100000; // 最小计算间隔 (微秒): 100ms = 100,000us
-
-static double g_globalMax = 0;
-static double g_globalAvgKbps = 0;
-static double g_globalMin = -1.0; // -1 表示尚未初始化
-static std::chrono::time_point<std::chrono::steady_clock> g_sessionStartTime; // 整个会话开始时间
-static int g_sampleCount = 0; // 采样计数，用于忽略启动阶段
-
-// 重置状态 (供 JS 调用)
-static napi_value ResetState(napi_env env, napi_callback_info info) {
-    g_speedWindow.clear();
-    g_totalBytes = 0;
-    g_accumulatedBytes = 0;
-    g_isFirstPacket = true;
-    g_globalMax = 0;
-    g_globalMin = -1.0;
-    g_sampleCount = 0;
-    auto now = std::chrono::steady_clock::now();
-    g_lastPacketTime = now;
-    g_sessionStartTime = now;
-    
-
-    RenderManager::GetInstance()->ClearData();
-
-    
-    OH_LOG_INFO("Traffic Analyzer State Reset");
-    return nullptr;
+TrafficAnalyzer::TrafficAnalyzer(size_t windowSize) : speedWindow_(windowSize) {
+    Reset();
 }
 
-// 计算标准差 (Jitter)
-double CalculateJitter(const std::deque<double>& window, double mean){
-    if(window.size() < 2) return 0.0;
-    
-    double sum_sq_diff = 0.0;
-    for(double val : window) {
-        double diff = val - mean;
-        sum_sq_diff += diff * diff;
-    }
-    return std::sqrt(sum_sq_diff / window.size());
+void TrafficAnalyzer::Reset() {
+    speedWindow_.Clear();
+    convergence_.Reset();
+    tcp_ = TcpMetrics();
+    lastJitter_ = 0;
+    totalBytes_ = 0;
+    accumulatedBytes_ = 0;
+    isFirstPacket_ = true;
+    globalMax_ = 0;
+    globalAvgKbps_ = 0;
+    globalMin_ = -1.0;
+    sampleCount_ = 0;
+    lastPacketTimeUs_ = 0; // 首包到达时再以实际时间初始化
+    sessionStartTimeUs_ = 0;
 }
 
-// 辅助函数：将统计数据打包为 JS 对象
-static napi_value CreateResultObject(napi_env env, double instant, double max, double min, double avg, double jitter, double total) {
-    napi_value resultObject;
-    napi_create_object(env, &resultObject);
-
-    napi_value valInstant, valMax, valMin, valAvg, valJitter, valTotal;
+void TrafficAnalyzer::SetSampleListener(SampleListener listener) {
+    sampleListener_ = std::move(listener);
+}
 
-    // 创建 JS Number 对象
-    napi_create_double(env, instant, &valInstant);
-    napi_create_double(env, max, &valMax);
-    napi_create_double(env, min, &valMin);
-    napi_create_double(env, avg, &valAvg);
-    napi_create_double(env, jitter, &valJitter);
-    napi_create_double(env, total, &valTotal);
+TrafficStats TrafficAnalyzer::MakeStats(double instantKbps, double jitter) const {
+    TrafficStats stats;
+    stats.valid = true;
+    stats.instantKbps = instantKbps;
+    stats.maxKbps = globalMax_;
+    stats.minKbps = (globalMin_ < 0 ? 0 : globalMin_);
+    stats.avgKbps = globalAvgKbps_;
+    stats.jitter = jitter;
+    stats.totalBytes = totalBytes_;
+    stats.stable = convergence_.Stable();
+    stats.confidenceKbps = convergence_.ConfidenceKbps();
+    stats.tcp = tcp_;
+    return stats;
+}
 
-    // 设置属性
-    napi_set_named_property(env, resultObject, "instantKbps", valInstant);
-    napi_set_named_property(env, resultObject, "maxKbps", valMax);
-    napi_set_named_property(env, resultObject, "minKbps", valMin);
-    napi_set_named_property(env, resultObject, "avgKbps", valAvg);
-    napi_set_named_property(env, resultObject, "jitter", valJitter);
-    napi_set_named_property(env, resultObject, "totalBytes", valTotal);
+TrafficStats TrafficAnalyzer::Process(size_t byteLength) {
+    return ProcessAt(byteLength, clock_->NowUs());
+}
 
-    return resultObject;
+TrafficStats TrafficAnalyzer::Current() const {
+    return isFirstPacket_ ? TrafficStats() : MakeStats(speedWindow_.Back(), lastJitter_);
 }
 
-static napi_value ProcessTrafficCore(napi_env env, size_t byteLength) {
-    auto now = std::chrono::steady_clock::now();
+TrafficStats TrafficAnalyzer::ProcessAt(size_t byteLength, int64_t now) {
+    if (traceWriter_ != nullptr) {
+        traceWriter_->Append(now, byteLength);
+    }
 
     // 累加流量
-    g_totalBytes += static_cast<double>(byteLength);
-    g_accumulatedBytes += static_cast<double>(byteLength);
-
-    if (g_isFirstPacket) {
-        g_isFirstPacket = false;
-        g_lastPacketTime = now;
-        g_sessionStartTime = now;
-        
-        // 初始返回空对象
-        napi_value result;
-        napi_create_object(env, &result);
-        return result;
+    totalBytes_ += static_cast<double>(byteLength);
+    accumulatedBytes_ += static_cast<double>(byteLength);
+
+    if (isFirstPacket_) {
+        isFirstPacket_ = false;
+        lastPacketTimeUs_ = now;
+        sessionStartTimeUs_ = now;
+        return TrafficStats(); // 初始返回空统计
     }
 
-    auto duration_us = std::chrono::duration_cast<std::chrono::microseconds>(now - g_lastPacketTime).count();
+    int64_t duration_us = now - lastPacketTimeUs_;
 
     // 时间聚合门禁 (<100ms 不计算，但要返回最新的 totalBytes)
-    if(duration_us < MIN_CALC_INTERVAL_US){
-        double lastInstant = g_speedWindow.empty() ? 0.0 : g_speedWindow.back();
-
-        // Jitter 保持不变 (因为没有产生新的瞬时样本)
-        double windowSum = std::accumulate(g_speedWindow.begin(), g_speedWindow.end(), 0.0);
-        double windowAvg = g_speedWindow.empty() ? 0.0 : (windowSum / g_speedWindow.size());
-        double lastJitter = CalculateJitter(g_speedWindow, windowAvg);
-        
-        return CreateResultObject(
-            env, 
-            lastInstant,                // Instant: 保持上一次
-            g_globalMax,                // Max: 保持不变
-            (g_globalMin < 0 ? 0 : g_globalMin), // Min: 保持不变
-            g_globalAvgKbps,           // Avg: 实时更新
-            lastJitter,                 // Jitter: 保持不变
-            g_totalBytes                // Total: 实时更新
-        );
-    
+    // Instant / Max / Min / Avg / Jitter 都保持上一次的值
+    if (duration_us < MIN_CALC_INTERVAL_US) {
+        return MakeStats(speedWindow_.Back(), lastJitter_);
     }
-    
+
     double duration_sec = static_cast<double>(duration_us) / 1000000.0;
-    
+
     // 瞬时速度
-    double currentBits = g_accumulatedBytes * 8.0;
+    double currentBits = accumulatedBytes_ * 8.0;
     double instantKbps = (currentBits / duration_sec) / 1024.0;
 
-    RenderManager::GetInstance()->PushData(instantKbps);
+    if (sampleListener_) {
+        sampleListener_(instantKbps, now);
+    }
 
     // 更新 Max
-    if (instantKbps > g_globalMax) {
-        g_globalMax = instantKbps;
+    if (instantKbps > globalMax_) {
+        globalMax_ = instantKbps;
     }
 
     // 更新 Min (忽略启动前 5 点)
-    g_sampleCount++;
-    if (g_sampleCount > 5) {
-        if (g_globalMin < 0 || instantKbps < g_globalMin) {
-            g_globalMin = instantKbps;
+    sampleCount_++;
+    if (sampleCount_ > 5) {
+        if (globalMin_ < 0 || instantKbps < globalMin_) {
+            globalMin_ = instantKbps;
         }
     }
 
     // 全局平均
-    auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(now - g_sessionStartTime).count();
+    int64_t total_us = now - sessionStartTimeUs_;
     double total_sec = static_cast<double>(total_us) / 1000000.0;
-    double globalAvgKbps = (total_sec > 0) ? (g_totalBytes * 8.0 / 1024.0) / total_sec : 0;
-    g_globalAvgKbps = globalAvgKbps;
+    globalAvgKbps_ = (total_sec > 0) ? (totalBytes_ * 8.0 / 1024.0) / total_sec : 0;
 
-    // Jitter
-    if (g_speedWindow.size() >= WINDOW_SIZE) g_speedWindow.pop_front();
-    g_speedWindow.push_back(instantKbps);
-    
-    double winSum = std::accumulate(g_speedWindow.begin(), g_speedWindow.end(), 0.0);
-    double jitter = CalculateJitter(g_speedWindow, winSum / g_speedWindow.size());
+    // Jitter (窗口内瞬时速度的标准差，增量维护)
+    speedWindow_.Push(instantKbps);
+    lastJitter_ = speedWindow_.StdDev();
+    convergence_.Update(instantKbps, total_us);
 
     // 重置累积
-    g_accumulatedBytes = 0;
-    g_lastPacketTime = now;
+    accumulatedBytes_ = 0;
+    lastPacketTimeUs_ = now;
 
-    // 组装返回值
-    return CreateResultObject(
-        env,
-        instantKbps,
-        g_globalMax,
-        (g_globalMin < 0 ? 0 : g_globalMin),
-        globalAvgKbps,
-        jitter,
-        g_totalBytes
-    );
+    return MakeStats(instantKbps, lastJitter_);
 }
-
-/**
- * 接口1：处理 ArrayBuffer (下载用)
- * analyzeTraffic(buffer: ArrayBuffer)
- */
-static napi_value AnalyzeTraffic(napi_env env, napi_callback_info info) {
-    size_t argc = 1;
-    napi_value args[1] = {nullptr};
-    
-    // 获取JS传入的参数, info 是回调上下文，args将存储JS对象的句柄（Handle）
-    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
-    
-    // 参数校验，检测第一个参数是否为ArrayBuffer
-    bool isArrayBuffer = false;
-    napi_is_arraybuffer(env, args[0], &isArrayBuffer);
-    if(!isArrayBuffer) {
-        napi_throw_type_error(env, nullptr, "Argument 0 must be an ArrayBuffer");
-        return nullptr;
-    }
-
-    void* data = nullptr; // 指向 JS 堆外内存的物理指针
-    size_t byteLength = 0; // 数据的长度
-    napi_status status = napi_get_arraybuffer_info(env, args[0], &data, &byteLength);
-
-    if (status != napi_ok) return nullptr;
-    
-    return ProcessTrafficCore(env, byteLength);
-}
-
-/**
- * 接口2：处理数值长度 (上传用)
- * analyzeLength(byteLength: number)
- */
-static napi_value AnalyzeLength(napi_env env, napi_callback_info info) {
-    size_t argc = 1;
-    napi_value args[1] = {nullptr};
-    napi_get_cb_info(env, info, &argc, args, nullptr, nullptr);
-    
-    double len = 0;
-    // 获取 Number 值
-    napi_status status = napi_get_value_double(env, args[0], &len);
-    if (status != napi_ok) return nullptr;
-
-    return ProcessTrafficCore(env, static_cast<size_t>(len));
-}
-
-// 模块初始化注册
-EXTERN_C_START
-static napi_value Init(napi_env env, napi_value exports){
-    napi_property_descriptor desc[] = {
-        { "analyzeTraffic", nullptr, AnalyzeTraffic, nullptr, nullptr, nullptr, napi_default, nullptr},
-        { "analyzeLength", nullptr, AnalyzeLength, nullptr, nullptr, nullptr, napi_default, nullptr },
-        { "resetState", nullptr, ResetState, nullptr, nullptr, nullptr, napi_default, nullptr },
-//        { "registerXComponent", nullptr, RegisterXComponent, nullptr, nullptr, nullptr, napi_default, nullptr }
-    };
-    napi_define_properties(env, exports, sizeof(desc) / sizeof(desc[0]), desc);
-    
-    // 当 ArkTS 设置了 libraryname 时，系统会把 NativeXComponent 挂载在 exports 上
-    napi_value exportInstance = nullptr;
-    napi_status status = napi_get_named_property(env, exports, OH_NATIVE_XCOMPONENT_OBJ, &exportInstance);
-    
-    if(status == napi_ok) {
-        OH_NativeXComponent* nativeXComponent = nullptr;
-        // 解包出指针
-        status = napi_unwrap(env, exportInstance, reinterpret_cast<void**>(&nativeXComponent));
-        
-        if(status == napi_ok && nativeXComponent != nullptr) {
-            OH_LOG_INFO("Successfully retrieved OH_NativeXComponent pointer!");
-            
-            // 立即注册回调
-            RenderManager::GetInstance()->SetId("NetGuardian_Waveform");
-            RenderManager::GetInstance()->RegisterCallback(nativeXComponent);
-        } else {
-            OH_LOG_ERROR("Failed to unwrap OH_NativeXComponent");
-        }
-    }
-    return exports;
-}
-EXTERN_C_END
-
-// 模块定义
-static napi_module demoModule = {
-    .nm_version = 1,
-    .nm_flags = 0,
-    .nm_filename = nullptr,
-    .nm_register_func = Init,
-    .nm_modname = "net_guardian",
-    .nm_priv = ((void*)0),
-    .reserved = {0},
-};
-
-// 注册入口
-extern "C" __attribute__((constructor)) void RegisterNetGuardianModule(void) {
-    napi_module_register(&demoModule);
-}
-
-
-
-
@@ -0,0 +1,191 @@
+#include "traffic_trace.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+size_t EncodeVarint(uint64_t value, uint8_t *out) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+size_t DecodeVarint(const uint8_t *data, size_t size, uint64_t *value) {
+    uint64_t result = 0;
+    for (size_t i = 0; i < size && i < MAX_VARINT_BYTES; i++) {
+        result |= static_cast<uint64_t>(data[i] & 0x7F) << (7 * i);
+        if ((data[i] & 0x80) == 0) {
+            *value = result;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static void WriteLE16(uint8_t *out, uint16_t value) {
+    out[0] = static_cast<uint8_t>(value);
+    out[1] = static_cast<uint8_t>(value >> 8);
+}
+
+static void WriteLE32(uint8_t *out, uint32_t value) {
+    for (int i = 0; i < 4; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static void WriteLE64(uint8_t *out, uint64_t value) {
+    for (int i = 0; i < 8; i++) out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+static uint64_t ReadLE(const uint8_t *data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) value |= static_cast<uint64_t>(data[i]) << (8 * i);
+    return value;
+}
+
+// ---------------------------------------------------------------------------
+// TraceWriter
+// ---------------------------------------------------------------------------
+
+TraceWriter::~TraceWriter() {
+    Close();
+}
+
+bool TraceWriter::Open(const std::string &path) {
+    Close();
+    fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd_ < 0) return false;
+
+    writeOffset_ = TRACE_HEADER_SIZE;
+    lastTimestampUs_ = 0;
+    recordCount_ = 0;
+    if (!EnsureCapacity(0)) {
+        Close();
+        return false;
+    }
+
+    WriteLE32(base_, TRACE_MAGIC);
+    WriteLE16(base_ + 4, TRACE_VERSION);
+    WriteLE16(base_ + 6, 0);
+    CommitLength();
+    return true;
+}
+
+bool TraceWriter::EnsureCapacity(size_t extra) {
+    if (base_ != nullptr && writeOffset_ + extra <= mappedSize_) return true;
+
+    size_t newSize = mappedSize_ + GROW_STEP;
+    if (ftruncate(fd_, static_cast<off_t>(newSize)) != 0) return false;
+
+    // 扩容后重新映射整个文件 (已写内容由内核保留在页缓存/文件中)
+    if (base_ != nullptr) {
+        munmap(base_, mappedSize_);
+        base_ = nullptr;
+    }
+    void *addr = mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (addr == MAP_FAILED) {
+        mappedSize_ = 0;
+        return false;
+    }
+    base_ = static_cast<uint8_t *>(addr);
+    mappedSize_ = newSize;
+    return true;
+}
+
+void TraceWriter::CommitLength() {
+    WriteLE64(base_ + 8, static_cast<uint64_t>(writeOffset_ - TRACE_HEADER_SIZE));
+}
+
+bool TraceWriter::Append(int64_t timestampUs, uint64_t byteLength) {
+    if (base_ == nullptr) return false;
+    if (!EnsureCapacity(2 * MAX_VARINT_BYTES)) {
+        Close();
+        return false;
+    }
+
+    uint8_t *out = base_ + writeOffset_;
+    size_t n = EncodeVarint(ZigZagEncode(timestampUs - lastTimestampUs_), out);
+    n += EncodeVarint(byteLength, out + n);
+    writeOffset_ += n;
+    lastTimestampUs_ = timestampUs;
+    recordCount_++;
+    CommitLength();
+    return true;
+}
+
+void TraceWriter::Close() {
+    if (base_ != nullptr) {
+        munmap(base_, mappedSize_);
+        base_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        // 去掉预扩容的尾部空间
+        if (ftruncate(fd_, static_cast<off_t>(writeOffset_)) != 0) {
+            // 截断失败不影响数据有效性：读取端以头部记录的长度为准
+        }
+        close(fd_);
+        fd_ = -1;
+    }
+    mappedSize_ = 0;
+}
+
+// ---------------------------------------------------------------------------
+// TraceReader
+// ---------------------------------------------------------------------------
+
+bool TraceReader::Load(const uint8_t *data, size_t size) {
+    cursor_ = nullptr;
+    end_ = nullptr;
+    lastTimestampUs_ = 0;
+    error_ = false;
+
+    if (data == nullptr || size < TRACE_HEADER_SIZE || ReadLE(data, 4) != TRACE_MAGIC ||
+        ReadLE(data + 4, 2) != TRACE_VERSION) {
+        error_ = true;
+        return false;
+    }
+
+    uint64_t committed = ReadLE(data + 8, 8);
+    size_t available = size - TRACE_HEADER_SIZE;
+    cursor_ = data + TRACE_HEADER_SIZE;
+    end_ = cursor_ + (committed < available ? committed : available);
+    return true;
+}
+
+bool TraceReader::LoadFile(const std::string &path) {
+    fileData_.clear();
+    FILE *file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        error_ = true;
+        return false;
+    }
+    uint8_t chunk[64 * 1024];
+    size_t n = 0;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        fileData_.insert(fileData_.end(), chunk, chunk + n);
+    }
+    fclose(file);
+    return Load(fileData_.data(), fileData_.size());
+}
+
+bool TraceReader::Next(TraceRecord *record) {
+    if (error_ || cursor_ == nullptr || cursor_ >= end_) return false;
+
+    uint64_t delta = 0;
+    uint64_t length = 0;
+    size_t n = DecodeVarint(cursor_, end_ - cursor_, &delta);
+    size_t m = (n == 0) ? 0 : DecodeVarint(cursor_ + n, end_ - cursor_ - n, &length);
+    if (n == 0 || m == 0) {
+        error_ = true;
+        return false;
+    }
+    cursor_ += n + m;
+
+    lastTimestampUs_ += ZigZagDecode(delta);
+    record->timestampUs = lastTimestampUs_;
+    record->byteLength = length;
+    return true;
+}
@@ -1,3 +1,23 @@
+/**
+ * 原生引擎定期从 TCP_INFO 采样的传输层指标 (多连接时 RTT 取均值、计数求和)
+ * 发送方向的指标只对本端发出的数据有意义：下载时以 rcvRttMs 为准，重传发生在服务端看不到
+ */
+export interface TcpMetrics {
+  connections: number;
+  rttMs: number;           // 平滑 RTT
+  rttVarMs: number;        // RTT 平均偏差
+  minRttMs: number;        // 最小 RTT，0 表示内核不提供
+  rcvRttMs: number;        // 接收方向估计的 RTT，0 表示尚无估计
+  retransmits: number;     // 累计重传段数
+  segmentsOut: number;     // 累计发出段数
+  retransmitRatio: number; // retransmits / segmentsOut
+  cwnd: number;            // 拥塞窗口 (段)
+  mss: number;
+  pacingKbps: number;      // 内核 pacing 速率，0 表示未知
+  // 'congested': RTT 明显高于最小 RTT (排队)；'lossy': 重传率高而 RTT 不涨 (随机丢包)
+  condition: 'unknown' | 'good' | 'congested' | 'lossy';
+}
+
 export interface TrafficStats {
   instantKbps: number; // 瞬时速度 (画波形图用)
   maxKbps: number;     // 全局峰值
@@ -5,9 +25,247 @@ export interface TrafficStats {
   avgKbps: number;     // 全局均值 (总流量/总时间)
   jitter: number;      // 抖动
   totalBytes: number;  // 总流量
+  stable?: boolean;    // 速度是否已收敛 (仅原生引擎的上报与结果带此字段)
+  confidenceKbps?: number; // 最近窗口均值的 95% 置信区间半宽
+  tcp?: TcpMetrics;    // 流量所在连接的 TCP 指标 (仅原生引擎，连接建立后)
+}
+
+/**
+ * 原生波形图样式，颜色为 0xAARRGGBB 整数 (0 ~ 0xFFFFFFFF)，未提供的字段保持当前值；取值越界时抛出 RangeError
+ */
+export interface WaveformStyle {
+  backgroundColor?: number;
+  lineColor?: number;
+  fillTopColor?: number;    // 填充渐变顶部
+  fillBottomColor?: number; // 填充渐变底部
+  strokeWidth?: number;     // 描边宽度 (px)，(0, 256]
+}
+
+/**
+ * 渲染管线一个阶段 (或整帧) 的耗时统计，单位微秒
+ */
+export interface StageTiming {
+  count: number;
+  totalUs: number;
+  avgUs: number;
+  maxUs: number;
+  lastUs: number;
+}
+
+/**
+ * 原生波形渲染管线的计数与计时
+ */
+export interface RenderMetrics {
+  framesPresented: number;
+  framesSkipped: number;     // 没有可写缓冲区 (队列满或 acquire fence 未触发) 而跳过的帧
+  framesFailed: number;      // 资源 / 出队 / 绘制失败而丢弃的帧
+  incrementalFrames: number; // 只平移并重画右侧条带的帧
+  frameRequests: number;     // 帧请求次数 (每个样本一次)
+  coalescedRequests: number; // 被合并进已挂起帧的请求 (两帧之间到达的多余样本)
+  stages: {
+    prepare: StageTiming;    // 快照、抽取与布局
+    acquire: StageTiming;    // 出队缓冲区 (含等待空闲缓冲区与 fence，即缓冲区等待时间)
+    draw: StageTiming;       // native_drawing 绘制
+    copy: StageTiming;       // 像素搬移 (增量滚动平移或离屏拷贝)
+    present: StageTiming;    // 脏区域计算与提交
+  };
+  frame: StageTiming;        // 已提交帧的总耗时
+  frameTimes: {
+    boundsUs: number[];      // 各桶上界 (不含)
+    counts: number[];        // 比 boundsUs 多一个无上限的末档
+  };
+}
+
+/**
+ * 单条流的原生流量分析器，每个实例拥有独立的统计状态
+ * 例如下载 / 上传阶段各用一个实例，互不影响
+ */
+export class TrafficAnalyzer {
+  /**
+   * @param waveform 瞬时速度推送到的原生波形通道：true 为默认通道 ('NetGuardian_Waveform')，
+   *                 字符串为对应 XComponent 的 id；默认不推送
+   */
+  constructor(waveform?: boolean | string);
+  analyzeTraffic(buffer: ArrayBuffer): TrafficStats;
+  analyzeLength(byteLength: number): TrafficStats; // NaN 与非正数按 0 字节处理
+  /**
+   * 一次调用处理多段流量，只返回最后一段处理后的统计
+   * @param byteLengths 每段的字节数
+   * @param timestampsMs 每段的到达时间 (毫秒，0 ~ 2^53)，省略时整批视为当前时刻到达
+   * @param count 只处理前 count 个元素 (复用预分配数组时使用)
+   * @throws RangeError 时间戳或 count 不是有限的非负数时抛出，此时整批都不处理
+   */
+  analyzeTrafficBatch(byteLengths: Float64Array | Uint32Array, timestampsMs?: Float64Array,
+    count?: number): TrafficStats;
+  /**
+   * 注册共享统计缓冲区 (至少 6 个元素，下标 0 ~ 5 依次为 instantKbps / maxKbps / minKbps / avgKbps / jitter / totalBytes)
+   * 绑定后 *Into 接口把统计原地写入该缓冲区，调用过程不再分配 JS 对象；传 null 解除绑定
+   */
+  bindStatsBuffer(buffer: Float64Array | null): void;
+  /**
+   * 与 analyzeLength 相同，但统计写入共享缓冲区
+   * @returns 写入序号，每次写入递增；0 表示尚无统计 (首包)
+   */
+  analyzeLengthInto(byteLength: number): number;
+  /**
+   * 与 analyzeTrafficBatch 相同，但统计写入共享缓冲区
+   * @returns 写入序号，每次写入递增；0 表示尚无统计 (首包)
+   */
+  analyzeTrafficBatchInto(byteLengths: Float64Array | Uint32Array, timestampsMs?: Float64Array,
+    count?: number): number;
+  /**
+   * 逐包接口改用粗粒度单调时钟 (CLOCK_MONOTONIC_COARSE) 取到达时间，降低读时钟开销
+   * 精度为一个内核时钟节拍 (1~4ms)，与默认时钟同基，可随时切换
+   */
+  useCoarseClock(enable: boolean): void;
+  /**
+   * 开始把送入分析器的 (时间戳, 字节数) 序列记录到轨迹文件 (.ngtrace，覆盖已有文件)
+   * @returns 文件是否成功打开
+   */
+  startTrace(path: string): boolean;
+  /**
+   * 停止记录并关闭轨迹文件
+   * @returns 记录的条数
+   */
+  stopTrace(): number;
+  /**
+   * 把之后的样本改为推送到另一个波形通道 (XComponent id)，null / false 停止推送
+   */
+  bindWaveform(channel: boolean | string | null): void;
+  reset(): void;
+}
+
+/**
+ * 原生下载测速参数
+ */
+export interface DownloadOptions {
+  url: string;               // http:// 地址 (不支持 https)
+  streams?: number;          // 并行连接数 1 ~ 16，默认 1
+  durationMs?: number;       // 最长测量时长，默认 8000，<= 0 不限，上限一天
+  maxBytes?: number;         // 所有流合计收到这么多正文字节后结束，默认不限
+  connectTimeoutMs?: number; // 解析、连接到收到响应头的超时，默认 10000 (1 ~ 600000)
+  reportIntervalMs?: number; // 上报间隔，默认 100 (1 ~ 60000)
+  // 收敛提前结束：stopWhenStable 为 true 时，测量至少 minDurationMs (默认 2000) 且速度稳定
+  // (最近 2 秒的 95% 置信区间半宽不超过均值的 stableTolerance，默认 0.05；标准差不超过均值的 10%；均值不再漂移)
+  // 后以 'converged' 结束
+  stopWhenStable?: boolean;
+  minDurationMs?: number;
+  stableTolerance?: number;
+  tracePath?: string;        // 把送入分析器的聚合流量记录到该轨迹文件 (.ngtrace)
+}
+
+/**
+ * 单条连接的统计
+ */
+export interface StreamReport {
+  state: 'connecting' | 'receiving' | 'completed' | 'failed';
+  httpStatus: number;
+  bytes: number;
+  stats: TrafficStats; // 该流独立的统计，第一个速度样本之前为空对象
+  straggler: boolean;  // 均速低于各流中位数的一半
+}
+
+/**
+ * 下载期间的周期性聚合结果
+ */
+export interface DownloadReport {
+  stats: TrafficStats;   // 所有流合计的统计，第一个速度样本之前为空对象
+  bytes: number;         // 所有流合计已接收的正文字节
+  elapsedMs: number;     // 自开始连接起的时长
+  contentLength: number; // 各流响应头声明的正文长度之和，-1 表示未知
+  streams: StreamReport[];
+  fairness: number;      // 各流均速的 Jain 公平性指数 (1 / n ~ 1，越接近 1 越均衡)
+  stragglers: number;    // 掉队的流数
+}
+
+export interface DownloadResult extends DownloadReport {
+  // 'completed' 为至少一条流收完了正文，'failed' 为所有流都出错
+  reason: 'completed' | 'duration' | 'bytes' | 'converged' | 'stopped' | 'failed';
+  httpStatus: number; // 第一条收到响应头的流的状态码，0 表示都没有收到
+  error?: string;     // reason 为 'failed' 时的说明 (第一条出错的流)
+}
+
+/**
+ * 原生 HTTP 下载测速引擎：在原生线程上接收并就地丢弃数据，ArkTS 只收到聚合结果
+ * 同一实例同一时刻只运行一次测量，结束后可以再次 start
+ */
+export class DownloadEngine {
+  /**
+   * @param waveform 同 TrafficAnalyzer：true 驱动默认波形通道，string 为 XComponent id，省略时不推送
+   */
+  constructor(waveform?: boolean | string);
+  /**
+   * 开始测量 (会清空波形)，url 无效或正在运行时抛异常
+   * @param onReport 每 reportIntervalMs 在 JS 线程上调用一次
+   * @returns 测量结束 (含失败与 stop) 时兑现，不会 reject
+   */
+  start(options: DownloadOptions, onReport?: (report: DownloadReport) => void): Promise<DownloadResult>;
+  // 请求结束当前测量，Promise 随后以 reason 'stopped' 兑现
+  stop(): void;
+}
+
+/**
+ * 原生上传测速参数
+ */
+export interface UploadOptions {
+  url: string;               // http:// 地址 (不支持 https)
+  totalBytes?: number;       // 请求正文长度，默认 100 MiB (不占用对应大小的内存)
+  durationMs?: number;       // 最长测量时长，默认 8000，<= 0 不限，上限一天
+  connectTimeoutMs?: number; // 解析、连接的超时，默认 10000 (1 ~ 600000)
+  reportIntervalMs?: number; // 上报间隔，默认 100 (1 ~ 60000)
+  sendMode?: 'writev' | 'sendfile'; // 正文发送方式，默认 'writev'；sendfile 不可用时自动退回 writev
+  patternSize?: number;      // 反复发送的正文模板大小，默认 64 KiB
+  // 收敛提前结束：stopWhenStable 为 true 时，测量至少 minDurationMs (默认 2000) 且速度稳定
+  // (最近 2 秒的 95% 置信区间半宽不超过均值的 stableTolerance，默认 0.05；标准差不超过均值的 10%；均值不再漂移)
+  // 后以 'converged' 结束
+  stopWhenStable?: boolean;
+  minDurationMs?: number;
+  stableTolerance?: number;
+  tracePath?: string;        // 把送入分析器的流量记录到该轨迹文件 (.ngtrace)
+}
+
+/**
+ * 上传期间的周期性聚合结果，速度按对端已确认的字节计算
+ */
+export interface UploadReport {
+  stats: TrafficStats; // 第一个速度样本之前为空对象
+  sentBytes: number;   // 已写入 socket 的正文字节 (含发送队列中尚未确认的)
+  ackedBytes: number;  // 已被对端确认的正文字节
+  totalBytes: number;  // 正文总长度
+  elapsedMs: number;   // 自开始连接起的时长
+}
+
+export interface UploadResult extends UploadReport {
+  // 'completed' 为正文全部被确认且收到 2xx；'earlyResponse' 为正文发完之前服务端就回了 2xx，
+  // 此时 sentBytes / ackedBytes 小于 totalBytes
+  reason: 'completed' | 'earlyResponse' | 'duration' | 'converged' | 'stopped' | 'failed';
+  httpStatus: number;    // 0 表示没有收到响应头
+  sendfileUsed: boolean; // 实际是否用了 sendfile
+  error?: string;        // reason 为 'failed' 时的说明
+}
+
+/**
+ * 原生 HTTP 上传测速引擎：用法同 DownloadEngine，内存占用与 totalBytes 无关
+ */
+export class UploadEngine {
+  constructor(waveform?: boolean | string);
+  start(options: UploadOptions, onReport?: (report: UploadReport) => void): Promise<UploadResult>;
+  stop(): void;
 }
 
+// 以下模块级函数作用于一个共享的默认分析器 (兼容旧接口)
 export const analyzeTraffic: (buffer: ArrayBuffer) => TrafficStats;
 export const analyzeLength: (byteLength: number) => TrafficStats;
 export const resetState: () => void;
+// 以下波形接口的 channel 为 XComponent id，省略时作用于默认通道 ('NetGuardian_Waveform')
+// 修改原生波形图的配色与描边 (只在样式变化时重建绘图资源)
+export const setWaveformStyle: (style: WaveformStyle, channel?: string) => void;
+/**
+ * 修改原生波形图保留的样本数 (2 ~ 65536，默认 15)，会清空已有波形
+ * 横轴为时间：窗口长度为 (depth - 1) * 100 毫秒 (默认 1.4 秒)，样本按到达时间定位，不受到达间隔影响
+ * 一个像素列覆盖多个样本时按列显示 min/max 包络
+ */
+export const setHistoryDepth: (depth: number, channel?: string) => void;
+// 原生波形渲染管线的计数与计时 (同时以 hitrace 区间 NetGuardian::* 输出各阶段)
+export const getRenderMetrics: (channel?: string) => RenderMetrics;
 // export const registerXComponent: (context: object) => void;
\ No newline at end of file
@@ -0,0 +1,65 @@
+// 波形通道的数据入口：时钟映射与由生产者完成的历史替换
+#include "waveform_feed.h"
+#include <algorithm>
+
+WaveformFeed::WaveformFeed(size_t depth)
+    : history_(std::make_unique<SampleHistory>(depth)), depth_(depth), requestedDepth_(depth) {}
+
+bool WaveformFeed::ClaimProducer(const void *owner) {
+    const void *expected = nullptr;
+    return producer_.compare_exchange_strong(expected, owner, std::memory_order_acq_rel) || expected == owner;
+}
+
+void WaveformFeed::ReleaseProducer(const void *owner) {
+    const void *expected = owner;
+    producer_.compare_exchange_strong(expected, nullptr, std::memory_order_acq_rel);
+}
+
+void WaveformFeed::Push(double value, int64_t sampleTimeUs, int64_t nowUs) {
+    ApplyPendingDepth(false);
+    // 样本时间戳映射到渲染时钟：保留样本之间的真实间隔 (批量接口一次送来的多个样本也按各自的时间排开)，
+    // 两个时钟不同源时 (如批量接口的时间戳来自 JS)，首个样本、或映射结果落在未来 / 落后太多时重新锚定到当前时刻
+    int64_t timeUs = sampleTimeUs + clockOffsetUs_;
+    if (!clockAnchored_ || timeUs > nowUs || timeUs < nowUs - MAX_SAMPLE_LAG_US) {
+        clockOffsetUs_ = nowUs - sampleTimeUs;
+        clockAnchored_ = true;
+        timeUs = nowUs;
+    }
+    // 历史要求时间戳单调不减
+    timeUs = std::max(timeUs, lastSampleTimeUs_);
+    lastSampleTimeUs_ = timeUs;
+    history_->Push(timeUs, value);
+}
+
+void WaveformFeed::Clear() {
+    ApplyPendingDepth(false);
+    history_->Clear();
+}
+
+bool WaveformFeed::RequestHistoryDepth(size_t depth) {
+    if (depth < 2 || depth > MAX_HISTORY_DEPTH) {
+        return false;
+    }
+    requestedDepth_.store(depth, std::memory_order_release);
+    return true;
+}
+
+void WaveformFeed::ApplyHistoryDepth() {
+    ApplyPendingDepth(true);
+}
+
+void WaveformFeed::ApplyPendingDepth(bool wait) {
+    size_t requested = requestedDepth_.load(std::memory_order_acquire);
+    if (requested == depth_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(historyMutex_, std::defer_lock);
+    if (wait) {
+        lock.lock();
+    } else if (!lock.try_lock()) {
+        return; // 消费者正在读取旧历史，下一次 Push / Clear 再换
+    }
+    history_ = std::make_unique<SampleHistory>(requested);
+    depth_.store(requested, std::memory_order_release);
+    generation_++;
+}
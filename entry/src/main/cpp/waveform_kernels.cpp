@@ -0,0 +1,139 @@
+// 波形绘制的向量化内核：NEON / SSE2 / 标量三套实现，编译期选择
+#include "waveform_kernels.h"
+#include <algorithm>
+
+#if !defined(NET_GUARDIAN_DISABLE_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define WAVEFORM_KERNEL_NEON 1
+#elif !defined(NET_GUARDIAN_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64))
+#include <emmintrin.h>
+#define WAVEFORM_KERNEL_SSE2 1
+#endif
+
+void ScanMinMaxScalar(const double *data, size_t count, double *outMin, double *outMax) {
+    double low = data[0];
+    double high = data[0];
+    for (size_t i = 1; i < count; i++) {
+        low = std::min(low, data[i]);
+        high = std::max(high, data[i]);
+    }
+    *outMin = low;
+    *outMax = high;
+}
+
+void ValuesToPixelYScalar(const double *values, size_t count, double scale, int32_t height, float *outY) {
+    const double h = static_cast<double>(height);
+    const double k = h / scale;
+    for (size_t i = 0; i < count; i++) {
+        outY[i] = static_cast<float>(h - values[i] * k);
+    }
+}
+
+#if defined(WAVEFORM_KERNEL_NEON)
+
+const char *WaveformKernelBackend() { return "neon"; }
+
+void ScanMinMax(const double *data, size_t count, double *outMin, double *outMax) {
+    // 两组累加器交替使用，隐藏 min/max 指令的延迟
+    float64x2_t low0 = vdupq_n_f64(data[0]);
+    float64x2_t high0 = low0;
+    float64x2_t low1 = low0;
+    float64x2_t high1 = low0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float64x2_t a = vld1q_f64(data + i);
+        float64x2_t b = vld1q_f64(data + i + 2);
+        low0 = vminq_f64(low0, a);
+        high0 = vmaxq_f64(high0, a);
+        low1 = vminq_f64(low1, b);
+        high1 = vmaxq_f64(high1, b);
+    }
+    double low = vminvq_f64(vminq_f64(low0, low1));
+    double high = vmaxvq_f64(vmaxq_f64(high0, high1));
+    for (; i < count; i++) {
+        low = std::min(low, data[i]);
+        high = std::max(high, data[i]);
+    }
+    *outMin = low;
+    *outMax = high;
+}
+
+void ValuesToPixelY(const double *values, size_t count, double scale, int32_t height, float *outY) {
+    const double h = static_cast<double>(height);
+    const double k = h / scale;
+    const float64x2_t hv = vdupq_n_f64(h);
+    const float64x2_t kv = vdupq_n_f64(k);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float64x2_t a = vsubq_f64(hv, vmulq_f64(vld1q_f64(values + i), kv));
+        float64x2_t b = vsubq_f64(hv, vmulq_f64(vld1q_f64(values + i + 2), kv));
+        vst1q_f32(outY + i, vcombine_f32(vcvt_f32_f64(a), vcvt_f32_f64(b)));
+    }
+    for (; i < count; i++) {
+        outY[i] = static_cast<float>(h - values[i] * k);
+    }
+}
+
+#elif defined(WAVEFORM_KERNEL_SSE2)
+
+const char *WaveformKernelBackend() { return "sse2"; }
+
+void ScanMinMax(const double *data, size_t count, double *outMin, double *outMax) {
+    // 两组累加器交替使用，隐藏 min/max 指令的延迟
+    __m128d low0 = _mm_set1_pd(data[0]);
+    __m128d high0 = low0;
+    __m128d low1 = low0;
+    __m128d high1 = low0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_loadu_pd(data + i);
+        __m128d b = _mm_loadu_pd(data + i + 2);
+        low0 = _mm_min_pd(low0, a);
+        high0 = _mm_max_pd(high0, a);
+        low1 = _mm_min_pd(low1, b);
+        high1 = _mm_max_pd(high1, b);
+    }
+    double lows[2];
+    double highs[2];
+    _mm_storeu_pd(lows, _mm_min_pd(low0, low1));
+    _mm_storeu_pd(highs, _mm_max_pd(high0, high1));
+    double low = std::min(lows[0], lows[1]);
+    double high = std::max(highs[0], highs[1]);
+    for (; i < count; i++) {
+        low = std::min(low, data[i]);
+        high = std::max(high, data[i]);
+    }
+    *outMin = low;
+    *outMax = high;
+}
+
+void ValuesToPixelY(const double *values, size_t count, double scale, int32_t height, float *outY) {
+    const double h = static_cast<double>(height);
+    const double k = h / scale;
+    const __m128d hv = _mm_set1_pd(h);
+    const __m128d kv = _mm_set1_pd(k);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128d a = _mm_sub_pd(hv, _mm_mul_pd(_mm_loadu_pd(values + i), kv));
+        __m128d b = _mm_sub_pd(hv, _mm_mul_pd(_mm_loadu_pd(values + i + 2), kv));
+        // 每次转换得到 2 个 float (低半部分)，拼成 4 个一起写出
+        _mm_storeu_ps(outY + i, _mm_movelh_ps(_mm_cvtpd_ps(a), _mm_cvtpd_ps(b)));
+    }
+    for (; i < count; i++) {
+        outY[i] = static_cast<float>(h - values[i] * k);
+    }
+}
+
+#else
+
+const char *WaveformKernelBackend() { return "scalar"; }
+
+void ScanMinMax(const double *data, size_t count, double *outMin, double *outMax) {
+    ScanMinMaxScalar(data, count, outMin, outMax);
+}
+
+void ValuesToPixelY(const double *values, size_t count, double scale, int32_t height, float *outY) {
+    ValuesToPixelYScalar(values, count, scale, height, outY);
+}
+
+#endif
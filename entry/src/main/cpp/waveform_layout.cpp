@@ -0,0 +1,144 @@
+// 波形布局与增量绘制规划：纯 C++ 实现，供 WaveformRenderer 使用
+#include "waveform_layout.h"
+#include "waveform_kernels.h"
+#include <algorithm>
+#include <cmath>
+
+double NiceWaveformScale(double maxValue) {
+    double target = std::max(maxValue, 100.0) * 1.2; // 最小刻度 100，留 20% 顶部余量
+    double magnitude = std::pow(10.0, std::floor(std::log10(target)));
+    for (double factor : {1.0, 2.0, 5.0, 10.0}) {
+        if (factor * magnitude >= target) {
+            return factor * magnitude;
+        }
+    }
+    return 10.0 * magnitude;
+}
+
+// 向下取整的除法 (b > 0)
+static int64_t FloorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+int64_t WaveformColumn(int64_t timeUs, int32_t width, int64_t windowUs) {
+    if (windowUs <= 0 || width <= 0) {
+        return 0;
+    }
+    return FloorDiv(timeUs * width, windowUs);
+}
+
+// 第 column 列的起始时刻：满足 WaveformColumn(t) >= column 的最小 t
+static int64_t ColumnStartUs(int64_t column, int32_t width, int64_t windowUs) {
+    return -FloorDiv(-column * windowUs, width);
+}
+
+size_t AggregateColumns(const int64_t *times, const double *values, size_t count, int32_t width, int64_t windowUs,
+                        int64_t originColumn, int64_t *outColumns, double *outLows, double *outHighs) {
+    if (windowUs <= 0 || width <= 0) {
+        return 0;
+    }
+    size_t points = 0;
+    size_t i = 0;
+    while (i < count) {
+        // 每列只做一次除法：算出下一列的起始时刻，之后按时间比较找到这一列的全部样本
+        int64_t column = WaveformColumn(times[i], width, windowUs);
+        int64_t nextStart = ColumnStartUs(column + 1, width, windowUs);
+        size_t end = i + 1;
+        while (end < count && times[end] < nextStart) end++;
+
+        if (column < originColumn) {
+            points = 0; // 屏幕外只保留最后一列
+        }
+        outColumns[points] = column;
+        ScanMinMax(values + i, end - i, &outLows[points], &outHighs[points]);
+        points++;
+        i = end;
+    }
+    return points;
+}
+
+WaveformLayout ComputeWaveformLayout(const int64_t *columns, const double *lows, const double *highs, size_t count,
+                                     int32_t width, int32_t height, int64_t windowUs, int64_t nowColumn,
+                                     float margin, uint32_t generation) {
+    WaveformLayout layout;
+    layout.valid = true;
+    layout.count = count;
+    layout.width = width;
+    layout.height = height;
+    layout.windowUs = windowUs;
+    layout.originColumn = nowColumn - (width - 1);
+    layout.generation = generation;
+    layout.top = height; // 空范围
+    layout.bottom = 0;
+    if (count > 0) {
+        layout.firstColumn = columns[0];
+        layout.prevColumn = columns[count >= 2 ? count - 2 : 0];
+        layout.lastColumn = columns[count - 1];
+        layout.partialTail = layout.lastColumn >= nowColumn;
+    }
+    if (count < 2) {
+        layout.scale = NiceWaveformScale(0);
+        return layout;
+    }
+
+    double lowest = 0;
+    double highest = 0;
+    if (lows == highs) {
+        ScanMinMax(lows, count, &lowest, &highest); // 同一个数组：一次扫描同时得到最小 / 最大值
+    } else {
+        double unused = 0;
+        ScanMinMax(lows, count, &lowest, &unused);
+        ScanMinMax(highs, count, &unused, &highest);
+    }
+    layout.scale = NiceWaveformScale(highest);
+    // 数值越大越靠上：最大值决定顶部，最小值决定曲线最低处
+    float top = layout.PointY(highest) - margin;
+    float bottom = layout.PointY(lowest) + margin;
+    layout.top = std::max(0, static_cast<int32_t>(std::floor(top)));
+    layout.bottom = std::min(height, static_cast<int32_t>(std::ceil(bottom)));
+    return layout;
+}
+
+bool PlanWaveformScroll(const WaveformLayout &from, const WaveformLayout &to, float margin, WaveformScrollPlan *plan) {
+    if (!from.valid || !to.valid || from.generation != to.generation || from.width != to.width ||
+        from.height != to.height || from.windowUs != to.windowUs || from.scale != to.scale) {
+        return false;
+    }
+    if (from.count < 2 || to.count < 2 || to.endSeq < from.endSeq || to.clearSeq != from.clearSeq ||
+        to.originColumn < from.originColumn) {
+        return false;
+    }
+    // 屏幕内还能看到的旧点被挤出了历史 (历史容量不够覆盖窗口)，已有像素里有不该再显示的曲线
+    if (to.firstColumn > from.firstColumn && to.firstColumn >= to.originColumn) {
+        return false;
+    }
+    int64_t shift = to.originColumn - from.originColumn;
+    if (shift >= to.width) {
+        return false;
+    }
+
+    WaveformScrollPlan result;
+    result.shiftPx = static_cast<int32_t>(shift);
+    result.bandTop = std::min(from.top, to.top);
+    // 曲线下方的行只有填充：两帧的填充都从左边界外开始时，这些行水平方向处处相同，不需要平移；
+    // 否则填充的左边缘随时间移动，整块下方区域都要一起平移
+    bool fillSpansLeft = from.firstColumn <= from.originColumn && to.firstColumn <= to.originColumn;
+    result.bandBottom = fillSpansLeft ? std::max(from.bottom, to.bottom) : to.height;
+
+    // 旧帧最后一个点之后的线段是新的 (含它的圆角连接，向左多留描边余量)
+    // 旧帧最后一个点若在当时的末列，它的值可能变了，连向它的线段也要重画
+    int64_t stripColumn = from.partialTail ? from.prevColumn : from.lastColumn;
+    float stripX = to.ColumnX(stripColumn) - margin;
+    result.stripX = std::max(0, static_cast<int32_t>(std::floor(stripX)));
+    // 平移后最右侧 shiftPx 列还是旧像素 (曲线末端与当前时刻之间的空白)，一并重画
+    result.stripX = std::min(result.stripX, to.width - result.shiftPx);
+
+    // 有平移时带内整行都变了；填充的右边缘随时间左移或随新点右移，条带下方也会变化
+    result.damageX = result.shiftPx > 0 ? 0 : result.stripX;
+    result.damageY = result.bandTop;
+    result.damageW = to.width - result.damageX;
+    result.damageH = to.height - result.damageY;
+    *plan = result;
+    return true;
+}
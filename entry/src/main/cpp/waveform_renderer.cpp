@@ -0,0 +1,471 @@
+// 波形绘制：布局、路径构建、增量滚动与提交，只依赖 native_drawing 与 RenderSurface
+// 设备上链接系统的 native_drawing，宿主机上链接 host/soft_drawing.cpp
+#include "waveform_renderer.h"
+#include "waveform_kernels.h"
+#include <algorithm>
+#include <chrono>
+#include <hitrace/trace.h>
+#include <string.h>
+
+static int64_t NowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// 各阶段的 hitrace 标签，下标与 RenderStage 一致
+static const char* const STAGE_TRACE_NAMES[RENDER_STAGE_COUNT] = {
+    "NetGuardian::Prepare", "NetGuardian::Acquire", "NetGuardian::Draw", "NetGuardian::Copy", "NetGuardian::Present",
+};
+
+// 一个阶段的作用域：构造时开始计时并打开 hitrace 区间，析构时关闭区间并记入对应阶段
+class StageScope {
+public:
+    StageScope(RenderMetrics *metrics, RenderStage stage) : timing_(&metrics->stages[stage]), startUs_(NowUs()) {
+        OH_HiTrace_StartTrace(STAGE_TRACE_NAMES[stage]);
+    }
+    ~StageScope() {
+        OH_HiTrace_FinishTrace();
+        timing_->Record(NowUs() - startUs_);
+    }
+    StageScope(const StageScope&) = delete;
+    StageScope& operator=(const StageScope&) = delete;
+
+private:
+    StageTiming* timing_;
+    int64_t startUs_;
+};
+
+WaveformRenderer::~WaveformRenderer() {
+    ReleaseResources();
+}
+
+void WaveformRenderer::SetStyle(const WaveformStyle &style) {
+    style_ = style;
+    styleDirty_ = true;
+    contentGeneration_++;
+}
+
+bool WaveformRenderer::EnsureDrawingResources(uint64_t height) {
+    DrawingResources &res = resources_;
+    if (res.fillPath == nullptr) {
+        res.fillPath = OH_Drawing_PathCreate();
+        res.strokePath = OH_Drawing_PathCreate();
+        res.brush = OH_Drawing_BrushCreate();
+        res.backgroundBrush = OH_Drawing_BrushCreate();
+        res.pen = OH_Drawing_PenCreate();
+        styleDirty_ = true;
+    }
+
+    // 样式变化：重新配置画笔
+    if (styleDirty_) {
+        OH_Drawing_PenSetColor(res.pen, style_.lineColor);
+        OH_Drawing_PenSetWidth(res.pen, style_.strokeWidth);
+        OH_Drawing_PenSetJoin(res.pen, LINE_ROUND_JOIN);
+        OH_Drawing_PenSetCap(res.pen, LINE_ROUND_CAP);
+        OH_Drawing_PenSetAntiAlias(res.pen, true); // 抗锯齿开启
+        OH_Drawing_BrushSetColor(res.backgroundBrush, style_.backgroundColor);
+    }
+
+    // 渐变的终点依赖高度，颜色依赖样式，两者任一变化都要重建
+    if (res.shader == nullptr || res.shaderHeight != height || styleDirty_) {
+        OH_Drawing_Point* startPt = OH_Drawing_PointCreate(0, 0);
+        OH_Drawing_Point* endPt = OH_Drawing_PointCreate(0, height);
+        uint32_t colors[] = { style_.fillTopColor, style_.fillBottomColor };
+        float pos[] = { 0.0f, 1.0f};
+        OH_Drawing_ShaderEffect* shader = OH_Drawing_ShaderEffectCreateLinearGradient(startPt, endPt, colors, pos, 2, OH_Drawing_TileMode::CLAMP);
+        OH_Drawing_BrushSetShaderEffect(res.brush, shader);
+        OH_Drawing_PointDestroy(startPt);
+        OH_Drawing_PointDestroy(endPt);
+        if (res.shader != nullptr) OH_Drawing_ShaderEffectDestroy(res.shader);
+        res.shader = shader;
+        res.shaderHeight = height;
+    }
+    styleDirty_ = false;
+    return res.fillPath != nullptr && res.strokePath != nullptr && res.brush != nullptr &&
+        res.backgroundBrush != nullptr && res.pen != nullptr;
+}
+
+OH_Drawing_Canvas *WaveformRenderer::EnsureOffscreenCanvas(uint64_t width, uint64_t height) {
+    DrawingResources &res = resources_;
+    if (res.bitmap == nullptr || res.width != width || res.height != height) {
+        if (res.canvas != nullptr) OH_Drawing_CanvasDestroy(res.canvas);
+        if (res.bitmap != nullptr) OH_Drawing_BitmapDestroy(res.bitmap);
+        res.bitmap = OH_Drawing_BitmapCreate();
+        OH_Drawing_BitmapFormat format = { COLOR_FORMAT_RGBA_8888, ALPHA_FORMAT_PREMUL};
+        OH_Drawing_BitmapBuild(res.bitmap, width, height, &format);
+        res.canvas = OH_Drawing_CanvasCreate();
+        OH_Drawing_CanvasBind(res.canvas, res.bitmap);
+        res.width = width;
+        res.height = height;
+    }
+    return res.canvas;
+}
+
+void WaveformRenderer::ReleaseResources() {
+    DrawingResources &res = resources_;
+    if (res.canvas != nullptr) OH_Drawing_CanvasDestroy(res.canvas);
+    if (res.bitmap != nullptr) OH_Drawing_BitmapDestroy(res.bitmap);
+    if (res.fillPath != nullptr) OH_Drawing_PathDestroy(res.fillPath);
+    if (res.strokePath != nullptr) OH_Drawing_PathDestroy(res.strokePath);
+    if (res.brush != nullptr) OH_Drawing_BrushDestroy(res.brush);
+    if (res.backgroundBrush != nullptr) OH_Drawing_BrushDestroy(res.backgroundBrush);
+    if (res.pen != nullptr) OH_Drawing_PenDestroy(res.pen);
+    if (res.shader != nullptr) OH_Drawing_ShaderEffectDestroy(res.shader);
+    resources_ = DrawingResources();
+    ReleaseBufferTargets();
+    lastPresented_ = WaveformLayout();
+}
+
+static void DestroyBufferTarget(WaveformRenderer::BufferTarget &target) {
+    if (target.canvas != nullptr) OH_Drawing_CanvasDestroy(target.canvas);
+    if (target.bitmap != nullptr) OH_Drawing_BitmapDestroy(target.bitmap);
+    target = WaveformRenderer::BufferTarget();
+}
+
+WaveformRenderer::BufferTarget *WaveformRenderer::AcquireBufferTarget(const SurfaceFrame &frame) {
+    if (frame.pixels == nullptr || frame.width == 0 || frame.height == 0 ||
+        frame.stride < static_cast<int32_t>(frame.width * 4)) {
+        return nullptr;
+    }
+
+    for (auto it = bufferTargets_.begin(); it != bufferTargets_.end(); ++it) {
+        if (it->bufferId != frame.bufferId) continue;
+        // 同一个缓冲区但几何信息或像素地址变了，说明缓冲区已被重新分配，丢弃旧画布
+        bool sameBuffer = it->width == frame.width && it->height == frame.height && it->stride == frame.stride &&
+            it->pixels == frame.pixels;
+        if (sameBuffer) return &*it;
+        DestroyBufferTarget(*it);
+        bufferTargets_.erase(it);
+        break;
+    }
+
+    // 缓存超过上限时认为缓冲队列已整体轮换，全部释放后重建
+    if (bufferTargets_.size() >= MAX_BUFFER_TARGETS) {
+        ReleaseBufferTargets();
+    }
+
+    BufferTarget target;
+    target.bufferId = frame.bufferId;
+    target.pixels = frame.pixels;
+    target.stride = frame.stride;
+    target.width = frame.width;
+    target.height = frame.height;
+
+    // 直接以缓冲区作为位图的像素存储 (按缓冲区的 stride 寻址)，画布绘制即写屏，无需再拷贝
+    OH_Drawing_Image_Info info = { static_cast<int32_t>(frame.width), static_cast<int32_t>(frame.height),
+                                   COLOR_FORMAT_RGBA_8888, ALPHA_FORMAT_PREMUL };
+    target.bitmap = OH_Drawing_BitmapCreateFromPixels(&info, frame.pixels, static_cast<uint32_t>(frame.stride));
+    if (target.bitmap == nullptr) {
+        // 无法包装时走离屏拷贝的回退路径
+        return nullptr;
+    }
+    target.canvas = OH_Drawing_CanvasCreate();
+    OH_Drawing_CanvasBind(target.canvas, target.bitmap);
+    bufferTargets_.push_back(target);
+    return &bufferTargets_.back();
+}
+
+void WaveformRenderer::ReleaseBufferTargets() {
+    for (auto &target : bufferTargets_) {
+        DestroyBufferTarget(target);
+    }
+    bufferTargets_.clear();
+}
+
+WaveformLayout WaveformRenderer::PrepareFrame(const SampleHistory &history, int64_t windowUs, int64_t nowUs,
+                                              uint64_t width, uint64_t height, FramePoints *points) {
+    size_t capacity = history.Capacity();
+    if (frameSamples_.size() < capacity) {
+        frameSamples_.resize(capacity);
+        frameTimes_.resize(capacity);
+        frameValues_.resize(capacity);
+        frameColumns_.resize(capacity);
+        frameLows_.resize(capacity);
+        frameHighs_.resize(capacity);
+    }
+    uint64_t clearSeq = history.ClearSeq();
+    uint64_t endSeq = 0;
+    size_t count = history.Snapshot(frameSamples_.data(), &endSeq);
+
+    // 还原时间戳；晚于 nowUs 的样本 (取快照期间刚写入) 留到下一帧，endSeq 相应回退
+    size_t valid = 0;
+    while (valid < count) {
+        int64_t timeUs = SampleHistory::SampleTimeUs(frameSamples_[valid], nowUs);
+        if (timeUs > nowUs) break;
+        frameTimes_[valid] = timeUs;
+        frameValues_[valid] = frameSamples_[valid].value;
+        valid++;
+    }
+    endSeq -= count - valid;
+
+    // 同一像素列的样本聚合为 min/max，之后的路径构建与绘制只和宽度相关
+    int32_t columns = static_cast<int32_t>(width);
+    int64_t nowColumn = WaveformColumn(nowUs, columns, windowUs);
+    size_t pointCount = AggregateColumns(frameTimes_.data(), frameValues_.data(), valid, columns, windowUs,
+                                         nowColumn - (columns - 1), frameColumns_.data(), frameLows_.data(),
+                                         frameHighs_.data());
+    points->columns = frameColumns_.data();
+    points->lows = frameLows_.data();
+    points->highs = frameHighs_.data();
+
+    WaveformLayout layout = ComputeWaveformLayout(points->columns, points->lows, points->highs, pointCount, columns,
+        static_cast<int32_t>(height), windowUs, nowColumn, StrokeMargin(), contentGeneration_);
+    layout.endSeq = endSeq;
+    layout.clearSeq = clearSeq;
+
+    // 一次向量化变换得到所有点的像素纵坐标，填充和描边路径共用
+    if (frameHighYs_.size() < pointCount) {
+        frameHighYs_.resize(pointCount);
+        frameLowYs_.resize(pointCount);
+    }
+    ValuesToPixelY(points->highs, pointCount, layout.scale, layout.height, frameHighYs_.data());
+    ValuesToPixelY(points->lows, pointCount, layout.scale, layout.height, frameLowYs_.data());
+    points->highYs = frameHighYs_.data();
+    points->lowYs = frameLowYs_.data();
+    return layout;
+}
+
+// 两帧的像素完全相同
+static bool IsSameFrame(const WaveformLayout &a, const WaveformLayout &b) {
+    return a.valid && b.valid && a.endSeq == b.endSeq && a.clearSeq == b.clearSeq &&
+        a.originColumn == b.originColumn && a.width == b.width && a.height == b.height && a.windowUs == b.windowUs &&
+        a.generation == b.generation;
+}
+
+WaveformRenderer::FrameResult WaveformRenderer::RenderFrame(RenderSurface *surface, const SampleHistory &history,
+                                                            int64_t windowUs, int64_t nowUs) {
+    int64_t startUs = NowUs();
+    OH_HiTrace_StartTrace("NetGuardian::RenderFrame");
+    FrameResult result = RenderFrameStages(surface, history, windowUs, nowUs);
+    OH_HiTrace_FinishTrace();
+    int64_t elapsedUs = NowUs() - startUs;
+
+    switch (result) {
+        case FRAME_PRESENTED:
+            metrics_.framesPresented++;
+            metrics_.frame.Record(elapsedUs);
+            metrics_.frameTimes.Record(elapsedUs);
+            break;
+        case FRAME_SKIPPED:
+            metrics_.framesSkipped++;
+            OH_HiTrace_CountTrace("NetGuardian::FramesSkipped", static_cast<int64_t>(metrics_.framesSkipped));
+            break;
+        case FRAME_EMPTY_SURFACE:
+        case FRAME_UNCHANGED:
+            break;
+        default:
+            metrics_.framesFailed++;
+            OH_HiTrace_CountTrace("NetGuardian::FramesFailed", static_cast<int64_t>(metrics_.framesFailed));
+            break;
+    }
+    return result;
+}
+
+WaveformRenderer::FrameResult WaveformRenderer::RenderFrameStages(RenderSurface *surface,
+                                                                  const SampleHistory &history, int64_t windowUs,
+                                                                  int64_t nowUs) {
+    uint64_t width = surface->Width();
+    uint64_t height = surface->Height();
+    if (width == 0 || height == 0 || windowUs <= 0) {
+        return FRAME_EMPTY_SURFACE;
+    }
+
+    // 准备数据与本帧布局 (在出队之前完成，缩短占用缓冲区的时间)
+    FramePoints points;
+    WaveformLayout layout;
+    {
+        StageScope stage(&metrics_, RENDER_STAGE_PREPARE);
+        if (!EnsureDrawingResources(height)) {
+            return FRAME_NO_RESOURCES;
+        }
+        layout = PrepareFrame(history, windowUs, nowUs, width, height, &points);
+    }
+    if (IsSameFrame(lastPresented_, layout)) {
+        // 没有新样本，窗口也还没移过一列：屏幕上的画面已经是这一帧，不占用缓冲区
+        return FRAME_UNCHANGED;
+    }
+
+    SurfaceFrame frame;
+    RenderSurface::AcquireResult acquired;
+    {
+        StageScope stage(&metrics_, RENDER_STAGE_ACQUIRE);
+        acquired = surface->AcquireFrame(&frame);
+    }
+    if (acquired == RenderSurface::ACQUIRE_NOT_READY) {
+        // 跳帧：什么都没写，lastPresented_ 与各缓冲区的 drawn 保持不变，下一帧照常按增量计算
+        return FRAME_SKIPPED;
+    }
+    if (acquired != RenderSurface::ACQUIRE_OK) {
+        return FRAME_ACQUIRE_FAILED;
+    }
+    if (frame.width != width || frame.height != height) {
+        // 尺寸变化与出队之间的竞争：这块缓冲区按旧尺寸分配，放弃本帧，等下一帧按新尺寸绘制
+        surface->DiscardFrame(frame);
+        return FRAME_DRAW_FAILED;
+    }
+    if (frame.epoch != targetEpoch_) {
+        // 缓冲区被重新分配过，旧画布包装的内存已经失效
+        ReleaseBufferTargets();
+        targetEpoch_ = frame.epoch;
+    }
+
+    // 零拷贝路径：画布直接绑定在缓冲区上，能增量就只滚动 + 重画新条带
+    BufferTarget* target = AcquireBufferTarget(frame);
+    if (target != nullptr) {
+        if (DrawWaveformIncremental(target, layout, points)) {
+            metrics_.incrementalFrames++;
+        } else {
+            StageScope stage(&metrics_, RENDER_STAGE_DRAW);
+            DrawWaveform(target->canvas, layout, points);
+        }
+        target->drawn = layout;
+    } else if (!DrawWaveformWithCopy(frame, layout, points)) {
+        surface->DiscardFrame(frame);
+        return FRAME_DRAW_FAILED;
+    }
+
+    // 相对上一帧只变化了曲线所在的横带 (或右侧条带) 时，提交精确的脏区域，否则整屏
+    StageScope stage(&metrics_, RENDER_STAGE_PRESENT);
+    WaveformScrollPlan plan;
+    SurfaceDamage damage;
+    bool partial = PlanWaveformScroll(lastPresented_, layout, StrokeMargin(), &plan);
+    if (partial) {
+        damage.x = plan.damageX;
+        damage.y = plan.damageY;
+        damage.w = plan.damageW;
+        damage.h = plan.damageH;
+    }
+    lastPresented_ = layout;
+    surface->PresentFrame(frame, partial ? &damage : nullptr);
+    return FRAME_PRESENTED;
+}
+
+bool WaveformRenderer::DrawWaveformIncremental(BufferTarget *target, const WaveformLayout &layout,
+                                               const FramePoints &points) {
+    WaveformScrollPlan plan;
+    if (!PlanWaveformScroll(target->drawn, layout, StrokeMargin(), &plan)) {
+        return false;
+    }
+
+    // 只有曲线所在的横带需要平移：带外的行要么是背景，要么是只随 y 变化的渐变，左移后不变
+    if (plan.shiftPx > 0) {
+        StageScope stage(&metrics_, RENDER_STAGE_COPY);
+        size_t shiftBytes = static_cast<size_t>(plan.shiftPx) * 4;
+        size_t keepBytes = static_cast<size_t>(layout.width) * 4 - shiftBytes;
+        for (int32_t y = plan.bandTop; y < plan.bandBottom; y++) {
+            uint8_t* row = static_cast<uint8_t*>(target->pixels) + static_cast<size_t>(y) * target->stride;
+            memmove(row, row + shiftBytes, keepBytes);
+        }
+    }
+
+    // 重画右侧条带 (新线段 + 平移后右端残留的旧像素)
+    StageScope stage(&metrics_, RENDER_STAGE_DRAW);
+    OH_Drawing_Canvas* canvas = target->canvas;
+    OH_Drawing_Rect* clip = OH_Drawing_RectCreate(plan.stripX, plan.bandTop, layout.width, layout.height);
+    OH_Drawing_CanvasSave(canvas);
+    OH_Drawing_CanvasClipRect(canvas, clip, INTERSECT, false);
+    DrawWaveform(canvas, layout, points);
+    OH_Drawing_CanvasRestore(canvas);
+    OH_Drawing_RectDestroy(clip);
+    return true;
+}
+
+// 回退路径：无法把缓冲区包装成位图时，先画到离屏位图再拷贝到缓冲区
+bool WaveformRenderer::DrawWaveformWithCopy(const SurfaceFrame &frame, const WaveformLayout &layout,
+                                            const FramePoints &points) {
+    if (frame.pixels == nullptr || frame.stride < static_cast<int32_t>(frame.width * 4)) {
+        return false;
+    }
+    OH_Drawing_Canvas* canvas = EnsureOffscreenCanvas(frame.width, frame.height);
+    if (canvas == nullptr) {
+        return false;
+    }
+
+    {
+        StageScope stage(&metrics_, RENDER_STAGE_DRAW);
+        DrawWaveform(canvas, layout, points);
+    }
+
+    // 获取 Bitmap 绘制好的像素地址 (源地址)
+    void* bitmapPixels = OH_Drawing_BitmapGetPixels(resources_.bitmap);
+    if (bitmapPixels == nullptr) {
+        return false;
+    }
+
+    StageScope stage(&metrics_, RENDER_STAGE_COPY);
+    int32_t bufferStride = frame.stride; // 目标 stride
+    int32_t bitmapStride = frame.width * 4; // 源 stride (RGBA 4字节)
+    if(bufferStride == bitmapStride) {
+        // 如果 stride 一致，直接整块拷贝
+        memcpy(frame.pixels, bitmapPixels, frame.width * frame.height * 4);
+    }else {
+        // 如果 stride 不一致，必须逐行拷贝, 否则画面会歪斜或花屏
+        for(uint64_t i = 0; i < frame.height; i++){
+            uint8_t* srcRow = static_cast<uint8_t*>(bitmapPixels) + i * bitmapStride;
+            uint8_t* dstRow = static_cast<uint8_t*>(frame.pixels) + i * bufferStride;
+            memcpy(dstRow, srcRow, frame.width * 4); // 只拷贝有效数据
+        }
+    }
+    return true;
+}
+
+void WaveformRenderer::DrawWaveform(OH_Drawing_Canvas *canvas, const WaveformLayout &layout,
+                                    const FramePoints &points) {
+    // 铺背景 (用矩形而不是 Clear，保证局部重画时只覆盖裁剪区域)
+    OH_Drawing_Rect* bounds = OH_Drawing_RectCreate(0, 0, layout.width, layout.height);
+    OH_Drawing_CanvasAttachBrush(canvas, resources_.backgroundBrush);
+    OH_Drawing_CanvasDrawRect(canvas, bounds);
+    OH_Drawing_CanvasDetachBrush(canvas);
+    OH_Drawing_RectDestroy(bounds);
+
+    size_t count = layout.count;
+    if(count <= 1) {
+        return;
+    }
+
+    float firstX = layout.ColumnX(points.columns[0]);
+    float lastX = firstX;
+    float bottom = static_cast<float>(layout.height);
+
+    // 移动到第一个点正下方的起点 (闭合区域用于填充；第一个点可能在左边界外，也可能因历史不足而在屏幕中间)
+    OH_Drawing_Path* fillPath = resources_.fillPath;
+    OH_Drawing_PathReset(fillPath);
+    OH_Drawing_PathMoveTo(fillPath, firstX, bottom);
+
+    // 构建波形路径 (填充以每列的最大值为上沿)
+    // Y轴翻转：Canvas (0,0) 在左上角，数值越大越靠上 (Val = 0 -> y = height; Val = scale -> y = 0)
+    for(size_t i = 0; i < count; i++) {
+        float x = layout.ColumnX(points.columns[i]);
+        OH_Drawing_PathLineTo(fillPath, x, points.highYs[i]);
+        lastX = x;
+    }
+
+    // 闭合路径到最后一个点正下方
+    OH_Drawing_PathLineTo(fillPath, lastX, bottom);
+    // 回到起点闭合
+    OH_Drawing_PathLineTo(fillPath, firstX, bottom);
+    OH_Drawing_PathClose(fillPath);
+
+    // 绘制填充 (Brush + 渐变 Shader)
+    OH_Drawing_CanvasAttachBrush(canvas, resources_.brush);
+    OH_Drawing_CanvasDrawPath(canvas, fillPath);
+    OH_Drawing_CanvasDetachBrush(canvas);
+
+    // 描边：一列有多个样本时先到最大值再到最小值，画出完整的包络
+    OH_Drawing_Path* strokePath = resources_.strokePath;
+    OH_Drawing_PathReset(strokePath);
+    for (size_t i = 0; i < count; ++i) {
+        float x = layout.ColumnX(points.columns[i]);
+        float y = points.highYs[i];
+        if (i == 0) OH_Drawing_PathMoveTo(strokePath, x, y);
+        else OH_Drawing_PathLineTo(strokePath, x, y);
+        if (points.lows[i] != points.highs[i]) {
+            OH_Drawing_PathLineTo(strokePath, x, points.lowYs[i]);
+        }
+    }
+
+    // 绘制描边 (Pen)
+    OH_Drawing_CanvasAttachPen(canvas, resources_.pen);
+    OH_Drawing_CanvasDrawPath(canvas, strokePath);
+    OH_Drawing_CanvasDetachPen(canvas);
+}
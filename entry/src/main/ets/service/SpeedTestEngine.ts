@@ -1,6 +1,8 @@
-import { http } from '@kit.NetworkKit';
+import { systemDateTime } from '@kit.BasicServicesKit';
 import Logger from '../common/utils/Logger';
-import nativeGuardian, { TrafficStats } from 'libnet_guardian.so';
+import nativeGuardian, {
+  DownloadEngine, DownloadReport, TrafficStats, UploadEngine, UploadReport
+} from 'libnet_guardian.so';
 
 /**
  * 测速阶段枚举
@@ -43,14 +45,20 @@ export type SpeedCallback = (
 
 /**
  * 真实网络测速引擎
- * 原理：通过 HTTP GET 请求下载大文件，计算单位时间内的接收字节数
+ * 原理：通过 HTTP GET 请求下载大文件 / POST 上传正文，计算单位时间内收发的字节数
+ * 两个阶段都由原生引擎 (DownloadEngine / UploadEngine) 在自己的线程上收发，
+ * 数据不经过 ArkTS，只按固定间隔回传聚合统计
  * 策略：使用“时间窗口聚合”算法计算瞬时速度，避免 UI 抖动
  */
 export class SpeedTestEngine {
-  private httpRequest: http.HttpRequest | null = null;
+  private downloadEngine: DownloadEngine | null = null; // 下载阶段的原生引擎
+  private uploadEngine: UploadEngine | null = null; // 上传阶段的原生引擎
   private  isRunning: boolean = false;
 
-  private readonly UPLOAD_SIZE = 100 * 1024 * 1024;
+  private readonly UPLOAD_SIZE = 100 * 1024 * 1024; // 上传正文长度，原生引擎反复发送 64 KB 模板，不分配这么大的内存
+  private readonly PHASE_DURATION_MS = 8000; // 每个阶段的测量时长上限，速度收敛后提前结束
+  private readonly MIN_PHASE_DURATION_MS = 2000; // 判定收敛前至少测量的时长，稳定的链路 2 ~ 3 秒即可出结果
+  private readonly DOWNLOAD_STREAMS = 4; // 下载并行连接数，单条 TCP 流往往跑不满链路
 
   // 使用华为云测速源的 10MB - 100MB 文件
   // 备选：https://speed.cloudflare.com/__down?bytes=10000000
@@ -58,24 +66,9 @@ export class SpeedTestEngine {
   // tele2 的测速接口
   private readonly UP_URL = 'http://speedtest.tele2.net/upload.php';
 
-  // 状态变量
-  private totalBytesReceived: number = 0; // 总接收字节
-  private totalFileSize: number = 0; // 文件总大小
+  private startTime: number = 0; // 当前阶段的开始时刻 (单调时钟)，用于计算进度
 
-  // 统计相关变量
-  private samples: number[] = [];
-  private totalBytes: number = 0;
-  private startTime: number = 0;
-  private lastCalcTime: number = 0;
-  private cycleBytes: number = 0;
-  private lastTotalSent: number = 0;
-
-  // 临时保存下载结果，以便最终汇总
-  private downResult: number = 0;
-
-  // 瞬时速度计算相关变量
-  private cycleBytesReceived: number = 0; // 当前计算周期内累积的字节数
-  private readonly CALC_INTERVAL = 500; // 计算间隔，单位ms
+  private traceDir: string | null = null; // 流量轨迹记录目录，null 表示不记录 (默认)
 
   private onSpeedUpdate: SpeedCallback | null = null; // 回调函数引用
   private currentPhase: TestPhase = TestPhase.IDLE; // 当前正在进行的阶段 (用于门禁检查)
@@ -119,6 +112,15 @@ export class SpeedTestEngine {
     }
   }
 
+  /**
+   * 开启 / 关闭流量轨迹记录 (排查现场问题用)
+   * 开启后每个阶段把送入原生分析器的 (时间戳, 字节数) 写入 dir 下的一个 .ngtrace 文件，可用 trace_replay 离线回放
+   * @param dir 可写目录 (如 context.filesDir)，传 null 关闭
+   */
+  public setTraceDirectory(dir: string | null): void {
+    this.traceDir = dir;
+  }
+
   /**
    * 停止测速
    */
@@ -132,22 +134,17 @@ export class SpeedTestEngine {
   private cleanup() {
     this.isRunning = false;
     this.currentPhase = TestPhase.IDLE;
+    // 引擎随后以 'stopped' 兑现 Promise，会话已失效，结果被忽略
+    this.downloadEngine?.stop();
+    this.downloadEngine = null;
+    this.uploadEngine?.stop();
+    this.uploadEngine = null;
 
     // 清除僵尸定时器
     if (this.phaseTimer !== -1) {
       clearTimeout(this.phaseTimer);
       this.phaseTimer = -1;
     }
-
-    // 销毁请求
-    if (this.httpRequest) {
-      try {
-        this.httpRequest.off('dataReceive'); // 移除监听，防止幽灵回调
-        this.httpRequest.off('dataSendProgress');
-        this.httpRequest.destroy();
-      } catch (e) {}
-      this.httpRequest = null;
-    }
   }
 
   /**
@@ -163,9 +160,6 @@ export class SpeedTestEngine {
       }
 
       this.resetStats();
-      nativeGuardian.resetState();
-      this.lastTotalSent = 0;
-      this.httpRequest = http.createHttp();
 
       // 保存定时器 ID
       this.phaseTimer = setTimeout(() => {
@@ -173,119 +167,134 @@ export class SpeedTestEngine {
           Logger.info('SpeedEngine', 'Phase timeout, finishing...');
           this.finishPhase(resolve, sessionId);
         }
-      }, 8000);
+      }, this.PHASE_DURATION_MS);
 
       if (phase === TestPhase.DOWNLOAD) {
         this.setupDownload(phase, callback, resolve, sessionId);
       } else {
         this.setupUpload(phase, callback, resolve, sessionId);
       }
-
-      // 监听错误，防止卡死
-      this.httpRequest.on('headersReceive', () => {}); // 占位，防止报错
     });
   }
 
+  private traceFile(phaseName: string): string | undefined {
+    return this.traceDir === null ? undefined : `${this.traceDir}/${phaseName}_${Date.now()}.ngtrace`;
+  }
+
   private setupDownload(phase: TestPhase, callback: SpeedCallback, resolve: Function, sessionId: number) {
     const url = `${this.DOWN_URL}?nocache=${Date.now()}_${Math.random()}`;
-
-    // 订阅进度事件
-    this.httpRequest!.on('dataReceive', (data: ArrayBuffer) => {
-      if (!this.isRunning || this.currentSessionId !== sessionId || this.currentPhase !== TestPhase.DOWNLOAD) {
-        return; // 丢弃僵尸数据
-      }
-      try{
-        const stats = nativeGuardian.analyzeTraffic(data);
-
-        // stats 可能为空（第一个包），做个保护
-        if (stats && stats.instantKbps !== undefined) {
-          // 将 C++ 计算的总字节数同步回来
-          this.totalBytes = stats.totalBytes;
-          this.cycleBytes += data.byteLength;
-          this.notifyStats(phase, callback, stats);
-
-          // Logger.debug('Native', `Jitter: ${stats.jitter.toFixed(2)}, Avg: ${stats.avgKbps.toFixed(2)}`);
+    // 引擎自带分析器并驱动默认波形通道 (start 时清空波形)，统计经 onReport 周期性回传
+    const engine = new nativeGuardian.DownloadEngine(true);
+    this.downloadEngine = engine;
+
+    try {
+      engine.start({
+        url: url,
+        streams: this.DOWNLOAD_STREAMS,
+        durationMs: this.PHASE_DURATION_MS,
+        connectTimeoutMs: 10000,
+        stopWhenStable: true,
+        minDurationMs: this.MIN_PHASE_DURATION_MS,
+        tracePath: this.traceFile('download')
+      }, (report: DownloadReport) => {
+        if (!this.isRunning || this.currentSessionId !== sessionId || this.currentPhase !== TestPhase.DOWNLOAD) {
+          return; // 丢弃僵尸上报
         }
-      } catch (e) {
-        Logger.error('SpeedEngine', 'Native call failed', e);
-        // 降级处理：如果在非真机环境或 so 加载失败，回退到 JS 逻辑
-        this.recordData(data.byteLength);
-      }
-
-    });
-
-    this.httpRequest!.requestInStream(url, {
-      method: http.RequestMethod.GET,
-      connectTimeout: 100000,
-      readTimeout: 160000,
-      usingCache: false,
-      header: {
-        'Cache-Control': 'no-cache, no-store, must-revalidate'
-      }
-    }).then((code) => {
-      Logger.info('SpeedEngine', `Download finished naturaly: ${code}`);
-      // 如果文件下完了，时间还没到，也应该结束本阶段
-      if (this.currentSessionId === sessionId) {
-        Logger.info('SpeedEngine', `Download finished: ${code}`);
-        this.finishPhase(resolve, sessionId);
-      }
-    }).catch(e => {
-      Logger.error('SpeedEngine', 'Download error', e);
+        this.onEngineStats(report.stats, phase, callback);
+      }).then((result) => {
+        if (result.reason === 'failed') {
+          Logger.error('SpeedEngine', `Download error: ${result.error} (HTTP ${result.httpStatus})`);
+        } else {
+          Logger.info('SpeedEngine', `Download finished: ${result.reason}, ${result.bytes} bytes over ` +
+            `${result.streams.length} streams (fairness ${result.fairness.toFixed(2)}, ${result.stragglers} stragglers)`);
+          Logger.info('SpeedEngine', `Download ${this.describeTcp(result.stats)}`);
+        }
+        // 阶段可能已因超时结束并开始了下一阶段，只结束引擎仍属于本阶段的那次
+        if (this.currentSessionId === sessionId && this.downloadEngine === engine) {
+          this.onEngineStats(result.stats, phase, callback); // 最后一个上报周期之后的数据也送到 UI
+          this.finishPhase(resolve, sessionId);
+        }
+      });
+    } catch (e) {
+      Logger.error('SpeedEngine', 'Native download failed to start', e);
       this.finishPhase(resolve, sessionId);
-    });
+    }
   }
 
-  private setupUpload(phase: TestPhase, callback: SpeedCallback, resolve: Function, sessionId: number) {
-    // 生成一个 5MB 的垃圾数据用于上传
-    const dummyData = new ArrayBuffer(this.UPLOAD_SIZE);
-    if (!this.isRunning || this.currentSessionId !== sessionId) {
-      resolve();
-      return;
+  /**
+   * 阶段结束时的 TCP 指标摘要，用于区分拥塞 (RTT 上涨) 与丢包 (重传多)
+   */
+  private describeTcp(stats: TrafficStats): string {
+    const tcp = stats.tcp;
+    if (tcp === undefined) {
+      return 'no tcp metrics';
     }
+    const rttMs = Math.max(tcp.rttMs, tcp.rcvRttMs);
+    return `link ${tcp.condition}, rtt ${rttMs.toFixed(1)} ms (min ${tcp.minRttMs.toFixed(1)}), ` +
+      `retrans ${(tcp.retransmitRatio * 100).toFixed(2)}%, cwnd ${tcp.cwnd}`;
+  }
 
-    // 监听上传进度
-    const url = `${this.UP_URL}?nocache=${Date.now()}_${Math.random()}`;
-    this.httpRequest!.request(url, {
-      method: http.RequestMethod.POST,
-      extraData: dummyData, // 上传数据
-      connectTimeout: 100000,
-      readTimeout: 160000,
-      usingCache: false,
-      header: { 'Cache-Control': 'no-cache' }
-    }).then((code) => {
-      Logger.info('SpeedEngine', `UPload finished naturaly: ${code}`);
-      if (this.currentSessionId === sessionId) {
-        this.finishPhase(resolve, sessionId);
-      }
-    }).catch(e => {
-      Logger.error('SpeedEngine', 'Upload error', e);
-      this.finishPhase(resolve, sessionId);
-    });
+  /**
+   * 原生引擎的周期性上报：把聚合统计转给 UI
+   */
+  private onEngineStats(stats: TrafficStats, phase: TestPhase, callback: SpeedCallback) {
+    if (stats.totalBytes === undefined) {
+      return; // 还没有速度样本
+    }
+    const totalDuration = (SpeedTestEngine.nowMs() - this.startTime) / 1000;
+    const maxKbps = Math.floor(stats.maxKbps);
+    const minKbps = Math.floor(stats.minKbps);
+    const avgKbps = Math.floor(stats.avgKbps);
 
-    this.httpRequest!.on('dataSendProgress', (data) => {
-      if (!this.isRunning || this.currentSessionId !== sessionId || this.currentPhase !== TestPhase.UPLOAD) {
-        return;
+    callback(
+      Math.floor(stats.instantKbps), // 瞬时速度给波形图
+      Math.min(100, Math.floor(totalDuration / 8 * 100)),
+      phase,
+      {
+        max: maxKbps,
+        min: minKbps < avgKbps ? minKbps : avgKbps,
+        avg: avgKbps
       }
-      const currentTotal = data.sendSize;
-      const delta = currentTotal - this.lastTotalSent;
-      this.lastTotalSent = currentTotal;
-
-      if (delta > 0) {
-        try {
-          // 调用 analyzeLength 传入增量
-          const stats = nativeGuardian.analyzeLength(delta);
-
-          if (stats && stats.instantKbps !== undefined) {
-            // 同步总字节数
-            this.totalBytes = stats.totalBytes;
-            // 传递 stats 给 UI
-            this.notifyStats(phase, callback, stats);
-          }
-        } catch (e) {
-          Logger.error('SpeedEngine', 'Native analyzeLength failed', e);
+    );
+  }
+
+  private setupUpload(phase: TestPhase, callback: SpeedCallback, resolve: Function, sessionId: number) {
+    const url = `${this.UP_URL}?nocache=${Date.now()}_${Math.random()}`;
+    // 速度按对端已确认的字节计算，不会把填满本机发送缓冲区的突发算进去
+    const engine = new nativeGuardian.UploadEngine(true);
+    this.uploadEngine = engine;
+
+    try {
+      engine.start({
+        url: url,
+        totalBytes: this.UPLOAD_SIZE,
+        durationMs: this.PHASE_DURATION_MS,
+        connectTimeoutMs: 10000,
+        sendMode: 'sendfile',
+        stopWhenStable: true,
+        minDurationMs: this.MIN_PHASE_DURATION_MS,
+        tracePath: this.traceFile('upload')
+      }, (report: UploadReport) => {
+        if (!this.isRunning || this.currentSessionId !== sessionId || this.currentPhase !== TestPhase.UPLOAD) {
+          return; // 丢弃僵尸上报
         }
-      }
-    });
+        this.onEngineStats(report.stats, phase, callback);
+      }).then((result) => {
+        if (result.reason === 'failed') {
+          Logger.error('SpeedEngine', `Upload error: ${result.error} (HTTP ${result.httpStatus})`);
+        } else {
+          Logger.info('SpeedEngine', `Upload finished: ${result.reason}, ${result.ackedBytes} bytes acked, ` +
+            this.describeTcp(result.stats));
+        }
+        if (this.currentSessionId === sessionId && this.uploadEngine === engine) {
+          this.onEngineStats(result.stats, phase, callback); // 最后一个上报周期之后的数据也送到 UI
+          this.finishPhase(resolve, sessionId);
+        }
+      });
+    } catch (e) {
+      Logger.error('SpeedEngine', 'Native upload failed to start', e);
+      this.finishPhase(resolve, sessionId);
+    }
   }
 
   private finishPhase(resolve: Function, sessionId: number) {
@@ -300,45 +309,25 @@ export class SpeedTestEngine {
       this.phaseTimer = -1;
     }
 
-    if (this.httpRequest) {
-      this.httpRequest.destroy();
-      this.httpRequest = null;
-    }
+    // 超时先到时结束本阶段的引擎 (已结束时为空操作)，引擎结束时关闭轨迹文件
+    this.downloadEngine?.stop();
+    this.downloadEngine = null;
+    this.uploadEngine?.stop();
+    this.uploadEngine = null;
     resolve();
   }
 
   /**
-   * 重置状态
+   * 阶段计时用的单调时钟 (开机以来的毫秒数)，不受用户或网络校时修改系统时间的影响
    */
-  private resetStats(): void{
-    this.samples = [];
-    this.totalBytes = 0;
-    this.startTime = Date.now();
-    this.lastCalcTime = this.startTime;
-    this.cycleBytes = 0;
+  private static nowMs(): number {
+    return systemDateTime.getUptime(systemDateTime.TimeType.STARTUP);
   }
 
-  private recordData(byteLength: number) {
-    this.totalBytes += byteLength;
-    this.cycleBytes += byteLength;
-  }
-
-  private notifyStats(phase: TestPhase, callback: SpeedCallback, cppStats: TrafficStats) {
-    const now = Date.now();
-    const totalDuration = (now - this.startTime) / 1000;
-
-    callback(
-      Math.floor(cppStats.instantKbps), // 瞬时速度给波形图
-      Math.min(100, Math.floor(totalDuration / 8 * 100)),
-      phase,
-      {
-        max: Math.floor(cppStats.maxKbps),
-        min: Math.floor(cppStats.minKbps) < Math.floor(cppStats.avgKbps) ? Math.floor(cppStats.minKbps) : Math.floor(cppStats.avgKbps),
-        avg: Math.floor(cppStats.avgKbps)
-      }
-    );
-
-    // lastCalcTime 还是要更新，用于节流 callback 频率
-    this.lastCalcTime = now;
+  /**
+   * 重置状态
+   */
+  private resetStats(): void{
+    this.startTime = SpeedTestEngine.nowMs();
   }
 }
\ No newline at end of file